@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 199309L
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <time.h>
+
+// parses one large top-level array of records with
+// json_parse_array_from_buffer and json_parse_array_parallel_from_buffer
+// on 1, 2, 4, ... threads. times are wall clock, since CPU time adds up
+// over the threads.
+//
+// usage: bench_json_array_parallel [number of records (default 1000000)] [max threads (default 16)]
+
+static char*
+make_array(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"timestamp\": 1700000000, \"host\": \"web-1\", \"status\": 200, "
+    "\"latency_ms\": 12.5, \"tags\": [\"a\", \"b\"], \"cached\": false}";
+  const size_t record_len = strlen(record);
+
+  char* array = malloc(n_records * (record_len + 2) + 2);
+  if (!array)
+    return NULL;
+
+  size_t idx = 0;
+  array[idx++] = '[';
+  for (size_t i = 0; i < n_records; ++i)
+  {
+    if (i > 0)
+      array[idx++] = ',';
+    array[idx++] = '\n';
+    memcpy(&array[idx], record, record_len);
+    idx += record_len;
+  }
+  array[idx++] = ']';
+
+  *len = idx;
+  return array;
+}
+
+static double
+seconds()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 1000000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  size_t max_threads = 16;
+  if (argc > 2)
+    max_threads = strtoul(argv[2], NULL, 10);
+
+  size_t len = 0;
+  char* input = make_array(n_records, &len);
+  struct json_key_pool_t* key_pool = json_key_pool_create();
+  if (!input || !key_pool)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = NULL,
+    .key_pool = key_pool
+  };
+
+  printf("%zu records, %.2f MB:\n", n_records, (double)len / (1024.0 * 1024.0));
+
+  double start = seconds();
+  struct json_array_t* array = json_parse_array_from_buffer(input, len);
+  double end = seconds();
+  if (!array)
+  {
+    fprintf(stderr, "Failed to parse array.\n");
+    return -1;
+  }
+  json_array_free(&array);
+  printf("  serial              %6.3f s\n", end - start);
+
+  for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+  {
+    start = seconds();
+    array = json_parse_array_parallel_from_buffer(input, len, &options, n_threads);
+    end = seconds();
+    if (!array || array->n_items != n_records)
+    {
+      fprintf(stderr, "Failed to parse array.\n");
+      return -1;
+    }
+    json_array_free(&array);
+    printf("  %2zu threads          %6.3f s\n", n_threads, end - start);
+  }
+
+  json_key_pool_destroy(&key_pool);
+  free(input);
+  return 0;
+}
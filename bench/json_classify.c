@@ -0,0 +1,175 @@
+#include "json.h"
+#include "json_internal.h"
+#include <stdio.h>
+#include <time.h>
+
+// compares the token tables against the switch + ctype classifier they
+// replaced, classifying every byte of complex_file.json replicated to a
+// target size and then stepping the FSM over the tokens found.
+//
+// usage: json_classify [target size in MB (default 100)]
+
+static enum _token_e
+switch_token_type(
+  const char current_char)
+{
+  switch (current_char)
+  {
+    case '{': return OPEN_BODY;
+    case '}': return CLOSE_BODY;
+    case '\"': return QUOTE;
+    case ',': return COMMA;
+    case ':': return COLON;
+    case ' ': return SPACE;
+    case '[': return OPEN_ARRAY;
+    case ']': return CLOSE_ARRAY;
+  }
+
+  if (isdigit(current_char) || current_char == '.' || current_char == '-')
+    return NUMERIC;
+  if (isalpha(current_char) || ispunct(current_char)
+      || current_char == '\n' || current_char == '\t' || current_char == '\r')
+    return TEXT;
+  return UNKNOWN;
+}
+
+static uint16_t
+switch_next_tokens(
+  const enum _token_e token,
+  const enum json_type_e container_type,
+  const bool parsing_key)
+{
+  const uint16_t value_tokens = QUOTE | NUMERIC | TEXT | OPEN_BODY | OPEN_ARRAY;
+  switch (token)
+  {
+    case OPEN_BODY:
+      return QUOTE | CLOSE_BODY;
+    case OPEN_ARRAY:
+      return value_tokens | CLOSE_ARRAY;
+    case COLON:
+      return value_tokens;
+    case COMMA:
+      return container_type == JSON_OBJECT ? QUOTE : value_tokens;
+    case QUOTE:
+      if (parsing_key)
+        return COLON;
+      // fall through
+    case NUMERIC:
+    case TEXT:
+    case CLOSE_BODY:
+    case CLOSE_ARRAY:
+      if (container_type == JSON_OBJECT)
+        return COMMA | CLOSE_BODY;
+      if (container_type == JSON_ARRAY)
+        return COMMA | CLOSE_ARRAY;
+      return NONE;
+    default:
+      return NONE;
+  }
+}
+
+static char*
+replicate_file(
+  const char* const filepath,
+  const size_t target_len,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+
+  char* contents = malloc(target_len + size);
+  if (!contents || fread(contents, sizeof(char), size, file) < (size_t)size)
+  {
+    free(contents);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+
+  size_t idx = size;
+  while (idx + size <= target_len)
+  {
+    memcpy(&contents[idx], contents, size);
+    idx += size;
+  }
+
+  *len = idx;
+  return contents;
+}
+
+static void
+report(
+  const char* const name,
+  const clock_t start,
+  const clock_t end,
+  const size_t len,
+  const uint64_t checksum)
+{
+  double seconds = (double)(end - start) / CLOCKS_PER_SEC;
+  double mb = (double)len / (1024.0 * 1024.0);
+  printf("  %-22s  %8.3f s  %10.2f MB/s  (checksum %llu)\n",
+      name, seconds, mb / seconds, (unsigned long long)checksum);
+}
+
+int main(int argc, char** argv)
+{
+  size_t target_mb = 100;
+  if (argc > 1)
+    target_mb = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* input = replicate_file("complex_file.json", target_mb * 1024 * 1024, &len);
+  if (!input)
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  printf("classifying %.2f MB:\n", (double)len / (1024.0 * 1024.0));
+
+  // the checksums only keep the loops from being optimized away. they
+  // differ between runs because the old classifier called '\t', '\n'
+  // and '\r' TEXT, where the table calls them SPACE
+  uint64_t checksum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < len; ++i)
+    checksum += switch_token_type(input[i]);
+  report("switch + ctype", start, clock(), len, checksum);
+
+  checksum = 0;
+  start = clock();
+  for (size_t i = 0; i < len; ++i)
+    checksum += _json_token_class_masks[_json_token_classes[(unsigned char)input[i]]];
+  report("lookup table", start, clock(), len, checksum);
+
+  // step the FSM on every byte, alternating containers and key state so
+  // every row of the transition table is exercised
+  printf("token FSM over %.2f MB:\n", (double)len / (1024.0 * 1024.0));
+
+  checksum = 0;
+  start = clock();
+  for (size_t i = 0; i < len; ++i)
+  {
+    enum json_type_e container_type = (i & 1) ? JSON_OBJECT : JSON_ARRAY;
+    checksum += switch_next_tokens(switch_token_type(input[i]), container_type, (i & 2) != 0);
+  }
+  report("switch", start, clock(), len, checksum);
+
+  checksum = 0;
+  start = clock();
+  for (size_t i = 0; i < len; ++i)
+  {
+    enum json_type_e container_type = (i & 1) ? JSON_OBJECT : JSON_ARRAY;
+    uint8_t token_class = _json_token_classes[(unsigned char)input[i]];
+    checksum += _json_token_transitions[token_class][container_type][(i & 2) != 0];
+  }
+  report("transition table", start, clock(), len, checksum);
+
+  free(input);
+  return 0;
+}
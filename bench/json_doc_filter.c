@@ -0,0 +1,108 @@
+#include "json.h"
+#include "json_doc.h"
+#include <stdio.h>
+#include <time.h>
+
+// a filter worker's access pattern: read 3 keys out of each event and
+// throw the rest away. compares building the whole tree with
+// json_parse_from_buffer against an on-demand json_doc_t.
+//
+// each event wraps complex_file.json (~90 KB) in an object.
+//
+// usage: json_doc_filter [number of events (default 1000)]
+
+static char*
+make_event(
+  const char* const filepath,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+
+  const char* const prefix = "{\"id\": 12345, \"type\": \"click\", \"payload\": ";
+  const char* const suffix = ", \"user\": \"someone\"}";
+  const size_t prefix_len = strlen(prefix);
+  const size_t suffix_len = strlen(suffix);
+
+  char* event = malloc(prefix_len + size + suffix_len);
+  if (!event || fread(&event[prefix_len], sizeof(char), size, file) < (size_t)size)
+  {
+    free(event);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+
+  memcpy(event, prefix, prefix_len);
+  memcpy(&event[prefix_len + size], suffix, suffix_len);
+  *len = prefix_len + size + suffix_len;
+  return event;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_events = 1000;
+  if (argc > 1)
+    n_events = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* event = make_event("complex_file.json", &len);
+  if (!event)
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  // the sums keep the reads from being optimized away
+  size_t tree_sum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < n_events; ++i)
+  {
+    struct json_t* json = json_parse_from_buffer(event, len);
+    if (!json)
+      return -1;
+    tree_sum += *json_get_int32(json, "id");
+    tree_sum += strlen(json_get_string(json, "type"));
+    tree_sum += strlen(json_get_string(json, "user"));
+    json_free(&json);
+  }
+  clock_t end = clock();
+  double tree_seconds = (double)(end - start) / CLOCKS_PER_SEC;
+
+  size_t doc_sum = 0;
+  start = clock();
+  for (size_t i = 0; i < n_events; ++i)
+  {
+    struct json_doc_t* doc = json_doc_open(event, len, JSON_PARSE_DEFAULT);
+    if (!doc)
+      return -1;
+
+    struct json_cursor_t root = json_doc_root(doc);
+    struct json_cursor_t value;
+    int32_t id = 0;
+    const char* str = NULL;
+    size_t str_len = 0;
+    if (json_cursor_find(&root, "id", &value) && json_cursor_get_int32(&value, &id))
+      doc_sum += id;
+    if (json_cursor_find(&root, "type", &value) && json_cursor_get_string(&value, &str, &str_len))
+      doc_sum += str_len;
+    if (json_cursor_find(&root, "user", &value) && json_cursor_get_string(&value, &str, &str_len))
+      doc_sum += str_len;
+    json_doc_close(&doc);
+  }
+  end = clock();
+  double doc_seconds = (double)(end - start) / CLOCKS_PER_SEC;
+
+  double mb = (double)(len * n_events) / (1024.0 * 1024.0);
+  printf("%zu events of %zu bytes, reading 3 keys from each:\n", n_events, len);
+  printf("  json_parse_from_buffer  %8.3f s  %10.2f MB/s  (sum %zu)\n", tree_seconds, mb / tree_seconds, tree_sum);
+  printf("  json_doc_open           %8.3f s  %10.2f MB/s  (sum %zu)\n", doc_seconds, mb / doc_seconds, doc_sum);
+
+  free(event);
+  return 0;
+}
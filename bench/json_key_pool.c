@@ -0,0 +1,118 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <time.h>
+
+// an array of records that all have the same 12 field names, parsed
+// with keys copied into every object and with a shared key pool, then
+// every field of every record looked up once.
+//
+// the first run leaves the heap fragmented for the second, so for
+// comparable numbers run each mode in its own process.
+//
+// usage: bench_json_key_pool [number of records (default 1000000)] [copy|pool|both (default)]
+
+static const char* const field_names[] = {
+  "timestamp", "host", "service", "region", "status", "latency_ms",
+  "bytes_in", "bytes_out", "user_agent", "request_id", "method", "path"
+};
+#define N_FIELDS (sizeof(field_names) / sizeof(field_names[0]))
+
+static char*
+make_records(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"timestamp\": 1700000000, \"host\": \"web-1\", \"service\": \"api\", "
+    "\"region\": \"eu\", \"status\": 200, \"latency_ms\": 12.5, \"bytes_in\": 512, "
+    "\"bytes_out\": 2048, \"user_agent\": \"curl\", \"request_id\": 42, "
+    "\"method\": \"GET\", \"path\": \"/\"}";
+  const size_t record_len = strlen(record);
+
+  char* records = malloc(n_records * (record_len + 1) + 2);
+  if (!records)
+    return NULL;
+
+  size_t idx = 0;
+  records[idx++] = '[';
+  for (size_t i = 0; i < n_records; ++i)
+  {
+    if (i > 0)
+      records[idx++] = ',';
+    memcpy(&records[idx], record, record_len);
+    idx += record_len;
+  }
+  records[idx++] = ']';
+
+  *len = idx;
+  return records;
+}
+
+static size_t
+lookup_all(
+  const struct json_array_t* const array)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < array->n_items; ++i)
+  {
+    const struct json_t* record = json_array_get_object(array, i);
+    for (size_t f = 0; f < N_FIELDS; ++f)
+      found += json_get(record, field_names[f]) != NULL;
+  }
+  return found;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 1000000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  const char* const mode = argc > 2 ? argv[2] : "both";
+
+  size_t len = 0;
+  char* records = make_records(n_records, &len);
+  struct json_key_pool_t* pool = json_key_pool_create();
+  if (!records || !pool)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  printf("%zu records, %.2f MB:\n", n_records, (double)len / (1024.0 * 1024.0));
+  for (int pooled = 0; pooled < 2; ++pooled)
+  {
+    if (strcmp(mode, pooled ? "copy" : "pool") == 0)
+      continue;
+    clock_t start = clock();
+    const struct json_parse_options_t options = {
+      .flags = JSON_PARSE_DEFAULT,
+      .arena = NULL,
+      .key_pool = pooled ? pool : NULL
+    };
+    struct json_array_t* array = json_parse_array_with_options(records, len, &options);
+    clock_t parsed = clock();
+    if (!array)
+    {
+      fprintf(stderr, "Failed to parse records.\n");
+      return -1;
+    }
+    size_t found = lookup_all(array);
+    clock_t looked_up = clock();
+    json_array_free(&array);
+    clock_t freed = clock();
+
+    printf("  %-9s parse %6.3f s  lookups %6.3f s  free %6.3f s  (%zu found)\n",
+      pooled ? "key pool" : "copied",
+      (double)(parsed - start) / CLOCKS_PER_SEC,
+      (double)(looked_up - parsed) / CLOCKS_PER_SEC,
+      (double)(freed - looked_up) / CLOCKS_PER_SEC,
+      found);
+  }
+  printf("  %zu distinct keys in the pool\n", json_key_pool_size(pool));
+
+  json_key_pool_destroy(&pool);
+  free(records);
+  return 0;
+}
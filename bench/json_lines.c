@@ -0,0 +1,78 @@
+#include "json.h"
+#include "json_lines.h"
+#include <stdio.h>
+#include <time.h>
+
+// reads newline-delimited records by copying each line and parsing it
+// onto the heap, then with json_lines_reader_t.
+//
+// usage: bench_json_lines [number of records (default 1000000)]
+
+static char*
+make_lines(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"timestamp\": 1700000000, \"host\": \"web-1\", \"status\": 200, "
+    "\"latency_ms\": 12.5, \"tags\": [\"a\", \"b\"], \"cached\": false}\n";
+  const size_t record_len = strlen(record);
+
+  char* lines = malloc(n_records * record_len);
+  if (!lines)
+    return NULL;
+
+  for (size_t i = 0; i < n_records; ++i)
+    memcpy(&lines[i * record_len], record, record_len);
+
+  *len = n_records * record_len;
+  return lines;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 1000000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* lines = make_lines(n_records, &len);
+  if (!lines)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  printf("%zu records, %.2f MB:\n", n_records, (double)len / (1024.0 * 1024.0));
+
+  clock_t start = clock();
+  size_t n_parsed = 0;
+  for (size_t idx = 0; idx < len;)
+  {
+    const char* newline = memchr(&lines[idx], '\n', len - idx);
+    size_t end = newline ? (size_t)(newline - lines) : len;
+    char* line = malloc(end - idx + 1);
+    memcpy(line, &lines[idx], end - idx);
+    line[end - idx] = '\0';
+
+    struct json_t* json = json_parse_from_string(line);
+    n_parsed += json != NULL;
+    json_free(&json);
+    free(line);
+    idx = end + 1;
+  }
+  clock_t end = clock();
+  printf("  copy + parse  %6.3f s  (%zu records)\n", (double)(end - start) / CLOCKS_PER_SEC, n_parsed);
+
+  start = clock();
+  n_parsed = 0;
+  struct json_lines_reader_t* reader = json_lines_reader_open(lines, len, JSON_PARSE_DEFAULT);
+  while (json_lines_reader_next(reader))
+    n_parsed++;
+  json_lines_reader_close(&reader);
+  end = clock();
+  printf("  lines reader  %6.3f s  (%zu records)\n", (double)(end - start) / CLOCKS_PER_SEC, n_parsed);
+
+  free(lines);
+  return 0;
+}
@@ -0,0 +1,96 @@
+#define _POSIX_C_SOURCE 199309L
+#include "json.h"
+#include "json_lines.h"
+#include <stdio.h>
+#include <time.h>
+
+// parses newline-delimited records with json_lines_parse_parallel on
+// 1, 2, 4, ... threads, in order and as completed. times are wall
+// clock, since CPU time adds up over the threads.
+//
+// usage: bench_json_lines_parallel [number of records (default 2000000)] [max threads (default 16)]
+
+static char*
+make_lines(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"timestamp\": 1700000000, \"host\": \"web-1\", \"status\": 200, "
+    "\"latency_ms\": 12.5, \"tags\": [\"a\", \"b\"], \"cached\": false}\n";
+  const size_t record_len = strlen(record);
+
+  char* lines = malloc(n_records * record_len);
+  if (!lines)
+    return NULL;
+
+  for (size_t i = 0; i < n_records; ++i)
+    memcpy(&lines[i * record_len], record, record_len);
+
+  *len = n_records * record_len;
+  return lines;
+}
+
+static bool
+on_record(
+  struct json_t* record,
+  const size_t offset,
+  void* ctx)
+{
+  (void)offset;
+  (void)ctx;
+  return json_get_int32(record, "status") != NULL;
+}
+
+static double
+seconds()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 2000000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  size_t max_threads = 16;
+  if (argc > 2)
+    max_threads = strtoul(argv[2], NULL, 10);
+
+  size_t len = 0;
+  char* lines = make_lines(n_records, &len);
+  if (!lines)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  printf("%zu records, %.2f MB:\n", n_records, (double)len / (1024.0 * 1024.0));
+  for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+  {
+    for (int ordered = 0; ordered < 2; ++ordered)
+    {
+      struct json_lines_parallel_options_t options = {
+        .n_threads = n_threads,
+        .chunk_size = 0,
+        .ordered = ordered,
+        .flags = JSON_PARSE_DEFAULT
+      };
+
+      double start = seconds();
+      if (!json_lines_parse_parallel(lines, len, &options, on_record, NULL, NULL))
+      {
+        fprintf(stderr, "Failed to parse records.\n");
+        return -1;
+      }
+      double end = seconds();
+      printf("  %2zu threads %-9s %6.3f s\n", n_threads, ordered ? "ordered" : "unordered", end - start);
+    }
+  }
+
+  free(lines);
+  return 0;
+}
@@ -0,0 +1,226 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <time.h>
+
+// parses documents of doubling size and checks that throughput stays
+// roughly flat, i.e., that parse time grows linearly with input size.
+//
+// usage: json_parse_scaling [target size in MB (default 100)]
+
+#define N_STEPS 4
+
+// anything slower than this fraction of the smallest run's throughput
+// is treated as non-linear scaling
+#define MIN_THROUGHPUT_RATIO 0.5
+
+static char*
+read_file(
+  const char* const filepath,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+
+  char* contents = malloc(size + 1);
+  if (!contents || fread(contents, sizeof(char), size, file) < (size_t)size)
+  {
+    free(contents);
+    fclose(file);
+    return NULL;
+  }
+
+  contents[size] = '\0';
+  *len = size;
+  fclose(file);
+  return contents;
+}
+
+// joins copies of the elements inside an array string into one
+// array of roughly target_len bytes
+static char*
+replicate_array(
+  const char* const array_string,
+  const size_t array_len,
+  const size_t target_len,
+  size_t* len)
+{
+  const char* open = memchr(array_string, '[', array_len);
+  const char* close = NULL;
+  for (size_t i = array_len; i > 0; --i)
+    if (array_string[i - 1] == ']')
+    {
+      close = &array_string[i - 1];
+      break;
+    }
+
+  if (!open || !close || close <= open)
+    return NULL;
+
+  const char* elements = open + 1;
+  size_t elements_len = close - elements;
+  size_t n_copies = target_len / (elements_len + 1) + 1;
+
+  char* replicated = malloc(n_copies * (elements_len + 1) + 2);
+  if (!replicated)
+    return NULL;
+
+  size_t idx = 0;
+  replicated[idx++] = '[';
+  for (size_t i = 0; i < n_copies; ++i)
+  {
+    if (i > 0)
+      replicated[idx++] = ',';
+    memcpy(&replicated[idx], elements, elements_len);
+    idx += elements_len;
+  }
+  replicated[idx++] = ']';
+  replicated[idx] = '\0';
+
+  *len = idx;
+  return replicated;
+}
+
+static char*
+numeric_array(
+  const size_t n_items,
+  const bool decimals,
+  size_t* len)
+{
+  // at most 24 characters per item plus a comma
+  char* array_string = malloc(n_items * 25 + 3);
+  if (!array_string)
+    return NULL;
+
+  size_t idx = 0;
+  array_string[idx++] = '[';
+  for (size_t i = 0; i < n_items; ++i)
+  {
+    if (i > 0)
+      array_string[idx++] = ',';
+    if (decimals)
+      idx += sprintf(&array_string[idx], "%.17g", (double)i / 7.0 + 0.5);
+    else
+      idx += sprintf(&array_string[idx], "%zu", i * 7919 % 1000003);
+  }
+  array_string[idx++] = ']';
+  array_string[idx] = '\0';
+
+  *len = idx;
+  return array_string;
+}
+
+// returns throughput in MB/s or a negative value on failure
+static double
+time_parse(
+  const char* const array_string,
+  const size_t len)
+{
+  clock_t start = clock();
+  struct json_array_t* array = json_parse_array_from_string(array_string);
+  clock_t end = clock();
+
+  if (!array)
+    return -1.0;
+  json_array_free(&array);
+
+  double seconds = (double)(end - start) / CLOCKS_PER_SEC;
+  double mb = (double)len / (1024.0 * 1024.0);
+  printf("  %10.2f MB  %8.3f s  %10.2f MB/s\n", mb, seconds, mb / seconds);
+  return mb / seconds;
+}
+
+static bool
+check_scaling(
+  const double* const throughputs)
+{
+  for (size_t i = 0; i < N_STEPS; ++i)
+    if (throughputs[i] < 0.0)
+    {
+      fprintf(stderr, "Failed to parse benchmark input.\n");
+      return false;
+    }
+
+  double ratio = throughputs[N_STEPS - 1] / throughputs[0];
+  printf("  largest/smallest throughput ratio: %.2f\n", ratio);
+  if (ratio < MIN_THROUGHPUT_RATIO)
+  {
+    fprintf(stderr, "Parse time is growing faster than input size.\n");
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  size_t target_mb = 100;
+  if (argc > 1)
+    target_mb = strtoul(argv[1], NULL, 10);
+
+  int status = -1;
+  size_t complex_len = 0;
+  char* complex_string = read_file("complex_file.json", &complex_len);
+  if (!complex_string)
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  double throughputs[N_STEPS] = {0};
+
+  printf("complex_file.json replicated up to %zu MB:\n", target_mb);
+  for (size_t i = 0; i < N_STEPS; ++i)
+  {
+    size_t target_len = (target_mb * 1024 * 1024) >> (N_STEPS - 1 - i);
+    size_t len = 0;
+    char* array_string = replicate_array(complex_string, complex_len, target_len, &len);
+    if (!array_string)
+      goto cleanup;
+    throughputs[i] = time_parse(array_string, len);
+    free(array_string);
+  }
+
+  if (!check_scaling(throughputs))
+    goto cleanup;
+
+  printf("numeric array up to 1M items:\n");
+  for (size_t i = 0; i < N_STEPS; ++i)
+  {
+    size_t n_items = 1000000 >> (N_STEPS - 1 - i);
+    size_t len = 0;
+    char* array_string = numeric_array(n_items, false, &len);
+    if (!array_string)
+      goto cleanup;
+    throughputs[i] = time_parse(array_string, len);
+    free(array_string);
+  }
+
+  if (!check_scaling(throughputs))
+    goto cleanup;
+
+  printf("decimal array up to 1M items:\n");
+  for (size_t i = 0; i < N_STEPS; ++i)
+  {
+    size_t n_items = 1000000 >> (N_STEPS - 1 - i);
+    size_t len = 0;
+    char* array_string = numeric_array(n_items, true, &len);
+    if (!array_string)
+      goto cleanup;
+    throughputs[i] = time_parse(array_string, len);
+    free(array_string);
+  }
+
+  if (!check_scaling(throughputs))
+    goto cleanup;
+
+  status = 0;
+cleanup:
+  free(complex_string);
+  return status;
+}
@@ -0,0 +1,95 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_parser.h"
+#include <stdio.h>
+#include <time.h>
+
+// an array of small records parsed in one go from a buffer and fed to
+// the push parser in chunks of a few sizes, as a socket reader would.
+//
+// usage: bench_json_push_parser [number of records (default 500000)]
+
+static char*
+make_records(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"id\": 42, \"name\": \"a record with a longer string value\", "
+    "\"score\": 12.5, \"tags\": [\"x\", \"y\"], \"active\": true}";
+  const size_t record_len = strlen(record);
+
+  char* records = malloc(n_records * (record_len + 1) + 2);
+  if (!records)
+    return NULL;
+
+  size_t idx = 0;
+  records[idx++] = '[';
+  for (size_t i = 0; i < n_records; ++i)
+  {
+    if (i > 0)
+      records[idx++] = ',';
+    memcpy(&records[idx], record, record_len);
+    idx += record_len;
+  }
+  records[idx++] = ']';
+
+  *len = idx;
+  return records;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 500000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* records = make_records(n_records, &len);
+  if (!records)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  printf("%zu records, %.2f MB:\n", n_records, (double)len / (1024.0 * 1024.0));
+
+  clock_t start = clock();
+  struct json_array_t* array = json_parse_array_from_buffer(records, len);
+  clock_t end = clock();
+  if (!array)
+  {
+    fprintf(stderr, "Failed to parse records.\n");
+    return -1;
+  }
+  printf("  whole buffer       %6.3f s\n", (double)(end - start) / CLOCKS_PER_SEC);
+  json_array_free(&array);
+
+  const size_t chunk_sizes[] = { 64, 1500, 16384, 1 << 20 };
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i)
+  {
+    start = clock();
+    struct json_parser_t* parser = json_parser_new();
+    bool success = parser != NULL;
+    for (size_t idx = 0; success && idx < len; idx += chunk_sizes[i])
+    {
+      size_t n = len - idx < chunk_sizes[i] ? len - idx : chunk_sizes[i];
+      success = json_parser_feed(parser, &records[idx], n);
+    }
+    success = success && json_parser_finish(parser);
+    array = json_parser_take_array(parser);
+    end = clock();
+    json_parser_free(&parser);
+
+    if (!success || !array || array->n_items != n_records)
+    {
+      fprintf(stderr, "Failed to push parse records in chunks of %zu.\n", chunk_sizes[i]);
+      return -1;
+    }
+    printf("  %7zu byte chunks %6.3f s\n", chunk_sizes[i], (double)(end - start) / CLOCKS_PER_SEC);
+    json_array_free(&array);
+  }
+
+  free(records);
+  return 0;
+}
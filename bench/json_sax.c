@@ -0,0 +1,126 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_sax.h"
+#include <stdio.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// sums one field over an array of records, once by parsing it into a
+// tree and once with SAX callbacks. peak memory is per process, so run
+// each mode on its own to compare it.
+//
+// usage: bench_json_sax [number of records (default 1000000)] [tree|sax|both (default)]
+
+static char*
+make_records(
+  const size_t n_records,
+  size_t* len)
+{
+  const char* const record =
+    "{\"timestamp\": 1700000000, \"host\": \"web-1\", \"status\": 200, "
+    "\"latency_ms\": 12.5, \"tags\": [\"a\", \"b\"], \"cached\": false}";
+  const size_t record_len = strlen(record);
+
+  char* records = malloc(n_records * (record_len + 1) + 2);
+  if (!records)
+    return NULL;
+
+  size_t idx = 0;
+  records[idx++] = '[';
+  for (size_t i = 0; i < n_records; ++i)
+  {
+    if (i > 0)
+      records[idx++] = ',';
+    memcpy(&records[idx], record, record_len);
+    idx += record_len;
+  }
+  records[idx++] = ']';
+
+  *len = idx;
+  return records;
+}
+
+struct latency_sum
+{
+  bool next_is_latency;
+  double sum;
+};
+
+static bool
+on_key(void* user_data, const char* key, size_t len)
+{
+  struct latency_sum* latency = user_data;
+  latency->next_is_latency = len == 10 && memcmp(key, "latency_ms", 10) == 0;
+  return true;
+}
+
+static bool
+on_decimal(void* user_data, double value)
+{
+  struct latency_sum* latency = user_data;
+  if (latency->next_is_latency)
+    latency->sum += value;
+  return true;
+}
+
+static long
+peak_rss_mb()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024;
+}
+
+int main(int argc, char** argv)
+{
+  size_t n_records = 1000000;
+  if (argc > 1)
+    n_records = strtoul(argv[1], NULL, 10);
+
+  const char* const mode = argc > 2 ? argv[2] : "both";
+
+  size_t len = 0;
+  char* records = make_records(n_records, &len);
+  if (!records)
+  {
+    fprintf(stderr, "Failed to set up benchmark.\n");
+    return -1;
+  }
+
+  printf("%zu records, %.2f MB (peak RSS %ld MB before parsing):\n", n_records, (double)len / (1024.0 * 1024.0), peak_rss_mb());
+
+  if (strcmp(mode, "sax") != 0)
+  {
+    clock_t start = clock();
+    struct json_array_t* array = json_parse_array_from_buffer(records, len);
+    if (!array)
+    {
+      fprintf(stderr, "Failed to parse records.\n");
+      return -1;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < array->n_items; ++i)
+      sum += *json_get_decimal(json_array_get_object(array, i), "latency_ms");
+    clock_t end = clock();
+    long peak = peak_rss_mb();
+    json_array_free(&array);
+    printf("  tree %6.3f s  peak RSS %5ld MB  (sum %.1f)\n", (double)(end - start) / CLOCKS_PER_SEC, peak, sum);
+  }
+
+  if (strcmp(mode, "tree") != 0)
+  {
+    struct json_sax_handler_t handler = { .key = on_key, .decimal = on_decimal };
+    struct latency_sum latency = {0};
+    clock_t start = clock();
+    if (!json_sax_parse_from_buffer(records, len, JSON_PARSE_DEFAULT, &handler, &latency))
+    {
+      fprintf(stderr, "Failed to parse records.\n");
+      return -1;
+    }
+    clock_t end = clock();
+    printf("  sax  %6.3f s  peak RSS %5ld MB  (sum %.1f)\n", (double)(end - start) / CLOCKS_PER_SEC, peak_rss_mb(), latency.sum);
+  }
+
+  free(records);
+  return 0;
+}
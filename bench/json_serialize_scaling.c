@@ -0,0 +1,206 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <time.h>
+
+// serializes arrays of doubling size and checks that throughput stays
+// roughly flat, i.e., that json_array_to_string time grows linearly with
+// output size.
+//
+// usage: json_serialize_scaling [target output size in MB (default 500)]
+
+#define N_STEPS 4
+
+// anything slower than this fraction of the smallest run's throughput
+// is treated as non-linear scaling
+#define MIN_THROUGHPUT_RATIO 0.5
+
+// length of the string value in each record, most of the output comes
+// from these so the tree stays small relative to the output
+#define PAYLOAD_LEN 1000
+
+static struct json_t*
+create_record(
+  const size_t idx)
+{
+  struct json_t* record = json_create();
+  struct json_array_t* tags = json_array_create();
+  char* payload = malloc(PAYLOAD_LEN + 1);
+  if (!record || !tags || !payload)
+    goto failure;
+
+  for (size_t i = 0; i < PAYLOAD_LEN; ++i)
+    payload[i] = 'a' + (idx + i) % 26;
+  payload[PAYLOAD_LEN] = '\0';
+
+  for (int32_t i = 0; i < 3; ++i)
+    if (!json_array_append_int32(tags, i))
+      goto failure;
+
+  if (!json_add_int32(record, "id", (int32_t)idx)
+      || !json_add_decimal(record, "score", idx * 0.25)
+      || !json_add_bool(record, "active", idx % 2 == 0)
+      || !json_add_null(record, "note"))
+    goto failure;
+
+  if (!json_add_string(record, "payload", payload))
+    goto failure;
+  payload = NULL;
+
+  if (!json_add_array(record, "tags", tags))
+    goto failure;
+
+  return record;
+
+failure:
+  free(payload);
+  json_array_free(&tags);
+  json_free(&record);
+  return NULL;
+}
+
+static struct json_array_t*
+create_records(
+  const size_t n_records)
+{
+  struct json_array_t* array = json_array_create();
+  if (!array)
+    return NULL;
+
+  for (size_t i = 0; i < n_records; ++i)
+  {
+    struct json_t* record = create_record(i);
+    if (!record || !json_array_append_object(array, record))
+    {
+      json_free(&record);
+      json_array_free(&array);
+      return NULL;
+    }
+  }
+
+  return array;
+}
+
+static struct json_array_t*
+create_numbers(
+  const size_t n_items)
+{
+  struct json_array_t* array = json_array_create();
+  if (!array)
+    return NULL;
+
+  // alternate ints and decimals, like a metrics dump
+  for (size_t i = 0; i < n_items; ++i)
+  {
+    bool success = i % 2 == 0
+      ? json_array_append_int32(array, (int32_t)(i * 7919 % 1000003))
+      : json_array_append_decimal(array, (double)i / 7.0);
+    if (!success)
+    {
+      json_array_free(&array);
+      return NULL;
+    }
+  }
+
+  return array;
+}
+
+// returns throughput in MB/s or a negative value on failure
+static double
+time_serialize(
+  const struct json_array_t* const array)
+{
+  clock_t start = clock();
+  char* array_string = json_array_to_string(array);
+  clock_t end = clock();
+
+  if (!array_string)
+    return -1.0;
+  size_t len = strlen(array_string);
+  free(array_string);
+
+  double seconds = (double)(end - start) / CLOCKS_PER_SEC;
+  double mb = (double)len / (1024.0 * 1024.0);
+  printf("  %10.2f MB  %8.3f s  %10.2f MB/s\n", mb, seconds, mb / seconds);
+  return mb / seconds;
+}
+
+static bool
+check_scaling(
+  const double* const throughputs)
+{
+  for (size_t i = 0; i < N_STEPS; ++i)
+    if (throughputs[i] < 0.0)
+    {
+      fprintf(stderr, "Failed to serialize benchmark input.\n");
+      return false;
+    }
+
+  double ratio = throughputs[N_STEPS - 1] / throughputs[0];
+  printf("  largest/smallest throughput ratio: %.2f\n", ratio);
+  if (ratio < MIN_THROUGHPUT_RATIO)
+  {
+    fprintf(stderr, "Serialization time is growing faster than output size.\n");
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  size_t target_mb = 500;
+  if (argc > 1)
+    target_mb = strtoul(argv[1], NULL, 10);
+
+  // size a single record's output to work out how many are needed
+  struct json_t* sample = create_record(0);
+  char* sample_string = sample ? json_to_string(sample) : NULL;
+  if (!sample_string)
+  {
+    fprintf(stderr, "Failed to create sample record.\n");
+    json_free(&sample);
+    return -1;
+  }
+  // +1 for the comma between records
+  size_t record_len = strlen(sample_string) + 1;
+  free(sample_string);
+  json_free(&sample);
+
+  double throughputs[N_STEPS] = {0};
+
+  printf("json_array_to_string up to %zu MB:\n", target_mb);
+  for (size_t i = 0; i < N_STEPS; ++i)
+  {
+    size_t target_len = (target_mb * 1024 * 1024) >> (N_STEPS - 1 - i);
+    struct json_array_t* array = create_records(target_len / record_len + 1);
+    if (!array)
+    {
+      fprintf(stderr, "Failed to create benchmark input.\n");
+      return -1;
+    }
+    throughputs[i] = time_serialize(array);
+    json_array_free(&array);
+  }
+
+  if (!check_scaling(throughputs))
+    return -1;
+
+  printf("numeric array up to 4M items:\n");
+  for (size_t i = 0; i < N_STEPS; ++i)
+  {
+    struct json_array_t* array = create_numbers((size_t)4000000 >> (N_STEPS - 1 - i));
+    if (!array)
+    {
+      fprintf(stderr, "Failed to create benchmark input.\n");
+      return -1;
+    }
+    throughputs[i] = time_serialize(array);
+    json_array_free(&array);
+  }
+
+  if (!check_scaling(throughputs))
+    return -1;
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "json.h"
+#include "json_internal.h"
+#include <stdio.h>
+#include <time.h>
+
+// measures stage-1 indexing throughput (see src/json_simd.c) with each
+// kernel the CPU supports, on complex_file.json replicated to a target size.
+//
+// usage: bench_json_structural_index [target size in MB (default 100)]
+
+static char*
+replicate_file(
+  const char* const filepath,
+  const size_t target_len,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+
+  char* contents = malloc(target_len + size);
+  if (!contents || fread(contents, sizeof(char), size, file) < (size_t)size)
+  {
+    free(contents);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+
+  // each copy is a complete array, so the index sees a realistic mix
+  size_t idx = size;
+  while (idx + size <= target_len)
+  {
+    memcpy(&contents[idx], contents, size);
+    idx += size;
+  }
+
+  *len = idx;
+  return contents;
+}
+
+int main(int argc, char** argv)
+{
+  size_t target_mb = 100;
+  if (argc > 1)
+    target_mb = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* input = replicate_file("complex_file.json", target_mb * 1024 * 1024, &len);
+  if (!input)
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  const char* const level_names[] = { "scalar", "sse2", "avx2" };
+  enum _json_simd_level_e best = _json_simd_detect();
+
+  printf("stage-1 index over %.2f MB:\n", (double)len / (1024.0 * 1024.0));
+  for (int level = JSON_SIMD_SCALAR; level <= (int)best; ++level)
+  {
+    struct _json_structural_index_t index;
+    if (!_json_structural_index_init(&index, input, len, (enum _json_simd_level_e)level))
+    {
+      free(input);
+      return -1;
+    }
+
+    size_t n_positions = 0;
+    size_t position = 0;
+    clock_t start = clock();
+    while (_json_structural_index_next(&index, &position))
+      n_positions++;
+    clock_t end = clock();
+    _json_structural_index_free(&index);
+
+    double seconds = (double)(end - start) / CLOCKS_PER_SEC;
+    double mb = (double)len / (1024.0 * 1024.0);
+    printf("  %-6s  %8.3f s  %10.2f MB/s  (%zu positions)\n", level_names[level], seconds, mb / seconds, n_positions);
+  }
+
+  free(input);
+  return 0;
+}
@@ -0,0 +1,197 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_tape.h"
+#include <stdio.h>
+#include <time.h>
+
+// parses complex_file.json replicated into one large array as a tree and
+// as a tape, then walks each one summing every number, to compare parse
+// time and how fast a whole document can be traversed.
+//
+// usage: json_tape_traversal [target size in MB (default 100)]
+
+static char*
+replicate_file(
+  const char* const filepath,
+  const size_t target_len,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+
+  char* contents = malloc(target_len + 2 * size + 2);
+  if (!contents || fread(&contents[1], sizeof(char), size, file) < (size_t)size)
+  {
+    free(contents);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+
+  // [copy, copy, ...]
+  contents[0] = '[';
+  size_t idx = size + 1;
+  while (idx + size + 1 <= target_len)
+  {
+    contents[idx++] = ',';
+    memcpy(&contents[idx], &contents[1], size);
+    idx += size;
+  }
+  contents[idx++] = ']';
+
+  *len = idx;
+  return contents;
+}
+
+static double sum_array(const struct json_array_t* const array);
+
+static double
+sum_object(
+  const struct json_t* const json)
+{
+  double sum = 0.0;
+  for (size_t i = 0; i < json->n_items; ++i)
+  {
+    const struct json_item_t* item = &json->items[i];
+    if (item->type == JSON_INT32)
+      sum += item->value.int32;
+    else if (item->type == JSON_DECIMAL)
+      sum += item->value.decimal;
+    else if (item->type == JSON_OBJECT)
+      sum += sum_object(item->value.object);
+    else if (item->type == JSON_ARRAY)
+      sum += sum_array(item->value.array);
+  }
+  return sum;
+}
+
+static double
+sum_array(
+  const struct json_array_t* const array)
+{
+  double sum = 0.0;
+
+  // arrays of only numbers are packed
+  int32_t* int32s = NULL;
+  double* decimals = NULL;
+  size_t len = 0;
+  if (json_array_as_int32_span(array, &int32s, &len))
+  {
+    for (size_t i = 0; i < len; ++i)
+      sum += int32s[i];
+    return sum;
+  }
+  if (json_array_as_decimal_span(array, &decimals, &len))
+  {
+    for (size_t i = 0; i < len; ++i)
+      sum += decimals[i];
+    return sum;
+  }
+  // the only other packed type is bool
+  if (array->packed_type != JSON_NOTYPE)
+    return sum;
+
+  for (size_t i = 0; i < array->n_items; ++i)
+  {
+    const struct json_item_t* item = &array->items[i];
+    if (item->type == JSON_INT32)
+      sum += item->value.int32;
+    else if (item->type == JSON_DECIMAL)
+      sum += item->value.decimal;
+    else if (item->type == JSON_OBJECT)
+      sum += sum_object(item->value.object);
+    else if (item->type == JSON_ARRAY)
+      sum += sum_array(item->value.array);
+  }
+  return sum;
+}
+
+// the tape is in document order, so visiting every item reads it front
+// to back
+static double
+sum_tape(
+  const struct json_tape_t* const tape,
+  const size_t container)
+{
+  double sum = 0.0;
+  for (size_t i = json_tape_first(tape, container); i != JSON_TAPE_NPOS; i = json_tape_next(tape, i))
+  {
+    switch (json_tape_type(tape, i))
+    {
+      case JSON_INT32:
+        sum += *json_tape_as_int32(tape, i);
+        break;
+      case JSON_DECIMAL:
+        sum += *json_tape_as_decimal(tape, i);
+        break;
+      case JSON_OBJECT:
+      case JSON_ARRAY:
+        sum += sum_tape(tape, i);
+        break;
+      default:
+        break;
+    }
+  }
+  return sum;
+}
+
+static double
+seconds_since(
+  const clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char** argv)
+{
+  size_t target_mb = 100;
+  if (argc > 1)
+    target_mb = strtoul(argv[1], NULL, 10);
+
+  size_t len = 0;
+  char* input = replicate_file("complex_file.json", target_mb * 1024 * 1024, &len);
+  if (!input)
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  const double mb = (double)len / (1024.0 * 1024.0);
+  printf("%.2f MB:\n", mb);
+
+  clock_t start = clock();
+  struct json_array_t* array = json_parse_array_from_buffer(input, len);
+  double parse_seconds = seconds_since(start);
+  if (!array)
+    return -1;
+  start = clock();
+  double tree_sum = sum_array(array);
+  double walk_seconds = seconds_since(start);
+  start = clock();
+  json_array_free(&array);
+  double free_seconds = seconds_since(start);
+  printf("  tree  parse %7.3f s (%8.2f MB/s)  walk %7.3f s  free %7.3f s  (sum %g)\n",
+      parse_seconds, mb / parse_seconds, walk_seconds, free_seconds, tree_sum);
+
+  start = clock();
+  struct json_tape_t* tape = json_tape_parse_from_buffer(input, len, JSON_PARSE_DEFAULT);
+  parse_seconds = seconds_since(start);
+  if (!tape)
+    return -1;
+  start = clock();
+  double tape_sum = sum_tape(tape, 0);
+  walk_seconds = seconds_since(start);
+  start = clock();
+  json_tape_free(&tape);
+  free_seconds = seconds_since(start);
+  printf("  tape  parse %7.3f s (%8.2f MB/s)  walk %7.3f s  free %7.3f s  (sum %g)\n",
+      parse_seconds, mb / parse_seconds, walk_seconds, free_seconds, tape_sum);
+
+  free(input);
+  return 0;
+}
@@ -7,10 +7,19 @@
 #include <stdint.h>
 #include <string.h>
 
+// keys used to be stored inline in every item and were truncated to
+// this many chars (including the null terminator). they're now stored
+// out of line at any length, this is only kept so code that sized its
+// own buffers with it still compiles
 #ifndef JSON_MAX_KEY_LEN
 #define JSON_MAX_KEY_LEN 51
 #endif
 
+// objects with at least this many items get a hash index for key lookups
+#ifndef JSON_KEY_INDEX_THRESHOLD
+#define JSON_KEY_INDEX_THRESHOLD 16
+#endif
+
 enum json_type_e 
 {
   JSON_NOTYPE,
@@ -23,9 +32,12 @@ enum json_type_e
   JSON_NULL
 };
 
+// 24 bytes on 64-bit platforms. the key is stored out of line (see
+// json_t) so items in arrays don't pay for one
 struct json_item_t
 {
   enum json_type_e type;
+  uint32_t key_len;
   union value
   {
     int32_t int32;
@@ -36,24 +48,50 @@ struct json_item_t
     bool boolean;
     bool is_null;
   } value;
-  char key[JSON_MAX_KEY_LEN];
-  size_t key_len;
+  // null-terminated, NULL for items in an array
+  const char* key;
 };
 
+struct json_arena_t;
+struct _json_key_chunk_t;
+struct json_key_pool_t;
+
 struct json_t
 {
   struct json_item_t* items;
   size_t n_items;
   size_t capacity;
+  // open-addressing hash index into items, NULL until the object
+  // reaches JSON_KEY_INDEX_THRESHOLD items
+  size_t* key_index;
+  size_t key_index_capacity;
+  // where the items' keys are copied to, in chunks that are only
+  // released with the object so the items can point into them
+  struct _json_key_chunk_t* keys;
+  // when set, keys are interned here instead (and keys is unused), so
+  // they're only stored once across every object using the pool and
+  // can be compared by pointer. see json_key_pool.h
+  struct json_key_pool_t* key_pool;
+  // the arena everything in this object was allocated from,
+  // or NULL if it's on the heap
+  struct json_arena_t* arena;
 };
 
 #include "json_getters.h"
 #include "json_setters.h"
 #include "json_adders.h"
+#include "json_arena.h"
+#include "json_writer.h"
+#include "json_key_pool.h"
 
 struct json_t*
 json_create();
 
+// creates an empty object inside arena (or on the heap if arena is NULL)
+struct json_t*
+json_create_arena(
+  struct json_arena_t* const arena);
+
 void
 json_free(
   struct json_t** json);
@@ -67,10 +105,55 @@ json_parse_from_string_with_length(
   const char* const json_string,
   const size_t len);
 
+// parses exactly len bytes straight out of buffer without copying it.
+// unlike the _with_length variant, buffer doesn't need to contain or
+// end with a null terminator
+struct json_t*
+json_parse_from_buffer(
+  const char* const buffer,
+  const size_t len);
+
 struct json_t*
 json_parse_from_file(
   const char* const filepath);
 
+// for json_parse_options_t.flags, combine them with |
+enum json_parse_flags_e
+{
+  JSON_PARSE_DEFAULT       = 0x00,
+  // fail if any key or string value isn't valid UTF-8. without this,
+  // the bytes inside strings are taken as they are
+  JSON_PARSE_VALIDATE_UTF8 = 0x01
+};
+
+// everything that can be set for a parse besides the input. a zeroed
+// struct (or passing NULL) gives the same result as the plain
+// json_parse_from_... functions
+struct json_parse_options_t
+{
+  // from enum json_parse_flags_e
+  uint32_t flags;
+  // allocate the whole document from here (see json_arena.h), NULL for
+  // the heap
+  struct json_arena_t* arena;
+  // intern every key here (see json_key_pool.h), which must outlive the
+  // document. NULL to copy keys into each object as usual
+  struct json_key_pool_t* key_pool;
+};
+
+// parses exactly len bytes of buffer like json_parse_from_buffer, with
+// options (which can be NULL)
+struct json_t*
+json_parse_with_options(
+  const char* const buffer,
+  const size_t len,
+  const struct json_parse_options_t* const options);
+
+struct json_t*
+json_parse_file_with_options(
+  const char* const filepath,
+  const struct json_parse_options_t* const options);
+
 size_t
 json_type_to_size(
   const enum json_type_e type);
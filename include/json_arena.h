@@ -0,0 +1,45 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// default size of each block the arena allocates from
+#ifndef JSON_ARENA_CHUNK_SIZE
+#define JSON_ARENA_CHUNK_SIZE 65536
+#endif
+
+struct _json_arena_chunk_t;
+struct _json_arena_adopted_t;
+
+// a bump allocator that whole parse trees can be allocated from.
+// every object, array, item buffer and string of a document parsed
+// with json_parse_options_t.arena set lives in here and is
+// released all at once with json_arena_destroy (json_free and
+// json_array_free are no-ops on arena-backed documents)
+struct json_arena_t
+{
+  struct _json_arena_chunk_t* chunks;
+  struct _json_arena_chunk_t* current;
+  size_t chunk_size;
+  // heap values handed to an arena-backed object/array through the
+  // adders/setters, freed when the arena is reset or destroyed
+  struct _json_arena_adopted_t* adopted;
+};
+
+// pass 0 to use JSON_ARENA_CHUNK_SIZE
+struct json_arena_t*
+json_arena_create(
+  const size_t chunk_size);
+
+// releases everything allocated from the arena but keeps its memory
+// around so the next document can reuse it without going back to malloc
+void
+json_arena_reset(
+  struct json_arena_t* const arena);
+
+void
+json_arena_destroy(
+  struct json_arena_t** arena);
+
+#endif
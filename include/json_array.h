@@ -8,10 +8,23 @@ struct json_item_t;
 
 struct json_array_t
 {
-  enum json_type_e* item_types;
+  // one item per value. only valid when packed_type is JSON_NOTYPE,
+  // it's NULL while the array is packed (see below)
   struct json_item_t* items;
   size_t n_items;
+  // how many items fit before the array has to grow. nothing is
+  // allocated until the first item is added
   size_t item_capacity;
+  // while every item is a JSON_INT32, JSON_DECIMAL or JSON_BOOL (all the
+  // same one) the values are stored back to back in values instead, and
+  // this is their type. the first item decides it, and anything of
+  // another type (even an int32 after decimals, as in [1.5, 2]) unpacks
+  // the array for good, setting it to JSON_NOTYPE. use
+  // json_array_get_type rather than items[i].type to check a type
+  enum json_type_e packed_type;
+  void* values;
+  // see json_t
+  struct json_arena_t* arena;
 };
 
 #include "json_array_getters.h"
@@ -21,10 +34,22 @@ struct json_array_t
 struct json_array_t*
 json_array_create();
 
+struct json_array_t*
+json_array_create_arena(
+  struct json_arena_t* const arena);
+
 void
 json_array_free(
   struct json_array_t** array);
 
+// makes room for at least capacity items in one allocation, so that
+// appending that many doesn't have to grow the array again. does
+// nothing if it already has room
+bool
+json_array_reserve(
+  struct json_array_t* const array,
+  const size_t capacity);
+
 char*
 json_array_to_string(
   const struct json_array_t* const array);
@@ -34,12 +59,62 @@ json_array_to_file(
   const struct json_array_t* const array,
   const char* const filepath);
 
+// see json_write
+bool
+json_array_write(
+  const struct json_array_t* const array,
+  json_sink_fn sink,
+  void* ctx);
+
 struct json_array_t*
 json_parse_array_from_string(
   const char* const array_string);
 
+struct json_array_t*
+json_parse_array_from_string_with_length(
+  const char* const array_string,
+  const size_t len);
+
+// see json_parse_from_buffer
+struct json_array_t*
+json_parse_array_from_buffer(
+  const char* const buffer,
+  const size_t len);
+
 struct json_array_t*
 json_parse_array_from_file(
   const char* const filepath);
 
+// see json_parse_with_options
+struct json_array_t*
+json_parse_array_with_options(
+  const char* const buffer,
+  const size_t len,
+  const struct json_parse_options_t* const options);
+
+struct json_array_t*
+json_parse_array_file_with_options(
+  const char* const filepath,
+  const struct json_parse_options_t* const options);
+
+// parses a large array on several threads (0 for one per CPU). a quick
+// serial pass finds where each of its elements starts, then the elements
+// are parsed concurrently straight into the items of one pre-sized
+// array. the result (including whether it's packed) is the same as
+// json_parse_array_with_options, but options->arena must be NULL
+// (options->key_pool is thread safe). short inputs are just parsed on
+// the calling thread
+struct json_array_t*
+json_parse_array_parallel_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const struct json_parse_options_t* const options,
+  const size_t n_threads);
+
+struct json_array_t*
+json_parse_array_parallel_from_file(
+  const char* const filepath,
+  const struct json_parse_options_t* const options,
+  const size_t n_threads);
+
 #endif
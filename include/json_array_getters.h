@@ -41,4 +41,34 @@ json_array_get_isnull(
   const struct json_array_t* const array,
   const size_t idx);
 
+enum json_type_e
+json_array_get_type(
+  const struct json_array_t* const array,
+  const size_t idx);
+
+// while the array is packed as int32s (or it's empty), points values
+// at all of them back to back and sets len to n_items. an array that's
+// been unpacked returns false even if every item is an int32 again.
+// the values belong to the array and stay valid until it's modified
+// other than with json_array_set_int32
+bool
+json_array_as_int32_span(
+  const struct json_array_t* const array,
+  int32_t** values,
+  size_t* len);
+
+// same as json_array_as_int32_span for decimals
+bool
+json_array_as_decimal_span(
+  const struct json_array_t* const array,
+  double** values,
+  size_t* len);
+
+// same as json_array_as_int32_span for bools
+bool
+json_array_as_bool_span(
+  const struct json_array_t* const array,
+  bool** values,
+  size_t* len);
+
 #endif
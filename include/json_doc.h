@@ -0,0 +1,153 @@
+#ifndef JSON_DOC_H
+#define JSON_DOC_H
+
+#include "json.h"
+#include "json_array.h"
+
+// an on-demand view of a document. opening one checks the document's
+// structure and records where every value starts and ends, but doesn't
+// copy strings, parse numbers or allocate any objects/arrays; values are
+// only read when a cursor is pointed at them.
+//
+// differences from json_parse_...:
+//   * numbers are only checked when they're read (a getter fails instead)
+//   * duplicate keys aren't detected, lookups find the first one
+struct _json_doc_node_t;
+struct _json_file_buffer_t;
+
+struct json_doc_t
+{
+  const char* input;
+  size_t input_len;
+  // one node per key and value in document order, see src/json_doc.c
+  struct _json_doc_node_t* nodes;
+  size_t n_nodes;
+  // set when the doc loaded the input itself (json_doc_open_file)
+  struct _json_file_buffer_t* file;
+};
+
+// points at one value in a json_doc_t. cursors are plain values, copy
+// them freely; they stay valid until the doc is closed
+struct json_cursor_t
+{
+  const struct json_doc_t* doc;
+  size_t node;
+  // the node of this value's key, or SIZE_MAX if it isn't in an object
+  size_t key;
+  // the node just past this value's parent, where its siblings end
+  size_t end;
+};
+
+// opens buffer[0, len) (an object or array) for on-demand reading. flags
+// are from enum json_parse_flags_e. the buffer isn't copied, so it must
+// outlive the doc and stay unmodified
+struct json_doc_t*
+json_doc_open(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags);
+
+struct json_doc_t*
+json_doc_open_file(
+  const char* const filepath,
+  const uint32_t flags);
+
+void
+json_doc_close(
+  struct json_doc_t** doc);
+
+struct json_cursor_t
+json_doc_root(
+  const struct json_doc_t* const doc);
+
+// JSON_INT32 or JSON_DECIMAL for numbers (which parses them),
+// JSON_NOTYPE if the number isn't valid
+enum json_type_e
+json_cursor_type(
+  const struct json_cursor_t* const cursor);
+
+// number of items in an object or array, 0 for anything else
+size_t
+json_cursor_len(
+  const struct json_cursor_t* const cursor);
+
+// points value at the item under key in an object
+bool
+json_cursor_find(
+  const struct json_cursor_t* const object,
+  const char* const key,
+  struct json_cursor_t* const value);
+
+// points value at the item at index in an array (walks the array, so
+// use json_cursor_first/json_cursor_next to visit every item)
+bool
+json_cursor_at(
+  const struct json_cursor_t* const array,
+  const size_t index,
+  struct json_cursor_t* const value);
+
+// points child at the first item of an object or array, false if
+// it's empty (or not a container)
+bool
+json_cursor_first(
+  const struct json_cursor_t* const container,
+  struct json_cursor_t* const child);
+
+// moves to the next item in the same object/array, false at the end
+bool
+json_cursor_next(
+  struct json_cursor_t* const cursor);
+
+// the raw key of an item in an object (not null-terminated, escapes
+// are left as they are)
+bool
+json_cursor_key(
+  const struct json_cursor_t* const cursor,
+  const char** key,
+  size_t* len);
+
+bool
+json_cursor_get_int32(
+  const struct json_cursor_t* const cursor,
+  int32_t* const value);
+
+bool
+json_cursor_get_decimal(
+  const struct json_cursor_t* const cursor,
+  double* const value);
+
+bool
+json_cursor_get_bool(
+  const struct json_cursor_t* const cursor,
+  bool* const value);
+
+bool
+json_cursor_is_null(
+  const struct json_cursor_t* const cursor);
+
+// the raw contents of a string, pointing into the input (not
+// null-terminated, escapes are left as they are)
+bool
+json_cursor_get_string(
+  const struct json_cursor_t* const cursor,
+  const char** str,
+  size_t* len);
+
+// a null-terminated heap copy of a string, the caller frees it
+char*
+json_cursor_dup_string(
+  const struct json_cursor_t* const cursor);
+
+// parses just this object/array into a regular json_t/json_array_t
+// (on the heap, or in arena if it isn't NULL)
+struct json_t*
+json_cursor_get_object(
+  const struct json_cursor_t* const cursor,
+  struct json_arena_t* const arena);
+
+struct json_array_t*
+json_cursor_get_array(
+  const struct json_cursor_t* const cursor,
+  struct json_arena_t* const arena);
+
+#endif
@@ -2,6 +2,7 @@
 #define JSON_INTERNAL_H
 
 #include <ctype.h>
+#include <pthread.h>
 #include <stdio.h>
 
 // using bit masks to define token types so we can combine
@@ -37,104 +38,581 @@ enum _token_e
   UNKNOWN     = 0x400,  //0b10000000000
 };
 
+// dense index for each token above, used to look tokens up in the
+// tables below. UNKNOWN is zero so unlisted bytes default to it
+enum _json_token_class_e
+{
+  JSON_CLASS_UNKNOWN,
+  JSON_CLASS_OPEN_BODY,
+  JSON_CLASS_CLOSE_BODY,
+  JSON_CLASS_QUOTE,
+  JSON_CLASS_COMMA,
+  JSON_CLASS_COLON,
+  JSON_CLASS_TEXT,
+  JSON_CLASS_NUMERIC,
+  JSON_CLASS_SPACE,
+  JSON_CLASS_OPEN_ARRAY,
+  JSON_CLASS_CLOSE_ARRAY,
+  JSON_N_TOKEN_CLASSES
+};
+
+// the token class of every byte (index with an unsigned char)
+extern const uint8_t _json_token_classes[256];
+
+// the enum _token_e bit for each token class
+extern const uint16_t _json_token_class_masks[JSON_N_TOKEN_CLASSES];
+
+// the tokens allowed after each token class, given the type of the
+// innermost open container afterwards (JSON_NOTYPE once the root is
+// closed) and whether an object key is being parsed
+extern const uint16_t _json_token_transitions[JSON_N_TOKEN_CLASSES][JSON_NULL + 1][2];
+
+// what a NULL json_parse_options_t* stands for
+extern const struct json_parse_options_t _json_default_parse_options;
+
+// one entry per currently open object/array while parsing.
+// the parser keeps these on an explicit stack (rather than recursing)
+// so deeply nested documents can't blow up the C stack
+struct _json_parse_frame_t
+{
+  enum json_type_e type;
+  void* container;
+};
+
+// freeing and writing a document walk it the same way, with an explicit
+// stack of the objects/arrays currently being visited. the first few
+// frames are inline so shallow documents don't allocate
+#define JSON_WALK_INLINE_DEPTH 32
+
+struct _json_walk_frame_t
+{
+  enum json_type_e type;
+  void* container;
+  // the next item to visit
+  size_t idx;
+};
+
+struct _json_walk_t
+{
+  struct _json_walk_frame_t* frames;
+  size_t len;
+  size_t capacity;
+  struct _json_walk_frame_t inline_frames[JSON_WALK_INLINE_DEPTH];
+};
+
+// inputs at least this long get a stage-1 structural index (see
+// src/json_simd.c), shorter ones aren't worth setting it up for
+#ifndef JSON_STRUCTURAL_INDEX_MIN_LEN
+#define JSON_STRUCTURAL_INDEX_MIN_LEN 4096
+#endif
+
+// arrays shorter than this are parsed on the calling thread by
+// json_parse_array_parallel_..., splitting them up costs more than it saves
+#ifndef JSON_ARRAY_PARALLEL_MIN_LEN
+#define JSON_ARRAY_PARALLEL_MIN_LEN 65536
+#endif
+
+// how much input is indexed at a time, must be a multiple of 64
+#define JSON_STRUCTURAL_WINDOW 16384
+
+enum _json_simd_level_e
+{
+  JSON_SIMD_SCALAR,
+  JSON_SIMD_SSE2,
+  JSON_SIMD_AVX2
+};
+
+// positions of every structural character and the start of every
+// string, number and literal, built one window at a time as the parser
+// consumes it
+struct _json_structural_index_t
+{
+  const char* input;
+  size_t input_len;
+  enum _json_simd_level_e level;
+  // how much of the input has been indexed so far
+  size_t scanned;
+  size_t window_start;
+  // offsets from window_start
+  uint32_t* positions;
+  size_t n_positions;
+  size_t position_idx;
+  // state carried from one 64-byte block to the next
+  uint64_t prev_ends_odd_backslash;
+  uint64_t prev_in_string;
+  uint64_t prev_ends_scalar;
+};
+
+// how many keys a parse using a key pool remembers having interned, so
+// keys that repeat don't have to go through the pool (and its lock)
+// every time. must be a power of two
+#define JSON_KEY_CACHE_SIZE 64
+
+struct _json_key_cache_entry_t
+{
+  // the pool's copy, NULL for an empty entry
+  const char* key;
+  size_t len;
+};
+
 struct _json_parse_info_t
 {
-  const char* const json_string;
+  // not const so the push parser (json_parser_t) can move them
+  // as input arrives
+  const char* json_string;
+  // the input is never read at or past json_string_len, so
+  // it doesn't need to be null-terminated
+  size_t json_string_len;
   size_t json_string_idx;
-  char parsed_key[JSON_MAX_KEY_LEN];
-  char* parsed_value;
-  size_t parsed_value_len;
-  size_t parsed_value_capacity;
-  enum json_type_e parsed_value_type;
+  // where parsed values are allocated from, NULL for the heap
+  struct json_arena_t* const arena;
+  // enum json_parse_flags_e values
+  const uint32_t flags;
+  // every object parsed interns its keys here if it isn't NULL
+  struct json_key_pool_t* const key_pool;
+  struct _json_key_cache_entry_t key_cache[JSON_KEY_CACHE_SIZE];
+  // the last parsed key, pointing into json_string (not null-terminated)
+  const char* parsed_key;
+  size_t parsed_key_len;
   bool parsing_key;
-  bool parsing_value;
-  bool inside_quotes;
   enum _token_e previous_token;
-  bool expecting_delimiter;
+  struct _json_parse_frame_t* stack;
+  size_t stack_len;
+  size_t stack_capacity;
+  // NULL unless the input is long enough to be indexed up front
+  struct _json_structural_index_t* structural_index;
+};
+
+// what one kind of parse (building a tree or a tape, calling a SAX
+// handler) does with each token. _json_parse_token does everything they
+// have in common, i.e., checking each token is allowed where it is,
+// matching brackets, keeping the stack of open objects/arrays, telling
+// keys from values and scanning strings, numbers and literals, then
+// calls these with the result. start and len are where the token is in
+// json_string (without the quotes for strings). NULL callbacks are
+// skipped
+struct _json_token_handler_t
+{
+  // an object (type JSON_OBJECT) or array was opened. container is
+  // kept with it on parse_info's stack
+  bool (*open)(
+    void* ctx,
+    struct _json_parse_info_t* const parse_info,
+    const enum json_type_e type,
+    const size_t start,
+    void** container);
+  // the innermost object/array is being closed, it's still on the stack
+  bool (*close)(
+    void* ctx,
+    struct _json_parse_info_t* const parse_info,
+    const size_t start);
+  // also kept in parse_info->parsed_key until the next key
+  bool (*key)(
+    void* ctx,
+    struct _json_parse_info_t* const parse_info,
+    const size_t start,
+    const size_t len);
+  // a string, number, bool or null. value isn't set for strings, or for
+  // numbers when defer_numbers is (their type is JSON_NOTYPE then)
+  bool (*value)(
+    void* ctx,
+    struct _json_parse_info_t* const parse_info,
+    const enum json_type_e type,
+    union value* const value,
+    const size_t start,
+    const size_t len);
+  // only find where numbers end, leaving them to be parsed later
+  bool defer_numbers;
+};
+
+// builds json_t/json_array_t trees, ctx is a void** pointing at the
+// root. if the root is NULL it's created when its opening token arrives
+extern const struct _json_token_handler_t _json_tree_handler;
+
+// large enough for any int32 or decimal written by _json_format_int32
+// and _json_format_decimal (the longest is e.g. "-100000000000000000000.0")
+#define JSON_NUMBER_BUFFER_SIZE 32
+
+// size of the buffer writes are batched up in before going to the sink
+#ifndef JSON_WRITER_BUFFER_SIZE
+#define JSON_WRITER_BUFFER_SIZE 4096
+#endif
+
+// a growable, null-terminated string that tracks its own length so
+// appends never have to rescan it
+struct _json_string_builder_t
+{
+  char* data;
+  size_t len;
+  size_t capacity;
+};
+
+struct _json_writer_t
+{
+  json_sink_fn sink;
+  void* ctx;
+  // when set, output is appended here directly instead of going
+  // through the buffer and sink (used by the to_string functions)
+  struct _json_string_builder_t* builder;
+  char buffer[JSON_WRITER_BUFFER_SIZE];
+  size_t len;
+};
+
+// one key or value of a json_doc_t. nodes are stored in document order,
+// so the first item of an object/array is the node right after it and
+// an object's items alternate key, value, key, value, ...
+struct _json_doc_node_t
+{
+  // the value is input[start, end), including quotes/brackets
+  size_t start;
+  size_t end;
+  // the node after this one and everything inside it, i.e., its next
+  // sibling
+  size_t next;
+};
+
+// the state of a json_doc_t while it's being indexed
+struct _json_doc_builder_t
+{
+  struct json_doc_t* doc;
+  size_t nodes_capacity;
+  // the node of each object/array that's still open
+  size_t* stack;
+  size_t stack_len;
+  size_t stack_capacity;
+};
+
+// the tags and payloads of struct json_tape_t words (see json_tape.h)
+#define JSON_TAPE_TAG_SHIFT 56
+#define JSON_TAPE_PAYLOAD_MASK ((UINT64_C(1) << JSON_TAPE_TAG_SHIFT) - 1)
+
+// an object/array that's still open while a tape is built
+struct _json_tape_frame_t
+{
+  // index of its open word
+  size_t open;
+  size_t n_items;
+};
+
+struct _json_tape_builder_t
+{
+  uint64_t* words;
+  size_t len;
+  size_t capacity;
+  struct _json_string_builder_t strings;
+  struct _json_tape_frame_t* stack;
+  size_t stack_len;
+  size_t stack_capacity;
+};
+
+// the state of a json_sax_parse_... call
+struct _json_sax_parser_t
+{
+  const struct json_sax_handler_t* handler;
+  void* user_data;
+};
+
+// the smallest and largest chunk a json_t copies its keys into. each
+// new chunk is twice the size of the last, so small objects stay small
+#define JSON_KEY_CHUNK_MIN_SIZE 64
+#define JSON_KEY_CHUNK_MAX_SIZE 4096
+
+// one block of a json_t's keys, the newest chunk is first
+struct _json_key_chunk_t
+{
+  struct _json_key_chunk_t* next;
+  size_t used;
+  size_t capacity;
+  char data[];
+};
+
+// chunks a json_key_pool_t stores its keys in
+#define JSON_KEY_POOL_CHUNK_SIZE 16384
+
+struct _json_key_pool_entry_t
+{
+  // NULL for an empty slot
+  const char* key;
+  size_t len;
+  size_t hash;
+};
+
+// an open-addressing hash set of keys. lookups only take the lock for
+// reading, so threads parsing documents with the same (mostly warmed
+// up) keys don't wait on each other
+struct json_key_pool_t
+{
+  pthread_rwlock_t lock;
+  struct _json_key_pool_entry_t* entries;
+  size_t capacity;
+  size_t n_keys;
+  struct _json_key_chunk_t* chunks;
+};
+
+struct json_parser_t
+{
+  // json_string always points into buffer
+  struct _json_parse_info_t parse_info;
+  // the input that hasn't been consumed yet, which starts with
+  // whatever token was cut off by the end of the last chunk
+  struct _json_string_builder_t buffer;
+  // a copy of the last parsed key, once buffer no longer holds it
+  struct _json_string_builder_t key;
+  // JSON_NOTYPE until the root's opening token arrives
+  enum json_type_e root_type;
+  void* root;
+  uint16_t expected_token;
+  // how far into a cut off string it's already known there's no
+  // closing quote, so long strings aren't rescanned on every chunk
+  size_t scanned;
+  bool failed;
+  bool finished;
+};
+
+// the contents of a file being parsed, either mapped into memory
+// or read onto the heap (see _json_load_file)
+struct _json_file_buffer_t
+{
+  char* contents;
+  size_t len;
+  bool mapped;
+};
+
+struct json_lines_reader_t
+{
+  const char* input;
+  size_t input_len;
+  // where the next line starts
+  size_t idx;
+  size_t line;
+  // set when the reader loaded the input itself
+  struct _json_file_buffer_t file;
+  // every record is parsed into this, it's reset for the next one
+  struct json_arena_t* arena;
+  uint32_t flags;
+  bool failed;
+};
+
+// shared by the threads of a json_lines_parse_parallel call
+struct _json_lines_job_t
+{
+  const char* input;
+  size_t input_len;
+  size_t chunk_size;
+  bool ordered;
+  uint32_t flags;
+  // a json_lines_record_fn
+  bool (*callback)(struct json_t*, const size_t, void*);
+  void* ctx;
+  pthread_mutex_t lock;
+  // signalled whenever a chunk's turn to deliver (ordered) is over
+  pthread_cond_t delivered;
+  // where the next chunk starts and which number it gets
+  size_t next_start;
+  size_t next_chunk;
+  size_t next_delivery;
+  // no more chunks are handed out once either is set
+  bool failed;
+  bool stopped;
+  size_t error_offset;
 };
 
-enum _token_e
-_json_get_token_type(
-  const char current_char);
+struct _json_lines_worker_t
+{
+  struct _json_lines_job_t* job;
+  pthread_t thread;
+  struct json_arena_t* arena;
+  // in ordered mode, the current chunk's records until its turn
+  struct json_t** records;
+  size_t* offsets;
+  size_t n_records;
+  size_t records_capacity;
+};
+
+// shared by the threads of a json_parse_array_parallel_... call
+struct _json_array_job_t
+{
+  const char* input;
+  // element i lies between separators i and i + 1 (the array's
+  // brackets and the commas between its elements)
+  size_t* separators;
+  size_t n_elements;
+  // one slot per element, filled in by whichever thread parses it
+  struct json_item_t* items;
+  uint32_t flags;
+  struct json_key_pool_t* key_pool;
+  size_t elements_per_task;
+  pthread_mutex_t lock;
+  size_t next_element;
+  bool failed;
+};
+
+struct json_lines_writer_t
+{
+  json_sink_fn sink;
+  void* ctx;
+  // set when the writer opened the file itself
+  FILE* file;
+  bool failed;
+};
 
 size_t
 _json_get_key_index(
   const struct json_t* const json,
   const char* const key,
+  const size_t key_len,
   bool* key_exists);
 
-uint16_t 
-_json_get_next_expected_token(
-  const enum _token_e current_token,
-  const bool inside_quotes);
+bool
+_json_check_key_exists(
+  const struct json_t* const json,
+  const char* const search_key,
+  const size_t search_key_len);
 
+// the non-public part of json_add_item, which doesn't hand the value
+// over to the object's arena (the parser uses this for values that
+// were already allocated from it). key doesn't need to be
+// null-terminated, it's copied into the object
 bool
-_json_array_item_cleanup(
-  const char* const array_string,
-  size_t* idx,
-  const size_t len);
+_json_add_item(
+  struct json_t* const json,
+  const enum json_type_e type,
+  const char* const key,
+  const size_t key_len,
+  void* value);
 
-char*
-_json_fetch_body_string(
-  const char* const json_string,
-  size_t* idx);
+// the same as _json_add_item for an object using a key pool, where key
+// is the pool's copy
+bool
+_json_add_interned_item(
+  struct json_t* const json,
+  const enum json_type_e type,
+  const char* const key,
+  const size_t key_len,
+  void* value);
 
-char*
-_json_fetch_array_string(
-  const char* const json_string,
-  size_t* idx);
+// see _json_add_item
+bool
+_json_array_append_item(
+  struct json_array_t* array,
+  const enum json_type_e type,
+  void* value);
 
-void
-_json_reset_parse_info(
-  struct _json_parse_info_t* const parse_info);
+// grows the array's storage (packed values or items, whichever it's
+// using) to hold capacity items
+bool
+_json_array_resize(
+  struct json_array_t* const array,
+  const size_t capacity);
+
+// moves a packed array's values out into items so it can hold
+// other types
+bool
+_json_array_unpack(
+  struct json_array_t* const array);
 
-char* 
-_json_fetch_quote_string(
-  const char* const array_string,
-  size_t* idx);
+// the same as _json_get_item_value for the item at idx
+void*
+_json_array_get_value(
+  const struct json_array_t* const array,
+  const size_t idx);
 
-char* 
-_json_fetch_numeric_string(
-  const char* const array_string,
-  size_t* idx,
-  bool* contains_decimal);
+size_t
+_json_hash_key(
+  const char* const key,
+  const size_t key_len);
 
-char*
-_json_fetch_array_item_string(
-  const char* const array_string,
-  size_t* idx,
-  bool* contains_decimal);
+// the same as _json_get_key_index for an object using a key pool, where
+// key has already been interned so only pointers need comparing
+size_t
+_json_get_interned_key_index(
+  const struct json_t* const json,
+  const char* const key,
+  bool* key_exists);
+
+// the pool's copy of key[0, key_len), adding it if it isn't there yet.
+// NULL if it can't be allocated
+const char*
+_json_key_pool_intern(
+  struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len);
+
+// the pool's copy of key[0, key_len), or NULL if it was never interned
+const char*
+_json_key_pool_find(
+  struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len);
+
+void
+_json_update_key_index(
+  struct json_t* const json);
 
-enum json_type_e
-_json_get_item_type(
-  const char* const item_string);
+void
+_json_skip_whitespace(
+  struct _json_parse_info_t* const parse_info);
 
 bool
-_json_check_key_exists(
-  const struct json_t* const json,
-  const char* const search_key);
+_json_scan_quote_string(
+  struct _json_parse_info_t* const parse_info,
+  size_t* start_idx,
+  size_t* len);
 
-bool 
-_json_add_item(
-  struct json_t* const json,
+// moves the index to the start of the next token, or to the end of the
+// input if there isn't one. fails if something that isn't whitespace
+// was left between the last token and the next
+bool
+_json_advance_to_token(
   struct _json_parse_info_t* const parse_info);
 
-void
-_json_append_char_to_key(
+bool
+_json_attach_value(
   struct _json_parse_info_t* const parse_info,
-  const char current_char);
+  const enum json_type_e type,
+  void* value);
 
-bool 
-_json_append_char_to_value(
+bool
+_json_push_container(
   struct _json_parse_info_t* const parse_info,
-  const char current_char);
+  const enum json_type_e type,
+  void* container);
 
-bool 
-_json_perform_token_action(
-  struct json_t* const json,
-  const enum _token_e current_token,
-  const char current_char,
-  struct _json_parse_info_t* const parse_info);
+// the length of the true, false or null at start, 0 if it isn't one of
+// them. type is set to JSON_BOOL or JSON_NULL and value to the bool (or
+// to true for null, i.e., json_item_t.is_null)
+size_t
+_json_scan_literal(
+  const char* const start,
+  const size_t max_len,
+  enum json_type_e* const type,
+  bool* const value);
+
+// handles the token at the current index (which must be the start of
+// one) and moves the index past it. expected_token is the set of
+// tokens allowed here, and is updated to the set allowed next
+bool
+_json_parse_token(
+  struct _json_parse_info_t* const parse_info,
+  const struct _json_token_handler_t* const handler,
+  void* ctx,
+  uint16_t* const expected_token);
+
+// runs the whole input through _json_parse_token, starting with a root
+// allowed by root_tokens (OPEN_BODY and/or OPEN_ARRAY). only whitespace
+// can follow the root
+bool
+_json_parse_tokens(
+  struct _json_parse_info_t* const parse_info,
+  const struct _json_token_handler_t* const handler,
+  void* ctx,
+  const uint16_t root_tokens);
+
+bool
+_json_parse_document(
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e root_type,
+  void* root);
 
 void
 _json_set_item_value(
@@ -145,29 +623,210 @@ void*
 _json_get_item_value(
   struct json_item_t* const item);
 
+// does nothing if the item belongs to an arena, see json_arena.h
 void
 _json_deallocate_item(
+  const struct json_arena_t* const arena,
   struct json_item_t* item);
 
-bool 
-_json_resize_string(
-  char** to_string,
-  size_t* capacity);
-
-bool
-_json_write_value_buffer_to_string(
-  char* formatted_buffer,
-  char** to_string,
-  size_t* to_string_len,
-  size_t* to_string_capacity);
-
-bool 
-_json_value_to_string(
-  char* formatted_buffer,
-  size_t max_buffer_len,
-  const struct json_item_t* const item,
-  char** to_string,
-  size_t* to_string_len,
-  size_t* to_string_capacity);
+void
+_json_walk_init(
+  struct _json_walk_t* const walk);
+
+bool
+_json_walk_push(
+  struct _json_walk_t* const walk,
+  const enum json_type_e type,
+  void* const container);
+
+// copies the next item of the innermost container into item (packed
+// array values included), false once it has no more
+bool
+_json_walk_next(
+  struct _json_walk_t* const walk,
+  struct json_item_t* const item);
+
+void
+_json_walk_free(
+  struct _json_walk_t* const walk);
+
+// frees a heap object/array along with everything in it
+void
+_json_free_container(
+  const enum json_type_e type,
+  void* const container);
+
+bool
+_json_string_builder_init(
+  struct _json_string_builder_t* const builder,
+  const size_t initial_capacity);
+
+bool
+_json_string_builder_reserve(
+  struct _json_string_builder_t* const builder,
+  const size_t additional);
+
+bool
+_json_string_builder_append(
+  struct _json_string_builder_t* const builder,
+  const char* const data,
+  const size_t len);
+
+// hands ownership of the (null-terminated) string to the caller
+char*
+_json_string_builder_release(
+  struct _json_string_builder_t* const builder);
+
+void
+_json_string_builder_free(
+  struct _json_string_builder_t* const builder);
+
+bool
+_json_load_file(
+  const char* const filepath,
+  struct _json_file_buffer_t* const file_buffer);
+
+void
+_json_release_file(
+  struct _json_file_buffer_t* const file_buffer);
+
+// one per online CPU where that can be found out, otherwise 1
+size_t
+_json_default_thread_count();
+
+void*
+_json_arena_alloc(
+  struct json_arena_t* const arena,
+  const size_t size);
+
+void*
+_json_arena_realloc(
+  struct json_arena_t* const arena,
+  void* ptr,
+  const size_t old_size,
+  const size_t new_size);
+
+// makes the arena responsible for freeing a heap value that was
+// added to one of its objects/arrays
+bool
+_json_arena_adopt(
+  struct json_arena_t* const arena,
+  const enum json_type_e type,
+  void* value);
+
+// malloc/realloc/free that go through arena if it's not NULL
+void*
+_json_alloc(
+  struct json_arena_t* const arena,
+  const size_t size);
+
+void*
+_json_realloc(
+  struct json_arena_t* const arena,
+  void* ptr,
+  const size_t old_size,
+  const size_t new_size);
+
+void
+_json_release(
+  struct json_arena_t* const arena,
+  void* ptr);
+
+// both return the number of characters written, no null terminator is added
+size_t
+_json_format_int32(
+  const int32_t value,
+  char* const buffer);
+
+// shortest digits that read back as exactly the same double, always with
+// a '.' or exponent so it parses as a decimal again. NaN and infinity have
+// no JSON representation and are written as null
+size_t
+_json_format_decimal(
+  const double value,
+  char* const buffer);
+
+// the best instruction set the current CPU supports
+enum _json_simd_level_e
+_json_simd_detect(void);
+
+bool
+_json_structural_index_init(
+  struct _json_structural_index_t* const index,
+  const char* const input,
+  const size_t input_len,
+  const enum _json_simd_level_e level);
+
+void
+_json_structural_index_free(
+  struct _json_structural_index_t* const index);
+
+// the next indexed position, false once the input is exhausted
+bool
+_json_structural_index_next(
+  struct _json_structural_index_t* const index,
+  size_t* const position);
+
+// JSON only counts these four as whitespace (isspace also takes \v and \f)
+static inline bool
+_json_is_whitespace(
+  const char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// index of the first byte at or after idx that isn't whitespace, or len
+size_t
+_json_find_non_whitespace(
+  const char* const input,
+  const size_t idx,
+  const size_t len);
+
+// index of the first '"' or '\\' at or after idx, or len
+size_t
+_json_find_quote_or_backslash(
+  const char* const input,
+  const size_t idx,
+  const size_t len);
+
+// true if input[0, len) is valid UTF-8 (no overlong encodings,
+// surrogates, code points past U+10FFFF or truncated sequences)
+bool
+_json_validate_utf8(
+  const char* const input,
+  const size_t len);
+
+// converts the number at start (up to end) in place, without copying it or
+// depending on the C locale. integers that don't fit in an int32 are
+// returned as decimals
+bool
+_json_parse_number(
+  const char* const start,
+  const char* const end,
+  enum json_type_e* const type,
+  union value* const value,
+  size_t* const len);
+
+bool
+_json_writer_flush(
+  struct _json_writer_t* const writer);
+
+bool
+_json_writer_write(
+  struct _json_writer_t* const writer,
+  const char* const data,
+  const size_t len);
+
+bool
+_json_write_item_value(
+  struct _json_writer_t* const writer,
+  const struct json_item_t* const item);
+
+// writes an object (type JSON_OBJECT) or array (JSON_ARRAY)
+bool
+_json_write_container(
+  struct _json_writer_t* const writer,
+  const enum json_type_e type,
+  const void* const container);
 
 #endif
@@ -0,0 +1,29 @@
+#ifndef JSON_KEY_POOL_H
+#define JSON_KEY_POOL_H
+
+#include <stddef.h>
+
+// a set of interned keys that documents can be parsed into (see
+// json_parse_options_t). each distinct key is stored once no matter
+// how many objects use it, and objects compare keys by pointer instead
+// of by content.
+//
+// one pool can be shared by any number of documents, arenas and
+// threads. it only grows, so it's meant for keys that repeat (field
+// names) rather than ones that don't (e.g., ids used as keys), and it
+// has to outlive every document using it
+struct json_key_pool_t;
+
+struct json_key_pool_t*
+json_key_pool_create(void);
+
+void
+json_key_pool_destroy(
+  struct json_key_pool_t** pool);
+
+// number of distinct keys in the pool
+size_t
+json_key_pool_size(
+  struct json_key_pool_t* const pool);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef JSON_LINES_H
+#define JSON_LINES_H
+
+#include "json.h"
+#include "json_writer.h"
+
+// reads newline-delimited JSON (JSON Lines / NDJSON) one record at a
+// time. each line is parsed in place, into an arena the reader resets
+// before every record, so reading a file doesn't allocate per record
+// once the arena has grown to fit the largest one.
+//
+// every record must be an object on a single line. blank lines are
+// skipped and a "\r\n" line ending is allowed
+struct json_lines_reader_t;
+
+// reads buffer[0, len), which isn't copied, so it must outlive the
+// reader and stay unmodified. flags are from enum json_parse_flags_e
+struct json_lines_reader_t*
+json_lines_reader_open(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags);
+
+struct json_lines_reader_t*
+json_lines_reader_open_file(
+  const char* const filepath,
+  const uint32_t flags);
+
+// parses the next record, which stays valid until the next call (or
+// until the reader is closed). NULL once there are no more records or
+// if a line isn't valid, see json_lines_reader_failed
+struct json_t*
+json_lines_reader_next(
+  struct json_lines_reader_t* const reader);
+
+// true if json_lines_reader_next stopped at a line that isn't valid
+bool
+json_lines_reader_failed(
+  const struct json_lines_reader_t* const reader);
+
+// the (1-based) line number of the last record returned, or of the
+// invalid line once the reader has failed
+size_t
+json_lines_reader_line(
+  const struct json_lines_reader_t* const reader);
+
+void
+json_lines_reader_close(
+  struct json_lines_reader_t** reader);
+
+// reads JSON Lines on several threads at once. the input is split at
+// newlines into chunks of about chunk_size bytes and each thread parses
+// a chunk at a time into its own arena
+#ifndef JSON_LINES_CHUNK_SIZE
+#define JSON_LINES_CHUNK_SIZE (1 << 20)
+#endif
+
+struct json_lines_parallel_options_t
+{
+  // 0 for one per CPU
+  size_t n_threads;
+  // 0 for JSON_LINES_CHUNK_SIZE
+  size_t chunk_size;
+  // when true records are delivered one at a time in the order of the
+  // input. otherwise each is delivered as soon as it's parsed, from
+  // several threads at once, so the callback has to be thread safe
+  bool ordered;
+  // from enum json_parse_flags_e
+  uint32_t flags;
+};
+
+// called for every record with the offset of its line in the input.
+// the record is only valid during the call. return false to stop
+typedef bool (*json_lines_record_fn)(
+  struct json_t* record,
+  const size_t offset,
+  void* ctx);
+
+// calls callback for every record in buffer[0, len). options can be
+// NULL for the defaults (unordered, one thread per CPU). false if a
+// line isn't a valid object (error_offset, if it isn't NULL, is then
+// set to the offset of the first one found, otherwise SIZE_MAX), if the
+// callback returned false or if something couldn't be allocated. no
+// record past an invalid line is delivered in ordered mode
+bool
+json_lines_parse_parallel(
+  const char* const buffer,
+  const size_t len,
+  const struct json_lines_parallel_options_t* const options,
+  json_lines_record_fn callback,
+  void* ctx,
+  size_t* const error_offset);
+
+bool
+json_lines_parse_parallel_file(
+  const char* const filepath,
+  const struct json_lines_parallel_options_t* const options,
+  json_lines_record_fn callback,
+  void* ctx,
+  size_t* const error_offset);
+
+// writes records one per line, each in the same format as
+// json_to_string followed by '\n'
+struct json_lines_writer_t;
+
+// creates (or truncates) filepath
+struct json_lines_writer_t*
+json_lines_writer_open(
+  const char* const filepath);
+
+// writes to sink instead, see json_writer.h
+struct json_lines_writer_t*
+json_lines_writer_open_sink(
+  json_sink_fn sink,
+  void* ctx);
+
+bool
+json_lines_writer_write(
+  struct json_lines_writer_t* const writer,
+  const struct json_t* const json);
+
+// false if anything couldn't be written (including flushing the file)
+bool
+json_lines_writer_close(
+  struct json_lines_writer_t** writer);
+
+#endif
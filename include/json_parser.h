@@ -0,0 +1,52 @@
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include "json.h"
+#include "json_array.h"
+
+// a push parser for documents that arrive in pieces, e.g., from a
+// socket. chunks can be any size and split the input anywhere; each one
+// is parsed as soon as it's fed, only a token cut off at the end of a
+// chunk is held back until the next one. the root can be an object or
+// an array, and the result is the same as parsing the whole input with
+// json_parse_from_buffer or json_parse_array_from_buffer
+struct json_parser_t;
+
+struct json_parser_t*
+json_parser_new();
+
+// see json_parse_with_options, options can be NULL
+struct json_parser_t*
+json_parser_new_with_options(
+  const struct json_parse_options_t* const options);
+
+// false as soon as the input can't be valid JSON, after which the
+// parser only fails
+bool
+json_parser_feed(
+  struct json_parser_t* const parser,
+  const char* const chunk,
+  const size_t len);
+
+// call once all of the input has been fed. true if it was exactly one
+// complete document
+bool
+json_parser_finish(
+  struct json_parser_t* const parser);
+
+// hand the finished document over to the caller, NULL if it failed, it
+// hasn't been finished or the root was the other kind
+struct json_t*
+json_parser_take_object(
+  struct json_parser_t* const parser);
+
+struct json_array_t*
+json_parser_take_array(
+  struct json_parser_t* const parser);
+
+// also frees the document if it wasn't taken
+void
+json_parser_free(
+  struct json_parser_t** parser);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef JSON_SAX_H
+#define JSON_SAX_H
+
+#include "json.h"
+
+// callbacks for an event driven parse, which walks the input with the
+// same tokenizer as json_parse_... but calls these instead of building
+// any objects/arrays. memory use doesn't grow with the input, only with
+// how deeply it's nested.
+//
+// keys and strings point into the input (not null-terminated, escapes
+// are left as they are) and are only valid during the callback. each
+// callback returns false to stop the parse, and any of them can be NULL
+// to skip that event
+struct json_sax_handler_t
+{
+  bool (*start_object)(void* user_data);
+  bool (*end_object)(void* user_data);
+  bool (*start_array)(void* user_data);
+  bool (*end_array)(void* user_data);
+  // followed by the key's value
+  bool (*key)(void* user_data, const char* key, size_t len);
+  bool (*int32)(void* user_data, int32_t value);
+  bool (*decimal)(void* user_data, double value);
+  bool (*string)(void* user_data, const char* str, size_t len);
+  bool (*boolean)(void* user_data, bool value);
+  bool (*null)(void* user_data);
+};
+
+// parses buffer[0, len) (an object or array), calling handler with
+// user_data for every value. flags are from enum json_parse_flags_e.
+// fails if the input isn't valid JSON or a callback returns false, in
+// which case the events already sent may describe an incomplete
+// document. unlike json_parse_..., duplicate keys aren't detected
+bool
+json_sax_parse_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data);
+
+bool
+json_sax_parse_from_string(
+  const char* const json_string,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data);
+
+bool
+json_sax_parse_from_file(
+  const char* const filepath,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data);
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef JSON_TAPE_H
+#define JSON_TAPE_H
+
+#include "json.h"
+
+// a read-only document stored as one flat tape of 64-bit words plus a
+// buffer holding every string, all in a single allocation. values are
+// laid out in document order, so walking a document reads memory front
+// to back instead of chasing a pointer per object/array.
+//
+// each word is a type tag in the top 8 bits and a payload in the rest:
+//   '{' / '['  index of the matching close word
+//   '}' / ']'  number of items in the object/array
+//   '"'        offset of the (null-terminated) string in the buffer
+//   ':'        same as '"', for a key
+//   'i' / 'd'  followed by a word holding the int32/double
+//   't' 'f' 'n'
+// an object's items are its keys and values alternating.
+//
+// objects and arrays are referred to by the index of their open word,
+// the root is always at 0. like json_doc_t, duplicate keys aren't
+// detected (lookups find the first)
+struct json_tape_t
+{
+  const uint64_t* tape;
+  size_t tape_len;
+  const char* strings;
+  size_t strings_len;
+};
+
+// returned by the getters below when there's no such object/array
+#define JSON_TAPE_NPOS SIZE_MAX
+
+// flags are from enum json_parse_flags_e. the document is an object or
+// array as with json_parse_..., the input isn't referenced afterwards
+struct json_tape_t*
+json_tape_parse_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags);
+
+struct json_tape_t*
+json_tape_parse_from_string(
+  const char* const json_string,
+  const uint32_t flags);
+
+struct json_tape_t*
+json_tape_parse_from_file(
+  const char* const filepath,
+  const uint32_t flags);
+
+void
+json_tape_free(
+  struct json_tape_t** tape);
+
+// the type of the value at idx, JSON_NOTYPE for JSON_TAPE_NPOS
+enum json_type_e
+json_tape_type(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+// number of items in the object/array at idx, 0 for JSON_TAPE_NPOS
+size_t
+json_tape_len(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+// the getters mirror json_get_... for an object at index object, but
+// return NULL (or JSON_TAPE_NPOS) if key doesn't exist or holds a
+// different type
+const int32_t*
+json_tape_get_int32(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+const double*
+json_tape_get_decimal(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+const char*
+json_tape_get_string(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+size_t
+json_tape_get_object(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+size_t
+json_tape_get_array(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+const bool*
+json_tape_get_bool(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+bool
+json_tape_get_isnull(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key);
+
+// index of the first item in the object/array at container,
+// JSON_TAPE_NPOS if it's empty (or not an object/array). for an object
+// this is the index of the first value
+size_t
+json_tape_first(
+  const struct json_tape_t* const tape,
+  const size_t container);
+
+// index of the item after the one at idx in the same object/array
+// (skipping over a nested object/array in one step), JSON_TAPE_NPOS at
+// the end. together with json_tape_first this visits every item in
+// order:
+//   for (size_t i = json_tape_first(tape, array); i != JSON_TAPE_NPOS; i = json_tape_next(tape, i))
+size_t
+json_tape_next(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+// the key of an item in an object, idx has to come from
+// json_tape_first/json_tape_next on an object
+const char*
+json_tape_key(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+// the value at idx, NULL (or false) if it holds a different type.
+// objects/arrays are just idx (see json_tape_type)
+const int32_t*
+json_tape_as_int32(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+const double*
+json_tape_as_decimal(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+const char*
+json_tape_as_string(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+const bool*
+json_tape_as_bool(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+bool
+json_tape_is_null(
+  const struct json_tape_t* const tape,
+  const size_t idx);
+
+// and these mirror json_array_get_... for an array at index array.
+// finding an item walks the items before it (skipping over nested
+// objects/arrays in one step), so use json_tape_first/json_tape_next
+// to visit every item
+const int32_t*
+json_tape_array_get_int32(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+const double*
+json_tape_array_get_decimal(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+const char*
+json_tape_array_get_string(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+size_t
+json_tape_array_get_object(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+size_t
+json_tape_array_get_array(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+const bool*
+json_tape_array_get_bool(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+bool
+json_tape_array_get_isnull(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx);
+
+#endif
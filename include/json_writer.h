@@ -0,0 +1,56 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+struct json_t;
+
+// receives the serialized output piece by piece as it's produced.
+// return false to stop writing (json_write will then return false)
+typedef bool (*json_sink_fn)(
+  const char* const data,
+  const size_t len,
+  void* ctx);
+
+// writes into a fixed, caller-owned buffer. the output is kept
+// null-terminated, so at most capacity - 1 characters are written
+// before the sink reports failure
+struct json_buffer_sink_t
+{
+  char* buffer;
+  size_t capacity;
+  size_t len;
+};
+
+// ctx is a struct json_buffer_sink_t*
+bool
+json_buffer_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx);
+
+// ctx is a FILE*
+bool
+json_file_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx);
+
+// ctx is an int* holding a file descriptor (POSIX only)
+bool
+json_fd_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx);
+
+// serializes json (in the same format as json_to_string) straight into
+// sink without building the output in memory first
+bool
+json_write(
+  const struct json_t* const json,
+  json_sink_fn sink,
+  void* ctx);
+
+#endif
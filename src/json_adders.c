@@ -9,30 +9,77 @@ json_add_item(
   const char* const key,
   void* value)
 {
-  if (!json)
+  if (!key || !_json_add_item(json, type, key, strlen(key), value))
     return false;
 
-  if (strlen(key) == 0)
-    return false;
+  // heap values given to an arena-backed object are freed with the arena
+  if (json->arena)
+    return _json_arena_adopt(json->arena, type, value);
 
-	if (_json_check_key_exists(json, key))
-		return false;
+  return true;
+}
+
+// copies key into the object's newest key chunk, starting a new
+// chunk if it doesn't fit
+static const char*
+_json_store_key(
+  struct json_t* const json,
+  const char* const key,
+  const size_t key_len)
+{
+  struct _json_key_chunk_t* chunk = json->keys;
+  if (!chunk || chunk->capacity - chunk->used < key_len + 1)
+  {
+    size_t capacity = chunk ? chunk->capacity * 2 : JSON_KEY_CHUNK_MIN_SIZE;
+    if (capacity > JSON_KEY_CHUNK_MAX_SIZE)
+      capacity = JSON_KEY_CHUNK_MAX_SIZE;
+    if (capacity < key_len + 1)
+      capacity = key_len + 1;
+
+    chunk = _json_alloc(json->arena, sizeof(*chunk) + capacity);
+    if (!chunk)
+      return NULL;
+    chunk->next = json->keys;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    json->keys = chunk;
+  }
+
+  char* stored = &chunk->data[chunk->used];
+  memcpy(stored, key, key_len);
+  stored[key_len] = '\0';
+  chunk->used += key_len + 1;
+  return stored;
+}
 
+// stores an item whose key is already where it'll live
+static bool
+_json_append_item(
+  struct json_t* const json,
+  const enum json_type_e type,
+  const char* const key,
+  const size_t key_len,
+  void* value)
+{
   struct json_item_t* current_item
     = &json->items[json->n_items];
 
   current_item->type = type;
   _json_set_item_value(current_item, value); 
-
-  strncpy(current_item->key, key, JSON_MAX_KEY_LEN - 1);
-  current_item->key_len = strlen(current_item->key);
+  current_item->key = key;
+  current_item->key_len = (uint32_t)key_len;
 
   json->n_items++;
+  _json_update_key_index(json);
 
   if (json->n_items >= json->capacity)
   {
-    size_t new_capacity = json->capacity *= 2;
-    void* alloc = realloc(json->items, new_capacity * sizeof(*json->items));
+    size_t new_capacity = json->capacity * 2;
+    void* alloc = _json_realloc(
+        json->arena,
+        json->items,
+        json->n_items * sizeof(*json->items),
+        new_capacity * sizeof(*json->items));
     if (!alloc)
       return false;
     json->capacity = new_capacity;
@@ -40,7 +87,58 @@ json_add_item(
   }
 
   return true;
+}
+
+bool
+_json_add_item(
+  struct json_t* const json,
+  const enum json_type_e type,
+  const char* const key,
+  const size_t key_len,
+  void* value)
+{
+  if (!json)
+    return false;
+
+  if (key_len == 0 || key_len > UINT32_MAX)
+    return false;
+
+  if (json->key_pool)
+  {
+    const char* interned = _json_key_pool_intern(json->key_pool, key, key_len);
+    if (!interned)
+      return false;
+    return _json_add_interned_item(json, type, interned, key_len, value);
+  }
+
+	if (_json_check_key_exists(json, key, key_len))
+		return false;
+
+  const char* stored_key = _json_store_key(json, key, key_len);
+  if (!stored_key)
+    return false;
+
+  return _json_append_item(json, type, stored_key, key_len, value);
+}
+
+bool
+_json_add_interned_item(
+  struct json_t* const json,
+  const enum json_type_e type,
+  const char* const key,
+  const size_t key_len,
+  void* value)
+{
+  if (key_len == 0 || key_len > UINT32_MAX)
+    return false;
+
+  // interned keys are only ever equal if they're the same pointer
+  bool key_exists = false;
+  _json_get_interned_key_index(json, key, &key_exists);
+  if (key_exists)
+    return false;
 
+  return _json_append_item(json, type, key, key_len, value);
 }
 
 bool
@@ -0,0 +1,244 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_arena.h"
+#include "json_internal.h"
+
+// every allocation is aligned to this so any item type can be stored
+#define JSON_ARENA_ALIGNMENT 16
+
+struct _json_arena_chunk_t
+{
+  struct _json_arena_chunk_t* next;
+  size_t used;
+  size_t capacity;
+  // offset of the most recent allocation so it can be grown in place
+  size_t last;
+  char* data;
+};
+
+struct _json_arena_adopted_t
+{
+  enum json_type_e type;
+  void* value;
+  struct _json_arena_adopted_t* next;
+};
+
+static size_t
+_json_arena_align(
+  const size_t size)
+{
+  return (size + JSON_ARENA_ALIGNMENT - 1) & ~(size_t)(JSON_ARENA_ALIGNMENT - 1);
+}
+
+static struct _json_arena_chunk_t*
+_json_arena_chunk_create(
+  const size_t capacity)
+{
+  // the chunk header and its data share one allocation, data starts
+  // at the first aligned offset after the header
+  size_t header_size = _json_arena_align(sizeof(struct _json_arena_chunk_t));
+  struct _json_arena_chunk_t* chunk = malloc(header_size + capacity);
+  if (!chunk)
+    return NULL;
+
+  chunk->next = NULL;
+  chunk->used = 0;
+  chunk->capacity = capacity;
+  chunk->last = 0;
+  chunk->data = (char*)chunk + header_size;
+  return chunk;
+}
+
+struct json_arena_t*
+json_arena_create(
+  const size_t chunk_size)
+{
+  struct json_arena_t* arena = malloc(sizeof(*arena));
+  if (!arena)
+    return NULL;
+
+  arena->chunk_size = _json_arena_align(chunk_size == 0 ? JSON_ARENA_CHUNK_SIZE : chunk_size);
+  arena->adopted = NULL;
+  arena->chunks = _json_arena_chunk_create(arena->chunk_size);
+  if (!arena->chunks)
+  {
+    free(arena);
+    return NULL;
+  }
+  arena->current = arena->chunks;
+
+  return arena;
+}
+
+static void
+_json_arena_free_adopted(
+  struct json_arena_t* const arena)
+{
+  // the list itself lives in the arena, only the values need freeing
+  for (struct _json_arena_adopted_t* adopted = arena->adopted; adopted; adopted = adopted->next)
+  {
+    struct json_item_t item = { .type = adopted->type };
+    _json_set_item_value(&item, adopted->value);
+    _json_deallocate_item(NULL, &item);
+  }
+
+  arena->adopted = NULL;
+}
+
+void
+json_arena_reset(
+  struct json_arena_t* const arena)
+{
+  _json_arena_free_adopted(arena);
+
+  // keep the regular sized chunks for reuse, but oversized
+  // ones were made for a specific allocation so let those go
+  struct _json_arena_chunk_t** link = &arena->chunks;
+  while (*link)
+  {
+    struct _json_arena_chunk_t* chunk = *link;
+    if (chunk->capacity != arena->chunk_size && chunk != arena->chunks)
+    {
+      *link = chunk->next;
+      free(chunk);
+      continue;
+    }
+
+    chunk->used = 0;
+    chunk->last = 0;
+    link = &chunk->next;
+  }
+
+  arena->current = arena->chunks;
+}
+
+void
+json_arena_destroy(
+  struct json_arena_t** arena)
+{
+  if (!*arena)
+    return;
+
+  _json_arena_free_adopted(*arena);
+
+  struct _json_arena_chunk_t* chunk = (*arena)->chunks;
+  while (chunk)
+  {
+    struct _json_arena_chunk_t* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+
+  free(*arena);
+  *arena = NULL;
+}
+
+void*
+_json_arena_alloc(
+  struct json_arena_t* const arena,
+  const size_t size)
+{
+  size_t aligned_size = _json_arena_align(size == 0 ? 1 : size);
+  struct _json_arena_chunk_t* chunk = arena->current;
+
+  // move on to the next chunk (which may be left over from
+  // a reset) or make a new one if this one is full
+  while (chunk->used + aligned_size > chunk->capacity)
+  {
+    if (!chunk->next || chunk->next->capacity < aligned_size)
+    {
+      size_t capacity = aligned_size > arena->chunk_size ? aligned_size : arena->chunk_size;
+      struct _json_arena_chunk_t* new_chunk = _json_arena_chunk_create(capacity);
+      if (!new_chunk)
+        return NULL;
+      new_chunk->next = chunk->next;
+      chunk->next = new_chunk;
+    }
+
+    chunk = chunk->next;
+    arena->current = chunk;
+  }
+
+  chunk->last = chunk->used;
+  chunk->used += aligned_size;
+  return &chunk->data[chunk->last];
+}
+
+void*
+_json_arena_realloc(
+  struct json_arena_t* const arena,
+  void* ptr,
+  const size_t old_size,
+  const size_t new_size)
+{
+  if (!ptr)
+    return _json_arena_alloc(arena, new_size);
+
+  // if this was the latest allocation it can usually just grow in place
+  struct _json_arena_chunk_t* chunk = arena->current;
+  if ((char*)ptr == &chunk->data[chunk->last]
+      && chunk->last + _json_arena_align(new_size) <= chunk->capacity)
+  {
+    chunk->used = chunk->last + _json_arena_align(new_size);
+    return ptr;
+  }
+
+  void* alloc = _json_arena_alloc(arena, new_size);
+  if (!alloc)
+    return NULL;
+  memcpy(alloc, ptr, old_size < new_size ? old_size : new_size);
+  return alloc;
+}
+
+bool
+_json_arena_adopt(
+  struct json_arena_t* const arena,
+  const enum json_type_e type,
+  void* value)
+{
+  // only heap types need to be cleaned up
+  if (type != JSON_STRING && type != JSON_OBJECT && type != JSON_ARRAY)
+    return true;
+
+  struct _json_arena_adopted_t* adopted = _json_arena_alloc(arena, sizeof(*adopted));
+  if (!adopted)
+    return false;
+
+  adopted->type = type;
+  adopted->value = value;
+  adopted->next = arena->adopted;
+  arena->adopted = adopted;
+  return true;
+}
+
+void*
+_json_alloc(
+  struct json_arena_t* const arena,
+  const size_t size)
+{
+  if (arena)
+    return _json_arena_alloc(arena, size);
+  return malloc(size);
+}
+
+void*
+_json_realloc(
+  struct json_arena_t* const arena,
+  void* ptr,
+  const size_t old_size,
+  const size_t new_size)
+{
+  if (arena)
+    return _json_arena_realloc(arena, ptr, old_size, new_size);
+  return realloc(ptr, new_size);
+}
+
+void
+_json_release(
+  struct json_arena_t* const arena,
+  void* ptr)
+{
+  // arena memory is only released all at once
+  if (!arena)
+    free(ptr);
+}
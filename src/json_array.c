@@ -6,27 +6,23 @@
 struct json_array_t*
 json_array_create()
 {
-  struct json_array_t* array = calloc(1, sizeof(*array));
+  return json_array_create_arena(NULL);
+}
+
+struct json_array_t*
+json_array_create_arena(
+  struct json_arena_t* const arena)
+{
+  struct json_array_t* array = _json_alloc(arena, sizeof(*array));
   if (!array)
     return NULL;
 
   array->n_items = 0;
-  array->item_capacity = 10;
-  array->item_types = calloc(array->item_capacity, sizeof(*array->item_types));
-  if (!array->item_types)
-  {
-    free(array);
-    return NULL;
-  }
-
-  array->items = calloc(array->item_capacity, sizeof(*array->items));
-
-  if (!array->items)
-  {
-    free(array->item_types);
-    free(array);
-    return NULL;
-  }
+  array->item_capacity = 0;
+  array->packed_type = JSON_NOTYPE;
+  array->items = NULL;
+  array->values = NULL;
+  array->arena = arena;
 
   return array;
 }
@@ -35,211 +31,181 @@ void
 json_array_free(
   struct json_array_t** array)
 {
-  for (size_t i = 0; i < (*array)->n_items; ++i)
-    _json_deallocate_item(&(*array)->items[i]);
-
-  free((*array)->items);
-  (*array)->items = NULL;
-
-  free((*array)->item_types);
-  (*array)->item_types = NULL;
+  // arena-backed arrays are only released with the arena itself
+  if ((*array)->arena)
+  {
+    *array = NULL;
+    return;
+  }
 
-  free(*array);
+  _json_free_container(JSON_ARRAY, *array);
   *array = NULL;
-
 }
 
-char*
-json_array_to_string(
-  const struct json_array_t* const array)
+bool
+json_array_reserve(
+  struct json_array_t* const array,
+  const size_t capacity)
 {
-  size_t len = 0;
-  size_t capacity = 100;
-
-  char* to_string = calloc(capacity, sizeof(char));
-  if (!to_string)
-    return NULL;
+  if (!array)
+    return false;
 
-  strncat(to_string, "[", 2);
-  len = 1;
+  if (capacity <= array->item_capacity)
+    return true;
 
-  for (size_t i = 0; i < array->n_items; ++i)
+  // the storage is allocated along with the first item, once it's known
+  // whether the array is packed
+  if (array->n_items == 0)
   {
-    // 256 is a little overkill but shouldn't be a noticeable problem
-    char formatted_buffer[256] = {0};
-    if (!_json_value_to_string(
-          formatted_buffer,
-          256,
-          &array->items[i],
-          &to_string,
-          &len,
-          &capacity))
-      goto failure;
-
-    // add comma
-    if (i < array->n_items - 1
-        && !_json_write_value_buffer_to_string(",", &to_string, &len, &capacity))
-      goto failure;
+    array->item_capacity = capacity;
+    return true;
   }
 
-  // write closing bracket with null terminator
-  if (!_json_write_value_buffer_to_string("]", &to_string, &len, &capacity))
-    goto failure;
+  return _json_array_resize(array, capacity);
+}
 
-  return to_string;
+bool
+_json_array_resize(
+  struct json_array_t* const array,
+  const size_t capacity)
+{
+  bool packed = array->packed_type != JSON_NOTYPE;
+  size_t item_size = packed ? json_type_to_size(array->packed_type) : sizeof(*array->items);
+  if (capacity > SIZE_MAX / item_size)
+    return false;
 
-failure:
-  free(to_string);
-  return NULL;
+  void* storage = packed ? array->values : (void*)array->items;
+  void* alloc = _json_realloc(
+      array->arena,
+      storage,
+      array->n_items * item_size,
+      capacity * item_size);
+  if (!alloc)
+    return false;
+
+  if (packed)
+    array->values = alloc;
+  else
+    array->items = alloc;
+  array->item_capacity = capacity;
+  return true;
 }
 
 bool
-json_array_to_file(
-  const struct json_array_t* const array,
-  const char* const filepath)
+_json_array_unpack(
+  struct json_array_t* const array)
 {
-  char* array_string = json_array_to_string(array);
-  if (!array_string)
+  if (array->item_capacity > SIZE_MAX / sizeof(*array->items))
     return false;
-  size_t len = strlen(array_string);
 
-  FILE* to_file = fopen(filepath, "w+");
-  if (!to_file)
+  struct json_item_t* items = _json_alloc(array->arena, array->item_capacity * sizeof(*items));
+  if (!items)
     return false;
 
-  if (fwrite(array_string, sizeof(char), len, to_file) < len)
+  for (size_t i = 0; i < array->n_items; ++i)
   {
-    free(array_string);
-    fclose(to_file);
-    return false;
+    items[i].type = array->packed_type;
+    _json_set_item_value(&items[i], _json_array_get_value(array, i));
+    items[i].key = NULL;
+    items[i].key_len = 0;
   }
 
-  free(array_string);
-  fclose(to_file);
+  _json_release(array->arena, array->values);
+  array->values = NULL;
+  array->items = items;
+  array->packed_type = JSON_NOTYPE;
   return true;
 }
 
-struct json_array_t*
-json_parse_array_from_string(
-  const char* const array_string)
+void*
+_json_array_get_value(
+  const struct json_array_t* const array,
+  const size_t idx)
 {
-  size_t len = strlen(array_string);
+  switch (array->packed_type)
+  {
+    case JSON_INT32:
+      return &((int32_t*)array->values)[idx];
+    case JSON_DECIMAL:
+      return &((double*)array->values)[idx];
+    case JSON_BOOL:
+      return &((bool*)array->values)[idx];
+    // never packed
+    case JSON_STRING:
+    case JSON_OBJECT:
+    case JSON_ARRAY:
+    case JSON_NULL:
+    case JSON_NOTYPE:
+      break;
+  }
 
-  struct json_array_t* array = json_array_create();
-  if (!array)
+  return _json_get_item_value(&array->items[idx]);
+}
+
+char*
+json_array_to_string(
+  const struct json_array_t* const array)
+{
+  struct _json_string_builder_t builder;
+  if (!_json_string_builder_init(&builder, 128))
     return NULL;
 
-  char* endptr = NULL; // used for string to numeric conversions (can't declare inside switch)
-  char* item_string = NULL;
+  struct _json_writer_t writer = {
+    .sink = NULL,
+    .ctx = NULL,
+    .builder = &builder,
+    .len = 0
+  };
 
-  // starting at 1 to skip open bracket [
-  // going to len - 1 (exclusive) to ignore closing bracket ]
-  for (size_t i = 1; i < len - 1; ++i)
+  if (!_json_write_container(&writer, JSON_ARRAY, array))
   {
-    bool contains_decimal = false;
-    item_string = _json_fetch_array_item_string(array_string, &i, &contains_decimal);
-
-    if (!item_string)
-      goto cleanup;
-
-    enum json_type_e type = _json_get_item_type(item_string);
-
-    switch (type)
-    {
-      case JSON_INT32:
-      {
-        if (!contains_decimal)
-        {
-          int32_t value = strtol(item_string, &endptr, 10);
-          if (!json_array_append(array, type, &value))
-            goto cleanup;
-          break;
-        }
-
-        // not doing a fallthrough to avoid compiler warning, so using goto instead
-        if (contains_decimal)
-        {
-          type = JSON_DECIMAL;
-          goto decimal;
-        }
-
-        break;
-      }
-
-      decimal:
-      case JSON_DECIMAL:
-      {
-        double value = strtod(item_string, &endptr);
-        if (!json_array_append(array, type, &value))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_STRING:
-      {
-        char* value = strdup(item_string);
-        if (!json_array_append(array, type, value))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_BOOL:
-      {
-        // bool must be "true" or "false" all lowercase
-        bool value = false;
-        if (strcmp(item_string, "true") == 0)
-          value = true;
-        else if (strcmp(item_string, "false") != 0)
-          goto cleanup;
-
-        if (!json_array_append(array, type, &value))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_NULL:
-      {
-        if (!json_array_append_null(array))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_OBJECT:
-      {
-        struct json_t* object = json_parse_from_string(item_string);
-        if (!object)
-          goto cleanup;
-        if (!json_array_append(array, type, object))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_ARRAY:
-      {
-        struct json_array_t* new_array = json_parse_array_from_string(item_string);
-        if (!new_array)
-          goto cleanup;
-        if (!json_array_append(array, type, new_array))
-          goto cleanup;
-        break;
-      }
-
-      case JSON_NOTYPE:
-        goto cleanup;
-    }
-
-    free(item_string);
+    _json_string_builder_free(&builder);
+    return NULL;
   }
 
-  goto createandreturn;
+  return _json_string_builder_release(&builder);
+}
 
-cleanup:
-  free(item_string);
-  json_array_free(&array);
-  return NULL;
+bool
+json_array_to_file(
+  const struct json_array_t* const array,
+  const char* const filepath)
+{
+  FILE* to_file = fopen(filepath, "w");
+  if (!to_file)
+    return false;
 
-createandreturn:
-  return array;
+  // streamed straight to the file, the full string is never built
+  bool success = json_array_write(array, json_file_sink, to_file);
+
+  if (fclose(to_file) != 0)
+    return false;
+
+  return success;
+}
+
+bool
+json_array_write(
+  const struct json_array_t* const array,
+  json_sink_fn sink,
+  void* ctx)
+{
+  struct _json_writer_t writer = {
+    .sink = sink,
+    .ctx = ctx,
+    .builder = NULL,
+    .len = 0
+  };
+
+  return _json_write_container(&writer, JSON_ARRAY, array)
+    && _json_writer_flush(&writer);
+}
+
+struct json_array_t*
+json_parse_array_from_string(
+  const char* const array_string)
+{
+  return json_parse_array_from_buffer(array_string, strlen(array_string));
 }
 
 struct json_array_t*
@@ -249,77 +215,78 @@ json_parse_array_from_string_with_length(
 {
   // read at most len characters
   // if we find \0 then we can terminate early
-  size_t capacity = 100;
-  char* new_str = calloc(capacity, sizeof(char));
-  if (!new_str)
-    return NULL;
+  const char* terminator = memchr(array_string, '\0', len);
+  if (terminator)
+    return json_parse_array_from_buffer(array_string, terminator - array_string);
 
-  size_t i = 0;
-  for (; i < len; ++i)
-  {
-    new_str[i] = array_string[i];
-    if (array_string[i] == '\0')
-      break;
-    if (i + 1 == capacity)
-    {
-      size_t new_capacity = capacity * 2;
-      // redundant multiplication but explicit
-      void* alloc = realloc(new_str, new_capacity * sizeof(char));
-      if (!alloc)
-      {
-        free(new_str);
-        return NULL;
-      }
-      capacity = new_capacity;
-      new_str = alloc;
-    }
-  }
-
-  // if no terminator was found, append one to the end
-  if (i == len)
-    new_str[i] = '\0';
-
-
-  struct json_array_t* array = json_parse_array_from_string(new_str);
-  free(new_str);
+  return json_parse_array_from_buffer(array_string, len);
+}
 
-  return array;
+struct json_array_t*
+json_parse_array_from_buffer(
+  const char* const buffer,
+  const size_t len)
+{
+  return json_parse_array_with_options(buffer, len, NULL);
 }
 
 struct json_array_t*
 json_parse_array_from_file(
   const char* const filepath)
 {
-  FILE* json_file = fopen(filepath, "r");
-  if (!json_file)
-    return NULL;
-
-  rewind(json_file);
-  if (fseek(json_file, 0, SEEK_END) == -1)
-    goto failure;
+  return json_parse_array_file_with_options(filepath, NULL);
+}
 
-  int size = ftell(json_file);
-  
-  rewind(json_file);
+struct json_array_t*
+json_parse_array_with_options(
+  const char* const buffer,
+  const size_t len,
+  const struct json_parse_options_t* const options)
+{
+  const struct json_parse_options_t* opts = options ? options : &_json_default_parse_options;
 
-  char* file_string = calloc(size, sizeof(char));
-  if (!file_string)
-    goto failure;
+  struct json_array_t* array = json_array_create_arena(opts->arena);
+  if (!array)
+    return NULL;
 
-  if (fread(file_string, sizeof(char), size, json_file) < size)
+  struct _json_parse_info_t parse_info = {
+    .json_string = buffer,
+    .json_string_len = len,
+    .json_string_idx = 0,
+    .arena = opts->arena,
+    .flags = opts->flags,
+    .key_pool = opts->key_pool,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 0,
+    .structural_index = NULL
+  };
+
+  if (!_json_parse_document(&parse_info, JSON_ARRAY, array))
   {
-    free(file_string);
-    goto failure;
+    json_array_free(&array);
+    return NULL;
   }
 
-  fclose(json_file);
+  return array;
+}
+
+struct json_array_t*
+json_parse_array_file_with_options(
+  const char* const filepath,
+  const struct json_parse_options_t* const options)
+{
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return NULL;
 
-  struct json_array_t* array = json_parse_array_from_string_with_length(file_string, size);
-  free(file_string);
+  struct json_array_t* array = json_parse_array_with_options(file_buffer.contents, file_buffer.len, options);
+  _json_release_file(&file_buffer);
 
   return array;
-
-failure:
-  fclose(json_file);
-  return NULL;
 }
@@ -2,36 +2,69 @@
 #include "json_array.h"
 #include "json_internal.h"
 
-static bool
+bool
 _json_array_append_item(
   struct json_array_t* array,
   const enum json_type_e type,
   void* value)
 {
-  array->item_types[array->n_items] = type;
-  if (array->n_items + 1 == array->item_capacity)
+  // the first item decides whether the array starts out packed, and it
+  // stays that way until an item of another type is added
+  if (array->n_items == 0)
+    array->packed_type = type == JSON_INT32 || type == JSON_DECIMAL || type == JSON_BOOL
+      ? type
+      : JSON_NOTYPE;
+  else if (array->packed_type != JSON_NOTYPE
+      && array->packed_type != type
+      && !_json_array_unpack(array))
+    return false;
+
+  // doubling keeps appends amortized O(1), json_array_reserve can
+  // be used up front to skip the intermediate sizes entirely
+  if (array->n_items == 0)
   {
-    size_t new_item_capacity = array->item_capacity * 2;
-    void* alloc = realloc(array->item_types, new_item_capacity * sizeof(*array->item_types));
-    if (!alloc)
+    size_t capacity = array->item_capacity > 0 ? array->item_capacity : 10;
+    if (!_json_array_resize(array, capacity))
       return false;
-    array->item_capacity = new_item_capacity;
-    array->item_types = alloc;
+  }
+  else if (array->n_items == array->item_capacity
+      && !_json_array_resize(array, array->item_capacity * 2))
+    return false;
 
-    void* alloc2 = realloc(array->items, new_item_capacity * sizeof(*array->items));
-    if (!alloc2)
-      return false;
-    array->items = alloc;
+  if (array->packed_type != JSON_NOTYPE)
+  {
+    memcpy(_json_array_get_value(array, array->n_items), value, json_type_to_size(type));
+    array->n_items++;
+    return true;
   }
 
   struct json_item_t* current_item = &array->items[array->n_items];
   current_item->type = type;
   _json_set_item_value(current_item, value); 
+  current_item->key = NULL;
+  current_item->key_len = 0;
 
   array->n_items++;
   return true;
 }
 
+// appends a value given to us by the user, which an
+// arena-backed array needs to take ownership of
+static bool
+_json_array_append_owned_item(
+  struct json_array_t* array,
+  const enum json_type_e type,
+  void* value)
+{
+  if (!_json_array_append_item(array, type, value))
+    return false;
+
+  if (array->arena)
+    return _json_arena_adopt(array->arena, type, value);
+
+  return true;
+}
+
 bool
 json_array_append_null(
   struct json_array_t* array)
@@ -52,7 +85,7 @@ json_array_append(
   if (item_type == JSON_NULL)
     return json_array_append_null(array);
 
-  return _json_array_append_item(array, item_type, value);
+  return _json_array_append_owned_item(array, item_type, value);
 }
 
 bool
@@ -84,7 +117,7 @@ json_array_append_string(
   struct json_array_t* array,
   char* value)
 {
-  return _json_array_append_item(array, JSON_STRING, value);
+  return _json_array_append_owned_item(array, JSON_STRING, value);
 }
 
 bool
@@ -92,7 +125,7 @@ json_array_append_object(
   struct json_array_t* array,
   struct json_t* value)
 {
-  return _json_array_append_item(array, JSON_OBJECT, value);
+  return _json_array_append_owned_item(array, JSON_OBJECT, value);
 }
 
 bool
@@ -100,5 +133,5 @@ json_array_append_array(
   struct json_array_t* array,
   struct json_array_t* value)
 {
-  return _json_array_append_item(array, JSON_ARRAY, value);
+  return _json_array_append_owned_item(array, JSON_ARRAY, value);
 }
@@ -8,7 +8,7 @@ json_array_get(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 /* all of these getters are the same besides the return type (besides null)
@@ -20,7 +20,7 @@ json_array_get_int32(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 double*
@@ -28,7 +28,7 @@ json_array_get_decimal(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 char*
@@ -36,7 +36,7 @@ json_array_get_string(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 struct json_t*
@@ -44,7 +44,7 @@ json_array_get_object(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 struct json_array_t*
@@ -52,7 +52,7 @@ json_array_get_array(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 bool*
@@ -60,7 +60,7 @@ json_array_get_bool(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return _json_get_item_value(&array->items[idx]);
+  return _json_array_get_value(array, idx);
 }
 
 bool
@@ -68,5 +68,72 @@ json_array_get_isnull(
   const struct json_array_t* const array,
   const size_t idx)
 {
-  return array->items[idx].type == JSON_NULL;
+  return json_array_get_type(array, idx) == JSON_NULL;
+}
+
+enum json_type_e
+json_array_get_type(
+  const struct json_array_t* const array,
+  const size_t idx)
+{
+  if (array->packed_type != JSON_NOTYPE)
+    return array->packed_type;
+  return array->items[idx].type;
+}
+
+// the packed values if they're all of type (an empty array
+// counts as any type)
+static bool
+_json_array_span(
+  const struct json_array_t* const array,
+  const enum json_type_e type,
+  void** values,
+  size_t* len)
+{
+  if (array->n_items > 0 && array->packed_type != type)
+  {
+    *values = NULL;
+    *len = 0;
+    return false;
+  }
+
+  *values = array->values;
+  *len = array->n_items;
+  return true;
+}
+
+bool
+json_array_as_int32_span(
+  const struct json_array_t* const array,
+  int32_t** values,
+  size_t* len)
+{
+  void* span = NULL;
+  bool is_span = _json_array_span(array, JSON_INT32, &span, len);
+  *values = span;
+  return is_span;
+}
+
+bool
+json_array_as_decimal_span(
+  const struct json_array_t* const array,
+  double** values,
+  size_t* len)
+{
+  void* span = NULL;
+  bool is_span = _json_array_span(array, JSON_DECIMAL, &span, len);
+  *values = span;
+  return is_span;
+}
+
+bool
+json_array_as_bool_span(
+  const struct json_array_t* const array,
+  bool** values,
+  size_t* len)
+{
+  void* span = NULL;
+  bool is_span = _json_array_span(array, JSON_BOOL, &span, len);
+  *values = span;
+  return is_span;
 }
@@ -0,0 +1,393 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_internal.h"
+
+static bool
+_json_array_add_separator(
+  struct _json_array_job_t* const job,
+  size_t* const capacity,
+  const size_t position)
+{
+  // n_elements counts separators until the scan is done
+  if (job->n_elements == *capacity)
+  {
+    size_t new_capacity = *capacity * 2;
+    void* alloc = realloc(job->separators, new_capacity * sizeof(*job->separators));
+    if (!alloc)
+      return false;
+    job->separators = alloc;
+    *capacity = new_capacity;
+  }
+
+  job->separators[job->n_elements++] = position;
+  return true;
+}
+
+// walks the structural index of the input (which already knows where
+// strings are) keeping track of the nesting depth, and records the
+// array's brackets and every comma directly inside it. the elements
+// themselves are only checked once they're parsed, which also makes
+// sure the commas found really are separators
+static bool
+_json_array_find_elements(
+  struct _json_array_job_t* const job,
+  const size_t len)
+{
+  const char* const input = job->input;
+  struct _json_structural_index_t index;
+  if (!_json_structural_index_init(&index, input, len, _json_simd_detect()))
+    return false;
+
+  size_t capacity = 1024;
+  job->separators = malloc(capacity * sizeof(*job->separators));
+  job->n_elements = 0;
+  bool success = false;
+  if (!job->separators)
+    goto cleanup;
+
+  size_t depth = 0;
+  bool closed = false;
+  size_t position = 0;
+  while (_json_structural_index_next(&index, &position))
+  {
+    const char c = input[position];
+
+    // nothing but whitespace is allowed around the array
+    if (closed || (depth == 0 && c != '['))
+      goto cleanup;
+
+    if (c == '[' || c == '{')
+    {
+      if (depth == 0 && !_json_array_add_separator(job, &capacity, position))
+        goto cleanup;
+      depth++;
+    }
+    else if (c == ']' || c == '}')
+    {
+      depth--;
+      if (depth == 0)
+      {
+        if (c != ']' || !_json_array_add_separator(job, &capacity, position))
+          goto cleanup;
+        closed = true;
+      }
+    }
+    else if (c == ',' && depth == 1
+        && !_json_array_add_separator(job, &capacity, position))
+      goto cleanup;
+  }
+
+  if (!closed)
+    goto cleanup;
+
+  // "[]" and "[ ]" have no elements rather than one empty one
+  job->n_elements--;
+  if (job->n_elements == 1
+      && _json_find_non_whitespace(input, job->separators[0] + 1, job->separators[1]) == job->separators[1])
+    job->n_elements = 0;
+  success = true;
+
+cleanup:
+  _json_structural_index_free(&index);
+  return success;
+}
+
+// parses element i into its slot. parse_info belongs to the calling
+// thread and is pointed at just the element
+static bool
+_json_array_parse_element(
+  struct _json_array_job_t* const job,
+  struct _json_parse_info_t* const parse_info,
+  const size_t i)
+{
+  const char* const input = job->input;
+  size_t end = job->separators[i + 1];
+  const size_t start = _json_find_non_whitespace(input, job->separators[i] + 1, end);
+  while (end > start && _json_is_whitespace(input[end - 1]))
+    end--;
+  if (start == end)
+    return false;
+
+  parse_info->json_string = &input[start];
+  parse_info->json_string_len = end - start;
+  parse_info->json_string_idx = 0;
+
+  struct json_item_t* const item = &job->items[i];
+  switch (_json_token_class_masks[_json_token_classes[(unsigned char)input[start]]])
+  {
+    case OPEN_BODY:
+    {
+      struct json_t* json = json_create();
+      if (!json)
+        return false;
+      json->key_pool = job->key_pool;
+      if (!_json_parse_document(parse_info, JSON_OBJECT, json))
+      {
+        json_free(&json);
+        return false;
+      }
+
+      item->type = JSON_OBJECT;
+      item->value.object = json;
+      return true;
+    }
+
+    case OPEN_ARRAY:
+    {
+      struct json_array_t* array = json_array_create();
+      if (!array)
+        return false;
+      if (!_json_parse_document(parse_info, JSON_ARRAY, array))
+      {
+        json_array_free(&array);
+        return false;
+      }
+
+      item->type = JSON_ARRAY;
+      item->value.array = array;
+      return true;
+    }
+
+    case QUOTE:
+    {
+      size_t str_start = 0;
+      size_t str_len = 0;
+      if (!_json_scan_quote_string(parse_info, &str_start, &str_len)
+          || parse_info->json_string_idx != end - start)
+        return false;
+
+      char* str = malloc(str_len + 1);
+      if (!str)
+        return false;
+      memcpy(str, &parse_info->json_string[str_start], str_len);
+      str[str_len] = '\0';
+
+      item->type = JSON_STRING;
+      item->value.str = str;
+      return true;
+    }
+
+    case NUMERIC:
+    {
+      enum json_type_e type = JSON_NOTYPE;
+      union value value;
+      size_t len = 0;
+      if (!_json_parse_number(&input[start], &input[end], &type, &value, &len)
+          || len != end - start)
+        return false;
+
+      item->type = type;
+      _json_set_item_value(item, &value);
+      return true;
+    }
+
+    case TEXT:
+    {
+      enum json_type_e type = JSON_NOTYPE;
+      bool value = true;
+      if (_json_scan_literal(&input[start], end - start, &type, &value) != end - start)
+        return false;
+
+      item->type = type;
+      _json_set_item_value(item, &value);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+static void*
+_json_array_parse_elements(
+  void* arg)
+{
+  struct _json_array_job_t* const job = arg;
+
+  struct _json_parse_info_t parse_info = {
+    .json_string = NULL,
+    .json_string_len = 0,
+    .json_string_idx = 0,
+    .arena = NULL,
+    .flags = job->flags,
+    .key_pool = job->key_pool,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 0,
+    .structural_index = NULL
+  };
+
+  for (;;)
+  {
+    pthread_mutex_lock(&job->lock);
+    const size_t first = job->next_element;
+    const bool done = job->failed || first >= job->n_elements;
+    job->next_element += job->elements_per_task;
+    pthread_mutex_unlock(&job->lock);
+    if (done)
+      break;
+
+    size_t last = first + job->elements_per_task;
+    if (last > job->n_elements)
+      last = job->n_elements;
+
+    for (size_t i = first; i < last; ++i)
+    {
+      if (!_json_array_parse_element(job, &parse_info, i))
+      {
+        pthread_mutex_lock(&job->lock);
+        job->failed = true;
+        pthread_mutex_unlock(&job->lock);
+        break;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+// the serial parser packs arrays whose items are all int32s, all
+// decimals or all bools (mixed ones keep each item's own type), so the
+// same is done here once every slot is filled
+static void
+_json_array_pack_items(
+  struct json_array_t* const array)
+{
+  const enum json_type_e type = array->items[0].type;
+  if (type != JSON_INT32 && type != JSON_DECIMAL && type != JSON_BOOL)
+    return;
+  for (size_t i = 1; i < array->n_items; ++i)
+    if (array->items[i].type != type)
+      return;
+
+  void* values = malloc(array->n_items * json_type_to_size(type));
+  if (!values)
+    return;
+
+  for (size_t i = 0; i < array->n_items; ++i)
+  {
+    if (type == JSON_INT32)
+      ((int32_t*)values)[i] = array->items[i].value.int32;
+    else if (type == JSON_DECIMAL)
+      ((double*)values)[i] = array->items[i].value.decimal;
+    else
+      ((bool*)values)[i] = array->items[i].value.boolean;
+  }
+
+  free(array->items);
+  array->items = NULL;
+  array->values = values;
+  array->packed_type = type;
+}
+
+struct json_array_t*
+json_parse_array_parallel_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const struct json_parse_options_t* const options,
+  const size_t n_threads)
+{
+  const struct json_parse_options_t* opts = options ? options : &_json_default_parse_options;
+
+  // arenas aren't thread safe
+  if (opts->arena)
+    return NULL;
+
+  size_t n_workers = n_threads > 0 ? n_threads : _json_default_thread_count();
+  if (n_workers == 1 || len < JSON_ARRAY_PARALLEL_MIN_LEN)
+    return json_parse_array_with_options(buffer, len, opts);
+
+  struct _json_array_job_t job = {
+    .input = buffer,
+    .separators = NULL,
+    .n_elements = 0,
+    .items = NULL,
+    .flags = opts->flags,
+    .key_pool = opts->key_pool,
+    .elements_per_task = 1,
+    .next_element = 0,
+    .failed = false
+  };
+
+  struct json_array_t* array = NULL;
+  pthread_t* threads = NULL;
+  bool lock_created = false;
+  if (!_json_array_find_elements(&job, len)
+      || !(array = json_array_create()))
+    goto cleanup;
+
+  if (job.n_elements == 0)
+    goto cleanup;
+
+  job.items = calloc(job.n_elements, sizeof(*job.items));
+  if (!job.items)
+  {
+    json_array_free(&array);
+    goto cleanup;
+  }
+
+  // the slots are all there up front, unfilled ones are JSON_NOTYPE (so
+  // a failed parse can free the array as it is)
+  array->items = job.items;
+  array->n_items = job.n_elements;
+  array->item_capacity = job.n_elements;
+
+  // small enough runs of elements that the threads finish together
+  job.elements_per_task = job.n_elements / (n_workers * 16);
+  if (job.elements_per_task == 0)
+    job.elements_per_task = 1;
+  if (n_workers > job.n_elements)
+    n_workers = job.n_elements;
+
+  threads = malloc(n_workers * sizeof(*threads));
+  if (!threads || pthread_mutex_init(&job.lock, NULL) != 0)
+  {
+    json_array_free(&array);
+    goto cleanup;
+  }
+  lock_created = true;
+
+  // the calling thread is one of the workers
+  size_t n_started = 1;
+  for (; n_started < n_workers; ++n_started)
+  {
+    if (pthread_create(&threads[n_started], NULL, _json_array_parse_elements, &job) != 0)
+      break;
+  }
+  _json_array_parse_elements(&job);
+  for (size_t i = 1; i < n_started; ++i)
+    pthread_join(threads[i], NULL);
+
+  if (job.failed)
+    json_array_free(&array);
+  else
+    _json_array_pack_items(array);
+
+cleanup:
+  if (lock_created)
+    pthread_mutex_destroy(&job.lock);
+  free(threads);
+  free(job.separators);
+  return array;
+}
+
+struct json_array_t*
+json_parse_array_parallel_from_file(
+  const char* const filepath,
+  const struct json_parse_options_t* const options,
+  const size_t n_threads)
+{
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return NULL;
+
+  struct json_array_t* array = json_parse_array_parallel_from_buffer(file_buffer.contents, file_buffer.len, options, n_threads);
+  _json_release_file(&file_buffer);
+
+  return array;
+}
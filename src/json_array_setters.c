@@ -10,10 +10,33 @@ json_array_set(
   const enum json_type_e type,
   void* value)
 {
+  // packed values can be overwritten in place by the same type,
+  // anything else needs the array unpacked first
+  if (array->packed_type == type)
+  {
+    memcpy(_json_array_get_value(array, idx), value, json_type_to_size(type));
+    return;
+  }
+
+  if (array->packed_type != JSON_NOTYPE && !_json_array_unpack(array))
+  {
+    // the array was still given value, so don't leak it
+    struct json_item_t item = { .type = type };
+    _json_set_item_value(&item, value);
+    _json_deallocate_item(array->arena, &item);
+    if (array->arena)
+      _json_arena_adopt(array->arena, type, value);
+    return;
+  }
+
   struct json_item_t* current_item = &array->items[idx];
-  _json_deallocate_item(current_item);
+  _json_deallocate_item(array->arena, current_item);
   current_item->type = type;
   _json_set_item_value(current_item, value);
+
+  // heap values given to an arena-backed array are freed with the arena
+  if (array->arena)
+    _json_arena_adopt(array->arena, type, value);
 }
 
 void
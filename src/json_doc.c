@@ -0,0 +1,513 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_doc.h"
+#include "json_internal.h"
+
+static bool
+_json_doc_add_node(
+  struct _json_doc_builder_t* const builder,
+  const size_t start,
+  const size_t end)
+{
+  struct json_doc_t* const doc = builder->doc;
+  if (doc->n_nodes == builder->nodes_capacity)
+  {
+    size_t new_capacity = builder->nodes_capacity * 2;
+    void* alloc = realloc(doc->nodes, new_capacity * sizeof(*doc->nodes));
+    if (!alloc)
+      return false;
+    doc->nodes = alloc;
+    builder->nodes_capacity = new_capacity;
+  }
+
+  doc->nodes[doc->n_nodes].start = start;
+  doc->nodes[doc->n_nodes].end = end;
+  doc->nodes[doc->n_nodes].next = doc->n_nodes + 1;
+  doc->n_nodes++;
+  return true;
+}
+
+static bool
+_json_doc_open_container(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  const size_t start,
+  void** container)
+{
+  (void)parse_info;
+  (void)type;
+  (void)container;
+  struct _json_doc_builder_t* const builder = ctx;
+
+  if (builder->stack_len == builder->stack_capacity)
+  {
+    size_t new_capacity = builder->stack_capacity * 2;
+    void* alloc = realloc(builder->stack, new_capacity * sizeof(*builder->stack));
+    if (!alloc)
+      return false;
+    builder->stack = alloc;
+    builder->stack_capacity = new_capacity;
+  }
+
+  // the end and next node are filled in once it's closed
+  builder->stack[builder->stack_len++] = builder->doc->n_nodes;
+  return _json_doc_add_node(builder, start, start);
+}
+
+static bool
+_json_doc_close_container(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start)
+{
+  (void)parse_info;
+  struct _json_doc_builder_t* const builder = ctx;
+  struct json_doc_t* const doc = builder->doc;
+
+  const size_t node = builder->stack[--builder->stack_len];
+  doc->nodes[node].end = start + 1;
+  doc->nodes[node].next = doc->n_nodes;
+  return true;
+}
+
+static bool
+_json_doc_key(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start,
+  const size_t len)
+{
+  (void)parse_info;
+  // including the quotes
+  return _json_doc_add_node(ctx, start - 1, start + len + 1);
+}
+
+static bool
+_json_doc_value(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  union value* const value,
+  const size_t start,
+  const size_t len)
+{
+  (void)parse_info;
+  (void)value;
+  if (type == JSON_STRING)
+    return _json_doc_add_node(ctx, start - 1, start + len + 1);
+  return _json_doc_add_node(ctx, start, start + len);
+}
+
+// only records where each key and value is instead of building objects.
+// numbers are only checked when they're read
+static const struct _json_token_handler_t _json_doc_handler = {
+  .open = _json_doc_open_container,
+  .close = _json_doc_close_container,
+  .key = _json_doc_key,
+  .value = _json_doc_value,
+  .defer_numbers = true
+};
+
+struct json_doc_t*
+json_doc_open(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags)
+{
+  struct json_doc_t* doc = calloc(1, sizeof(struct json_doc_t));
+  if (!doc)
+    return NULL;
+
+  doc->input = buffer;
+  doc->input_len = len;
+
+  struct _json_parse_info_t parse_info = {
+    .json_string = buffer,
+    .json_string_len = len,
+    .json_string_idx = 0,
+    .arena = NULL,
+    .flags = flags,
+    .key_pool = NULL,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 0,
+    .structural_index = NULL
+  };
+
+  struct _json_doc_builder_t builder = {
+    .doc = doc,
+    .nodes_capacity = 64,
+    .stack = malloc(16 * sizeof(size_t)),
+    .stack_len = 0,
+    .stack_capacity = 16
+  };
+  doc->nodes = malloc(builder.nodes_capacity * sizeof(*doc->nodes));
+
+  if (!builder.stack
+      || !doc->nodes
+      || !_json_parse_tokens(&parse_info, &_json_doc_handler, &builder, OPEN_BODY | OPEN_ARRAY))
+    json_doc_close(&doc);
+
+  free(builder.stack);
+
+  return doc;
+}
+
+struct json_doc_t*
+json_doc_open_file(
+  const char* const filepath,
+  const uint32_t flags)
+{
+  struct _json_file_buffer_t* file_buffer = calloc(1, sizeof(struct _json_file_buffer_t));
+  if (!file_buffer)
+    return NULL;
+
+  if (!_json_load_file(filepath, file_buffer))
+  {
+    free(file_buffer);
+    return NULL;
+  }
+
+  struct json_doc_t* doc = json_doc_open(file_buffer->contents, file_buffer->len, flags);
+  if (!doc)
+  {
+    _json_release_file(file_buffer);
+    free(file_buffer);
+    return NULL;
+  }
+
+  doc->file = file_buffer;
+  return doc;
+}
+
+void
+json_doc_close(
+  struct json_doc_t** doc)
+{
+  if (!*doc)
+    return;
+
+  if ((*doc)->file)
+  {
+    _json_release_file((*doc)->file);
+    free((*doc)->file);
+  }
+  free((*doc)->nodes);
+  free(*doc);
+  *doc = NULL;
+}
+
+struct json_cursor_t
+json_doc_root(
+  const struct json_doc_t* const doc)
+{
+  struct json_cursor_t cursor = {
+    .doc = doc,
+    .node = 0,
+    .key = SIZE_MAX,
+    .end = doc->n_nodes
+  };
+  return cursor;
+}
+
+static const struct _json_doc_node_t*
+_json_cursor_node(
+  const struct json_cursor_t* const cursor)
+{
+  return &cursor->doc->nodes[cursor->node];
+}
+
+static char
+_json_cursor_first_char(
+  const struct json_cursor_t* const cursor)
+{
+  return cursor->doc->input[_json_cursor_node(cursor)->start];
+}
+
+static bool
+_json_cursor_parse_number(
+  const struct json_cursor_t* const cursor,
+  enum json_type_e* const type,
+  union value* const value)
+{
+  const struct _json_doc_node_t* node = _json_cursor_node(cursor);
+  const char* const input = cursor->doc->input;
+  size_t len = 0;
+
+  // the whole extent found when indexing has to be one number
+  return _json_parse_number(&input[node->start], &input[node->end], type, value, &len)
+    && len == node->end - node->start;
+}
+
+enum json_type_e
+json_cursor_type(
+  const struct json_cursor_t* const cursor)
+{
+  switch (_json_cursor_first_char(cursor))
+  {
+    case '{':
+      return JSON_OBJECT;
+    case '[':
+      return JSON_ARRAY;
+    case '\"':
+      return JSON_STRING;
+    case 't':
+    case 'f':
+      return JSON_BOOL;
+    case 'n':
+      return JSON_NULL;
+  }
+
+  enum json_type_e type = JSON_NOTYPE;
+  union value value;
+  if (!_json_cursor_parse_number(cursor, &type, &value))
+    return JSON_NOTYPE;
+  return type;
+}
+
+bool
+json_cursor_first(
+  const struct json_cursor_t* const container,
+  struct json_cursor_t* const child)
+{
+  const char c = _json_cursor_first_char(container);
+  if (c != '{' && c != '[')
+    return false;
+
+  const size_t first = container->node + 1;
+  const size_t end = _json_cursor_node(container)->next;
+  if (first == end)
+    return false;
+
+  child->doc = container->doc;
+  child->end = end;
+  if (c == '{')
+  {
+    child->key = first;
+    child->node = first + 1;
+  }
+  else
+  {
+    child->key = SIZE_MAX;
+    child->node = first;
+  }
+  return true;
+}
+
+bool
+json_cursor_next(
+  struct json_cursor_t* const cursor)
+{
+  const size_t next = _json_cursor_node(cursor)->next;
+  if (next == cursor->end)
+    return false;
+
+  if (cursor->key != SIZE_MAX)
+  {
+    cursor->key = next;
+    cursor->node = next + 1;
+  }
+  else
+    cursor->node = next;
+  return true;
+}
+
+size_t
+json_cursor_len(
+  const struct json_cursor_t* const cursor)
+{
+  struct json_cursor_t child;
+  if (!json_cursor_first(cursor, &child))
+    return 0;
+
+  size_t len = 1;
+  while (json_cursor_next(&child))
+    len++;
+  return len;
+}
+
+bool
+json_cursor_key(
+  const struct json_cursor_t* const cursor,
+  const char** key,
+  size_t* len)
+{
+  if (cursor->key == SIZE_MAX)
+    return false;
+
+  // skip the quotes
+  const struct _json_doc_node_t* node = &cursor->doc->nodes[cursor->key];
+  *key = &cursor->doc->input[node->start + 1];
+  *len = node->end - node->start - 2;
+  return true;
+}
+
+bool
+json_cursor_find(
+  const struct json_cursor_t* const object,
+  const char* const key,
+  struct json_cursor_t* const value)
+{
+  if (_json_cursor_first_char(object) != '{')
+    return false;
+
+  struct json_cursor_t child;
+  if (!json_cursor_first(object, &child))
+    return false;
+
+  const size_t key_len = strlen(key);
+  do
+  {
+    const char* child_key = NULL;
+    size_t child_key_len = 0;
+    json_cursor_key(&child, &child_key, &child_key_len);
+    if (child_key_len == key_len && memcmp(child_key, key, key_len) == 0)
+    {
+      *value = child;
+      return true;
+    }
+  } while (json_cursor_next(&child));
+
+  return false;
+}
+
+bool
+json_cursor_at(
+  const struct json_cursor_t* const array,
+  const size_t index,
+  struct json_cursor_t* const value)
+{
+  if (_json_cursor_first_char(array) != '[')
+    return false;
+
+  struct json_cursor_t child;
+  if (!json_cursor_first(array, &child))
+    return false;
+
+  for (size_t i = 0; i < index; ++i)
+    if (!json_cursor_next(&child))
+      return false;
+
+  *value = child;
+  return true;
+}
+
+bool
+json_cursor_get_int32(
+  const struct json_cursor_t* const cursor,
+  int32_t* const value)
+{
+  enum json_type_e type = JSON_NOTYPE;
+  union value number;
+  if (!_json_cursor_parse_number(cursor, &type, &number) || type != JSON_INT32)
+    return false;
+
+  *value = number.int32;
+  return true;
+}
+
+bool
+json_cursor_get_decimal(
+  const struct json_cursor_t* const cursor,
+  double* const value)
+{
+  enum json_type_e type = JSON_NOTYPE;
+  union value number;
+  if (!_json_cursor_parse_number(cursor, &type, &number) || type != JSON_DECIMAL)
+    return false;
+
+  *value = number.decimal;
+  return true;
+}
+
+bool
+json_cursor_get_bool(
+  const struct json_cursor_t* const cursor,
+  bool* const value)
+{
+  const char c = _json_cursor_first_char(cursor);
+  if (c != 't' && c != 'f')
+    return false;
+
+  *value = c == 't';
+  return true;
+}
+
+bool
+json_cursor_is_null(
+  const struct json_cursor_t* const cursor)
+{
+  return _json_cursor_first_char(cursor) == 'n';
+}
+
+bool
+json_cursor_get_string(
+  const struct json_cursor_t* const cursor,
+  const char** str,
+  size_t* len)
+{
+  if (_json_cursor_first_char(cursor) != '\"')
+    return false;
+
+  const struct _json_doc_node_t* node = _json_cursor_node(cursor);
+  *str = &cursor->doc->input[node->start + 1];
+  *len = node->end - node->start - 2;
+  return true;
+}
+
+char*
+json_cursor_dup_string(
+  const struct json_cursor_t* const cursor)
+{
+  const char* str = NULL;
+  size_t len = 0;
+  if (!json_cursor_get_string(cursor, &str, &len))
+    return NULL;
+
+  char* copy = malloc(len + 1);
+  if (!copy)
+    return NULL;
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+struct json_t*
+json_cursor_get_object(
+  const struct json_cursor_t* const cursor,
+  struct json_arena_t* const arena)
+{
+  if (_json_cursor_first_char(cursor) != '{')
+    return NULL;
+
+  const struct _json_doc_node_t* node = _json_cursor_node(cursor);
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+  return json_parse_with_options(&cursor->doc->input[node->start], node->end - node->start, &options);
+}
+
+struct json_array_t*
+json_cursor_get_array(
+  const struct json_cursor_t* const cursor,
+  struct json_arena_t* const arena)
+{
+  if (_json_cursor_first_char(cursor) != '[')
+    return NULL;
+
+  const struct _json_doc_node_t* node = _json_cursor_node(cursor);
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+  return json_parse_array_with_options(&cursor->doc->input[node->start], node->end - node->start, &options);
+}
@@ -8,7 +8,7 @@ json_get(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
 
@@ -21,7 +21,7 @@ json_get_int32(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return &json->items[idx].value.int32;
@@ -33,7 +33,7 @@ json_get_decimal(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return &json->items[idx].value.decimal;
@@ -45,7 +45,7 @@ json_get_string(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return json->items[idx].value.str;
@@ -57,7 +57,7 @@ json_get_object(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return json->items[idx].value.object;
@@ -69,7 +69,7 @@ json_get_array(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return json->items[idx].value.array;
@@ -81,7 +81,7 @@ json_get_bool(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return NULL;
   return &json->items[idx].value.boolean;
@@ -93,7 +93,7 @@ json_get_isnull(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return true; // technically...if it doesn't exist I guess it's null...
   return json->items[idx].type == JSON_NULL;
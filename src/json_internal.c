@@ -1,53 +1,138 @@
+// make sure off_t/st_size can describe files over 2 GB on 32-bit systems
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include "json.h"
 #include "json_array.h"
 #include "json_internal.h"
 
-enum _token_e
-_json_get_token_type(
-  const char current_char)
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const struct json_parse_options_t _json_default_parse_options = {
+  .flags = JSON_PARSE_DEFAULT,
+  .arena = NULL,
+  .key_pool = NULL
+};
+
+// byte -> token class for the parser's main loop. anything not listed
+// (control characters, non-ASCII bytes) is JSON_CLASS_UNKNOWN
+const uint8_t _json_token_classes[256] =
 {
-  switch (current_char)
-  {
-    case '{':
-      return OPEN_BODY;
-    case '}':
-      return CLOSE_BODY;
-    case '\"':
-      return QUOTE;
-    case ',':
-      return COMMA;
-    case ':':
-      return COLON;
-    case ' ':
-      return SPACE;
-    case '[':
-      return OPEN_ARRAY;
-    case ']':
-      return CLOSE_ARRAY;
-  }
-
-  // conditions that can't be put into switch:
-
-  // NOTE: this condition must come first otherwise '.' will
-  // be interpreted as TEXT type
-  if (isdigit(current_char) || current_char == '.' || current_char == '-')
-      return NUMERIC;
-
-  if  (  isalpha(current_char) 
-      || ispunct(current_char) 
-      || current_char == ' '
-      || current_char == '\n' 
-      || current_char == '\t' 
-      || current_char == '\r')
-      return TEXT;
-
-  return UNKNOWN;
-}
+  ['{'] = JSON_CLASS_OPEN_BODY,
+  ['}'] = JSON_CLASS_CLOSE_BODY,
+  ['"'] = JSON_CLASS_QUOTE,
+  [','] = JSON_CLASS_COMMA,
+  [':'] = JSON_CLASS_COLON,
+  ['['] = JSON_CLASS_OPEN_ARRAY,
+  [']'] = JSON_CLASS_CLOSE_ARRAY,
+  // whitespace is skipped before tokens are classified, so these never
+  // actually reach the FSM
+  [' '] = JSON_CLASS_SPACE, ['\t'] = JSON_CLASS_SPACE,
+  ['\n'] = JSON_CLASS_SPACE, ['\r'] = JSON_CLASS_SPACE,
+  // digits, '.' and '-' begin numbers
+  ['0'] = JSON_CLASS_NUMERIC, ['1'] = JSON_CLASS_NUMERIC,
+  ['2'] = JSON_CLASS_NUMERIC, ['3'] = JSON_CLASS_NUMERIC,
+  ['4'] = JSON_CLASS_NUMERIC, ['5'] = JSON_CLASS_NUMERIC,
+  ['6'] = JSON_CLASS_NUMERIC, ['7'] = JSON_CLASS_NUMERIC,
+  ['8'] = JSON_CLASS_NUMERIC, ['9'] = JSON_CLASS_NUMERIC,
+  ['.'] = JSON_CLASS_NUMERIC, ['-'] = JSON_CLASS_NUMERIC,
+  // letters and the remaining punctuation begin literals, which are
+  // checked when they're parsed
+  ['A'] = JSON_CLASS_TEXT, ['B'] = JSON_CLASS_TEXT, ['C'] = JSON_CLASS_TEXT,
+  ['D'] = JSON_CLASS_TEXT, ['E'] = JSON_CLASS_TEXT, ['F'] = JSON_CLASS_TEXT,
+  ['G'] = JSON_CLASS_TEXT, ['H'] = JSON_CLASS_TEXT, ['I'] = JSON_CLASS_TEXT,
+  ['J'] = JSON_CLASS_TEXT, ['K'] = JSON_CLASS_TEXT, ['L'] = JSON_CLASS_TEXT,
+  ['M'] = JSON_CLASS_TEXT, ['N'] = JSON_CLASS_TEXT, ['O'] = JSON_CLASS_TEXT,
+  ['P'] = JSON_CLASS_TEXT, ['Q'] = JSON_CLASS_TEXT, ['R'] = JSON_CLASS_TEXT,
+  ['S'] = JSON_CLASS_TEXT, ['T'] = JSON_CLASS_TEXT, ['U'] = JSON_CLASS_TEXT,
+  ['V'] = JSON_CLASS_TEXT, ['W'] = JSON_CLASS_TEXT, ['X'] = JSON_CLASS_TEXT,
+  ['Y'] = JSON_CLASS_TEXT, ['Z'] = JSON_CLASS_TEXT, ['a'] = JSON_CLASS_TEXT,
+  ['b'] = JSON_CLASS_TEXT, ['c'] = JSON_CLASS_TEXT, ['d'] = JSON_CLASS_TEXT,
+  ['e'] = JSON_CLASS_TEXT, ['f'] = JSON_CLASS_TEXT, ['g'] = JSON_CLASS_TEXT,
+  ['h'] = JSON_CLASS_TEXT, ['i'] = JSON_CLASS_TEXT, ['j'] = JSON_CLASS_TEXT,
+  ['k'] = JSON_CLASS_TEXT, ['l'] = JSON_CLASS_TEXT, ['m'] = JSON_CLASS_TEXT,
+  ['n'] = JSON_CLASS_TEXT, ['o'] = JSON_CLASS_TEXT, ['p'] = JSON_CLASS_TEXT,
+  ['q'] = JSON_CLASS_TEXT, ['r'] = JSON_CLASS_TEXT, ['s'] = JSON_CLASS_TEXT,
+  ['t'] = JSON_CLASS_TEXT, ['u'] = JSON_CLASS_TEXT, ['v'] = JSON_CLASS_TEXT,
+  ['w'] = JSON_CLASS_TEXT, ['x'] = JSON_CLASS_TEXT, ['y'] = JSON_CLASS_TEXT,
+  ['z'] = JSON_CLASS_TEXT, ['!'] = JSON_CLASS_TEXT, ['#'] = JSON_CLASS_TEXT,
+  ['$'] = JSON_CLASS_TEXT, ['%'] = JSON_CLASS_TEXT, ['&'] = JSON_CLASS_TEXT,
+  ['\''] = JSON_CLASS_TEXT, ['('] = JSON_CLASS_TEXT, [')'] = JSON_CLASS_TEXT,
+  ['*'] = JSON_CLASS_TEXT, ['+'] = JSON_CLASS_TEXT, ['/'] = JSON_CLASS_TEXT,
+  [';'] = JSON_CLASS_TEXT, ['<'] = JSON_CLASS_TEXT, ['='] = JSON_CLASS_TEXT,
+  ['>'] = JSON_CLASS_TEXT, ['?'] = JSON_CLASS_TEXT, ['@'] = JSON_CLASS_TEXT,
+  ['\\'] = JSON_CLASS_TEXT, ['^'] = JSON_CLASS_TEXT, ['_'] = JSON_CLASS_TEXT,
+  ['`'] = JSON_CLASS_TEXT, ['|'] = JSON_CLASS_TEXT, ['~'] = JSON_CLASS_TEXT,
+};
+
+const uint16_t _json_token_class_masks[JSON_N_TOKEN_CLASSES] =
+{
+  [JSON_CLASS_UNKNOWN] = UNKNOWN,
+  [JSON_CLASS_OPEN_BODY] = OPEN_BODY,
+  [JSON_CLASS_CLOSE_BODY] = CLOSE_BODY,
+  [JSON_CLASS_QUOTE] = QUOTE,
+  [JSON_CLASS_COMMA] = COMMA,
+  [JSON_CLASS_COLON] = COLON,
+  [JSON_CLASS_TEXT] = TEXT,
+  [JSON_CLASS_NUMERIC] = NUMERIC,
+  [JSON_CLASS_SPACE] = SPACE,
+  [JSON_CLASS_OPEN_ARRAY] = OPEN_ARRAY,
+  [JSON_CLASS_CLOSE_ARRAY] = CLOSE_ARRAY,
+};
+
+// any token that can begin a value
+#define JSON_VALUE_TOKENS (QUOTE | NUMERIC | TEXT | OPEN_BODY | OPEN_ARRAY)
+
+// the same successors regardless of container or whether a key is being parsed
+#define JSON_ANY_CONTAINER(tokens) { \
+  [JSON_NOTYPE] = { tokens, tokens }, \
+  [JSON_OBJECT] = { tokens, tokens }, \
+  [JSON_ARRAY] = { tokens, tokens } }
+
+// successors of a complete value: the next element or the end of the
+// enclosing container. nothing may follow once the root is closed
+#define JSON_AFTER_VALUE { \
+  [JSON_OBJECT] = { COMMA | CLOSE_BODY, COMMA | CLOSE_BODY }, \
+  [JSON_ARRAY] = { COMMA | CLOSE_ARRAY, COMMA | CLOSE_ARRAY } }
+
+// [token just read][container it left us in][parsing_key] -> the tokens
+// allowed next. classes missing here (SPACE, UNKNOWN) allow nothing
+const uint16_t _json_token_transitions[JSON_N_TOKEN_CLASSES][JSON_NULL + 1][2] =
+{
+  [JSON_CLASS_OPEN_BODY] = JSON_ANY_CONTAINER(QUOTE | CLOSE_BODY),
+  [JSON_CLASS_OPEN_ARRAY] = JSON_ANY_CONTAINER(JSON_VALUE_TOKENS | CLOSE_ARRAY),
+  [JSON_CLASS_COLON] = JSON_ANY_CONTAINER(JSON_VALUE_TOKENS),
+  [JSON_CLASS_COMMA] = {
+    [JSON_NOTYPE] = { JSON_VALUE_TOKENS, JSON_VALUE_TOKENS },
+    [JSON_OBJECT] = { QUOTE, QUOTE },
+    [JSON_ARRAY] = { JSON_VALUE_TOKENS, JSON_VALUE_TOKENS } },
+  // a closing quote ends either a key or a string value
+  [JSON_CLASS_QUOTE] = {
+    [JSON_NOTYPE] = { NONE, COLON },
+    [JSON_OBJECT] = { COMMA | CLOSE_BODY, COLON },
+    [JSON_ARRAY] = { COMMA | CLOSE_ARRAY, COLON } },
+  [JSON_CLASS_NUMERIC] = JSON_AFTER_VALUE,
+  [JSON_CLASS_TEXT] = JSON_AFTER_VALUE,
+  [JSON_CLASS_CLOSE_BODY] = JSON_AFTER_VALUE,
+  [JSON_CLASS_CLOSE_ARRAY] = JSON_AFTER_VALUE,
+};
+
+#undef JSON_VALUE_TOKENS
+#undef JSON_ANY_CONTAINER
+#undef JSON_AFTER_VALUE
 
 size_t
 _json_get_key_index(
   const struct json_t* const json,
   const char* const key,
+  const size_t key_len,
   bool* key_exists)
 {
   if (!json)
@@ -56,11 +141,49 @@ _json_get_key_index(
     return 0;
   }
 
+  // every key in a pooled object is interned, so a key that isn't in
+  // the pool can't be in the object either. small objects are still
+  // cheaper to scan than looking the key up in the pool first
+  if (json->key_pool && json->key_index)
+  {
+    const char* interned = _json_key_pool_find(json->key_pool, key, key_len);
+    if (!interned)
+    {
+      *key_exists = false;
+      return 0;
+    }
+    return _json_get_interned_key_index(json, interned, key_exists);
+  }
+
+  // large objects have a hash index, small ones are cheaper to just scan
+  if (json->key_index)
+  {
+    size_t mask = json->key_index_capacity - 1;
+    size_t slot = _json_hash_key(key, key_len) & mask;
+
+    // slots hold item index + 1 so that 0 can mean empty
+    while (json->key_index[slot] != 0)
+    {
+      size_t i = json->key_index[slot] - 1;
+      if (json->items[i].key_len == key_len
+          && memcmp(json->items[i].key, key, key_len) == 0)
+      {
+        *key_exists = true;
+        return i;
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    *key_exists = false;
+    return 0;
+  }
+
   for (size_t i = 0; i < json->n_items; ++i)
   {
     struct json_item_t* current_item = &json->items[i];
 
-    if (strncmp(current_item->key, key, JSON_MAX_KEY_LEN) == 0)
+    if (current_item->key_len == key_len
+        && memcmp(current_item->key, key, key_len) == 0)
     {
       *key_exists = true;
       return i;
@@ -71,728 +194,617 @@ _json_get_key_index(
   return 0;
 }
 
-uint16_t 
-_json_get_next_expected_token(
-  const enum _token_e current_token,
-  const bool inside_quotes)
+// interned keys are hashed by address, which is unique per key
+static size_t
+_json_hash_interned_key(
+  const char* const key)
 {
-  // if we're inside quotes, we can really be next to ANY token
-  if (inside_quotes || current_token == SPACE)
-    return TEXT | NUMERIC | QUOTE | COMMA | OPEN_BODY | CLOSE_BODY | COLON | SPACE;
+  uint64_t hash = (uint64_t)(uintptr_t)key;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+  return (size_t)hash;
+}
 
-  switch (current_token)
+size_t
+_json_get_interned_key_index(
+  const struct json_t* const json,
+  const char* const key,
+  bool* key_exists)
+{
+  if (json->key_index)
   {
-    case OPEN_BODY:
-      return QUOTE | CLOSE_BODY;
-
-    case CLOSE_BODY:
-      return CLOSE_BODY | NONE;
-
-    case OPEN_ARRAY:
-      return QUOTE | NUMERIC | OPEN_ARRAY;
-
-    case CLOSE_ARRAY:
-      return COMMA | CLOSE_BODY | CLOSE_ARRAY;
+    size_t mask = json->key_index_capacity - 1;
+    size_t slot = _json_hash_interned_key(key) & mask;
 
-    case QUOTE:
-      return QUOTE | TEXT | COLON | CLOSE_BODY | COMMA;
-
-    case COLON:
-      return QUOTE | TEXT | NUMERIC | OPEN_BODY | OPEN_ARRAY;
-
-    case COMMA:
-      return TEXT | QUOTE | OPEN_BODY | OPEN_ARRAY;
+    while (json->key_index[slot] != 0)
+    {
+      size_t i = json->key_index[slot] - 1;
+      if (json->items[i].key == key)
+      {
+        *key_exists = true;
+        return i;
+      }
+      slot = (slot + 1) & mask;
+    }
 
-    case TEXT:
-      return TEXT | COMMA | CLOSE_BODY | CLOSE_ARRAY;
+    *key_exists = false;
+    return 0;
+  }
 
-    case NUMERIC:
-      return NUMERIC | TEXT | COMMA | CLOSE_BODY;
-    
-    case NONE:
-    case UNKNOWN:
-      return NONE;
-    case SPACE: // already handled before switch
-      break;
+  for (size_t i = 0; i < json->n_items; ++i)
+  {
+    if (json->items[i].key == key)
+    {
+      *key_exists = true;
+      return i;
+    }
   }
 
-  return NONE;
+  *key_exists = false;
+  return 0;
 }
 
-// general cleanup to do when parsing an array item.
-// consumes any trailing whitespace and ensures no missing
-// delimiters/closure
-// e.g., to prevent things like [a b c] instead of [a, b, c]
 bool
-_json_array_item_cleanup(
-  const char* const array_string,
-  size_t* idx,
-  const size_t len)
+_json_check_key_exists(
+  const struct json_t* const json,
+  const char* const search_key,
+  const size_t search_key_len)
 {
-  // consume any trailing whitespace
-  while (*idx < len && isspace(array_string[*idx]))
-    (*idx)++;
-  // double check we don't have a missing delimiter
-  // e.g., to prevent things like [a b c] instead of [a, b, c]
-  if (*idx < len - 1 
-      && array_string[*idx] != ','
-      && array_string[*idx] != ']')
-    return false;
-
-  return true;
+  bool key_exists = false;
+  _json_get_key_index(json, search_key, search_key_len, &key_exists);
+  return key_exists;
 }
 
-char*
-_json_fetch_body_string(
-  const char* const json_string,
-  size_t* idx)
+// FNV-1a
+size_t
+_json_hash_key(
+  const char* const key,
+  const size_t key_len)
 {
-  int32_t body_count = 0;
-  size_t start_idx = *idx;
-  size_t len = strlen(json_string);
-  for (; *idx < len; ++(*idx))
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < key_len; ++i)
   {
-    switch (json_string[*idx])
-    {
-      case '{':
-        body_count++;
-        break;
-
-      case '}':
-        body_count--;
-        break;
-    }
-
-    if (body_count < 0)
-      return NULL;
-
-    if (body_count == 0)
-    {
-      size_t substr_len = *idx - start_idx + 2;
-      char* body_string = calloc(substr_len, sizeof(char));
-      if (!body_string)
-        return NULL;
-      strncat(body_string, &json_string[start_idx], substr_len - 1);
-      (*idx)++; // move past close brace }
-
-      if (!_json_array_item_cleanup(json_string, idx, len))
-      {
-        free(body_string);
-        return NULL;
-      }
-
-      return body_string;
-    }
+    hash ^= (unsigned char)key[i];
+    hash *= 0x100000001b3;
   }
 
-  return NULL;
+  return (size_t)hash;
 }
 
-char*
-_json_fetch_array_string(
-  const char* const json_string,
-  size_t* idx)
+static void
+_json_insert_key_index(
+  const struct json_t* const json,
+  size_t* key_index,
+  const size_t key_index_capacity,
+  const size_t item_idx)
 {
-  int32_t body_count = 0;
-  size_t start_idx = *idx;
-  size_t len = strlen(json_string);
-  for (; *idx < len; ++(*idx))
-  {
-    switch (json_string[*idx])
-    {
-      case '[':
-        body_count++;
-        break;
+  const struct json_item_t* const item = &json->items[item_idx];
+  size_t hash = json->key_pool
+    ? _json_hash_interned_key(item->key)
+    : _json_hash_key(item->key, item->key_len);
+
+  size_t mask = key_index_capacity - 1;
+  size_t slot = hash & mask;
+  while (key_index[slot] != 0)
+    slot = (slot + 1) & mask;
+  key_index[slot] = item_idx + 1;
+}
 
-      case ']':
-        body_count--;
-        break;
-    }
+// called after an item is added to keep the hash index in sync.
+// the index is only built once an object reaches JSON_KEY_INDEX_THRESHOLD
+// items and is rebuilt at double the size whenever it's half full.
+// it's purely an optimization, so if it can't be allocated the object
+// just goes back to linear scans
+void
+_json_update_key_index(
+  struct json_t* const json)
+{
+  if (json->n_items < JSON_KEY_INDEX_THRESHOLD)
+    return;
 
-    if (body_count < 0)
-      return NULL;
+  size_t item_idx = json->n_items - 1;
+  if (json->key_index && json->n_items * 2 <= json->key_index_capacity)
+  {
+    _json_insert_key_index(json, json->key_index, json->key_index_capacity, item_idx);
+    return;
+  }
 
-    if (body_count == 0)
-    {
-      size_t substr_len = *idx - start_idx + 2;
-      char* body_string = calloc(substr_len, sizeof(char));
-      if (!body_string)
-        return NULL;
-      strncat(body_string, &json_string[start_idx], substr_len - 1);
-      (*idx)++; // move past close bracket ]
-
-      if (!_json_array_item_cleanup(json_string, idx, len))
-      {
-        free(body_string);
-        return NULL;
-      }
-    
-      return body_string;
-    }
+  size_t new_capacity = 16;
+  while (new_capacity < json->n_items * 4)
+    new_capacity *= 2;
+
+  _json_release(json->arena, json->key_index);
+  json->key_index = _json_alloc(json->arena, new_capacity * sizeof(*json->key_index));
+  if (!json->key_index)
+  {
+    json->key_index_capacity = 0;
+    return;
   }
+  memset(json->key_index, 0, new_capacity * sizeof(*json->key_index));
 
-  return NULL;
+  json->key_index_capacity = new_capacity;
+  for (size_t i = 0; i < json->n_items; ++i)
+    _json_insert_key_index(json, json->key_index, new_capacity, i);
 }
 
 void
-_json_reset_parse_info(
+_json_skip_whitespace(
   struct _json_parse_info_t* const parse_info)
 {
-  // this is called after comma, so we start parsing the next key
-  memset(parse_info->parsed_key, 0, JSON_MAX_KEY_LEN);
-  memset(parse_info->parsed_value, 0, parse_info->parsed_value_len);
-  parse_info->parsed_value_len = 0; // keep the capacity as is, no point to realloc
-  parse_info->parsing_key = true;
-  parse_info->parsing_value = false;
-  parse_info->inside_quotes = false;
-  parse_info->parsed_value_type = JSON_NOTYPE;
-  parse_info->expecting_delimiter = false;
+  parse_info->json_string_idx = _json_find_non_whitespace(
+    parse_info->json_string,
+    parse_info->json_string_idx,
+    parse_info->json_string_len);
 }
 
-char* 
-_json_fetch_quote_string(
-  const char* const array_string,
-  size_t* idx)
+bool
+_json_advance_to_token(
+  struct _json_parse_info_t* const parse_info)
 {
-  *idx += 1; // move index past initial open quote
-  size_t start_idx = *idx;
-  size_t len = strlen(array_string);
-  for (; *idx < len; ++(*idx))
+  struct _json_structural_index_t* const index = parse_info->structural_index;
+  if (!index)
   {
-    if (array_string[*idx] == '\"')
-    {
-      size_t substr_len = *idx - start_idx;
-      char* substr = calloc(substr_len + 1, sizeof(char));
-      if (!substr)
-        return NULL;
-      strncat(substr, &array_string[start_idx], substr_len);
-      (*idx)++; // move past closing quote
-
-      if (!_json_array_item_cleanup(array_string, idx, len))
-      {
-        free(substr);
-        return NULL;
-      }
-      
-      return substr;
-    }
+    _json_skip_whitespace(parse_info);
+    return true;
   }
 
-  return NULL;
-}
-
-char* 
-_json_fetch_numeric_string(
-  const char* const array_string,
-  size_t* idx,
-  bool* contains_decimal)
-{
-  size_t start_idx = *idx;
-  size_t len = strlen(array_string);
-  size_t space_count = 0;
-  for (; *idx < len; ++(*idx))
-  {
-    // whitespace prohibited in numerics
-    // but we have to wait until we read the entire value
-    // before determining if it's illegal or not
-    if (isspace(array_string[*idx]))
-      space_count++;
-
-    if (!isdigit(array_string[*idx])
-        && !isspace(array_string[*idx])
-        && array_string[*idx] != '-'
-        && array_string[*idx] != '.'
-        && array_string[*idx] != ','
-        && array_string[*idx] != ']'
-        && array_string[*idx] != '}')
-      return NULL;
-
-    if (array_string[*idx] == '.')
-      *contains_decimal = true;
-
-    if (array_string[*idx] == ',' 
-        || array_string[*idx] == ']'
-        || array_string[*idx] == '}')
-    {
-      // ignore any trailing whitespace before closing token. e.g.,
-      // { "key": 10    } <-- this whitespace is ok
-      // { "key": 1 0   } <-- this whitespace is NOT ok
-      // basically we iterate backwards again until finding a non-space token
-      size_t reverse_idx = *idx - 1;
-      while (isspace(array_string[reverse_idx]))
-      {
-        space_count--;
-        reverse_idx--;
-      }
-
-      if (space_count > 0)
-        return NULL;
-
-      size_t substr_len = *idx - start_idx;
-      char* substr = calloc(substr_len + 1, sizeof(char));
-
-      if (!substr)
-        return NULL;
-      strncat(substr, &array_string[start_idx], substr_len);
-      
-      if (!_json_array_item_cleanup(array_string, idx, len))
-      {
-        free(substr);
-        return NULL;
-      }
+  size_t position = parse_info->json_string_len;
+  _json_structural_index_next(index, &position);
 
-      return substr;
-    }
-  }
+  // anything after the last token that isn't whitespace is glued onto it
+  // (e.g., the x in 12x) and was never indexed on its own. whitespace
+  // always ends that run, and whatever follows it is indexed, so checking
+  // the first byte is enough
+  size_t idx = parse_info->json_string_idx;
+  if (position < idx
+      || (position > idx && !_json_is_whitespace(parse_info->json_string[idx])))
+    return false;
 
-  return NULL;
+  parse_info->json_string_idx = position;
+  return true;
 }
 
-char*
-_json_fetch_array_item_string(
-  const char* const array_string,
-  size_t* idx,
-  bool* contains_decimal)
+// finds the bounds of the string starting at the current (open) quote
+// and moves the index past the closing quote. the contents are kept
+// as-is, but an escaped quote (\") doesn't terminate the string
+bool
+_json_scan_quote_string(
+  struct _json_parse_info_t* const parse_info,
+  size_t* start_idx,
+  size_t* len)
 {
-  size_t start_idx = *idx;
-  size_t len = strlen(array_string);
+  const char* const json_string = parse_info->json_string;
+  const size_t json_string_len = parse_info->json_string_len;
+  size_t idx = parse_info->json_string_idx + 1; // move past open quote
+  *start_idx = idx;
 
-  // ignore any initial whitespace
-  for (size_t i = start_idx; i < len; ++i)
+  for (;;)
   {
-    if (isspace(array_string[i]))
-      start_idx++;
-    else
+    idx = _json_find_quote_or_backslash(json_string, idx, json_string_len);
+    if (idx >= json_string_len || json_string[idx] == '\"')
       break;
+    // skip whatever is escaped
+    idx += 2;
   }
-  *idx = start_idx;
-
-  if (array_string[start_idx] == '{')
-    return _json_fetch_body_string(array_string, idx);
-  
-  if (array_string[start_idx] == '[')
-    return _json_fetch_array_string(array_string, idx);
 
-  if (array_string[start_idx] == '\"')
-    return _json_fetch_quote_string(array_string, idx);
+  if (idx >= json_string_len)
+    return false;
 
-  if (array_string[start_idx] == '.' 
-      || array_string[start_idx] == '-'
-      || (array_string[start_idx] >= '0' && array_string[start_idx] <= '9'))
-      return _json_fetch_numeric_string(array_string, idx, contains_decimal);
+  *len = idx - *start_idx;
+  // the string was just scanned, so it's still in cache
+  if ((parse_info->flags & JSON_PARSE_VALIDATE_UTF8)
+      && !_json_validate_utf8(&json_string[*start_idx], *len))
+    return false;
 
-  for (; *idx < len; ++(*idx))
-    if (array_string[*idx] == ',' || array_string[*idx] == ']')
-      break;
+  parse_info->json_string_idx = idx + 1; // move past closing quote
+  return true;
+}
 
-  size_t size = *idx - start_idx;
-  char* item_string = calloc(size + 1, sizeof(char));
-  if (!item_string)
+// the pool's copy of the last parsed key, going through the parse's
+// cache of recently interned keys first
+static const char*
+_json_intern_parsed_key(
+  struct _json_parse_info_t* const parse_info)
+{
+  const char* const key = parse_info->parsed_key;
+  const size_t key_len = parse_info->parsed_key_len;
+  if (key_len == 0)
     return NULL;
 
-  strncat(item_string, &array_string[start_idx], size);
-  return item_string;
-}
+  // cheap enough to not be worth hashing the whole key for
+  size_t slot = (key_len * 31 + (unsigned char)key[0] * 7 + (unsigned char)key[key_len - 1])
+    & (JSON_KEY_CACHE_SIZE - 1);
+  struct _json_key_cache_entry_t* entry = &parse_info->key_cache[slot];
+  if (entry->key && entry->len == key_len && memcmp(entry->key, key, key_len) == 0)
+    return entry->key;
 
-enum json_type_e
-_json_get_item_type(
-  const char* const item_string)
-{
-  // ignore first set of whitespace (if any)
-  size_t idx = 0;
-  size_t len = strlen(item_string);
-  for (size_t i = 0; i < len; ++i)
+  const char* interned = _json_key_pool_intern(parse_info->key_pool, key, key_len);
+  if (interned)
   {
-    if (isspace(item_string[i]))
-      idx++;
-    else
-      break;
+    entry->key = interned;
+    entry->len = key_len;
   }
+  return interned;
+}
 
-  // type will be updated to DECIMAL later if one is found while parsing
-  if (item_string[idx] == '-' || (item_string[idx] >= '0' && item_string[idx] <= '9'))
-    return JSON_INT32;
-
-  if (item_string[idx] == '[')
-    return JSON_ARRAY;
-
-  if (item_string[idx] == '{')
-    return JSON_OBJECT;
-
-  // spcial cases not to be confused with JSON_STRING
+// adds a freshly parsed value to whatever container is currently open,
+// using the last parsed key if that container is an object
+bool
+_json_attach_value(
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  void* value)
+{
+  struct _json_parse_frame_t* frame = &parse_info->stack[parse_info->stack_len - 1];
 
-  if (strcmp(item_string, "null") == 0)
-    return JSON_NULL;
+  if (frame->type == JSON_OBJECT && parse_info->key_pool)
+  {
+    const char* key = _json_intern_parsed_key(parse_info);
+    return key && _json_add_interned_item(frame->container, type, key, parse_info->parsed_key_len, value);
+  }
 
-  if (strcmp(item_string, "true") == 0
-      || strcmp(item_string, "false") == 0)
-    return JSON_BOOL;
+  if (frame->type == JSON_OBJECT)
+    return _json_add_item(
+      frame->container,
+      type,
+      parse_info->parsed_key,
+      parse_info->parsed_key_len,
+      value);
 
-  return JSON_STRING;
+  return _json_array_append_item(frame->container, type, value);
 }
 
 bool
-_json_check_key_exists(
-  const struct json_t* const json,
-  const char* const search_key)
+_json_push_container(
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  void* container)
 {
-  for (size_t i = 0; i < json->n_items; ++i)
-    if (strncmp(json->items[i].key, search_key, JSON_MAX_KEY_LEN) == 0)
-      return true;
+  if (parse_info->stack_len == parse_info->stack_capacity)
+  {
+    size_t new_capacity = parse_info->stack_capacity * 2;
+    void* alloc = realloc(parse_info->stack, new_capacity * sizeof(*parse_info->stack));
+    if (!alloc)
+      return false;
+    parse_info->stack = alloc;
+    parse_info->stack_capacity = new_capacity;
+  }
 
-  return false;
+  parse_info->stack[parse_info->stack_len].type = type;
+  parse_info->stack[parse_info->stack_len].container = container;
+  parse_info->stack_len++;
+  return true;
 }
 
-// an internal version of add_item to perform type casting
-bool 
-_json_add_item(
-  struct json_t* const json,
-  struct _json_parse_info_t* const parse_info)
+static bool
+_json_tree_open(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  const size_t start,
+  void** container)
 {
-  // initially these special cases have JSON_NOTYPE,
-  // so we check them here after extracting their values
-  if (parse_info->parsed_value_type == JSON_NOTYPE)
-  {
-    if (strcmp(parse_info->parsed_value, "null") == 0)
-      parse_info->parsed_value_type = JSON_NULL;
+  (void)start;
+  void** root = ctx;
 
-    else if (strcmp(parse_info->parsed_value, "true") == 0
-            || strcmp(parse_info->parsed_value, "false") == 0)
-      parse_info->parsed_value_type = JSON_BOOL;
-    else
-      return false;
+  // the caller may have created the root already
+  if (parse_info->stack_len == 0 && *root)
+  {
+    *container = *root;
+    return true;
   }
 
-  bool success = false;
-  switch (parse_info->parsed_value_type)
+  if (type == JSON_OBJECT)
   {
+    struct json_t* json = json_create_arena(parse_info->arena);
+    if (json)
+      json->key_pool = parse_info->key_pool;
+    *container = json;
+  }
+  else
+    *container = json_array_create_arena(parse_info->arena);
 
-    case JSON_OBJECT:
-    {
-      char* nested_json_string 
-        = _json_fetch_body_string(
-            parse_info->json_string, 
-            &parse_info->json_string_idx);
-
-      if (!nested_json_string)
-        return false;
-
-      struct json_t* nested_json = json_parse_from_string(nested_json_string);
-      if (!nested_json)
-      {
-        free(nested_json_string);
-        return false;
-      }
-
-      success = json_add_item(json, JSON_OBJECT, parse_info->parsed_key, nested_json);
-
-      free(nested_json_string);
-      break;
-    }
-
-    case JSON_ARRAY:
-    {
-      char* array_string
-        = _json_fetch_array_string(
-            parse_info->json_string,
-            &parse_info->json_string_idx);
-
-      if (!array_string)
-        return false;
-
-      struct json_array_t* json_array = json_parse_array_from_string(array_string);
-      if (!json_array)
-      {
-        free(array_string);
-        return false;
-      }
-
-      success = json_add_item(json, JSON_ARRAY, parse_info->parsed_key, json_array);
-
-      free(array_string);
-      break;
-    }
-
-    case JSON_STRING:
-    {
-      char* quote_string = _json_fetch_quote_string(parse_info->json_string, &parse_info->json_string_idx);
+  if (!*container)
+    return false;
 
-      if (!quote_string)
-        return false;
-      success = json_add_item(json, JSON_STRING, parse_info->parsed_key, quote_string);
-      break;
-    }
+  if (parse_info->stack_len == 0)
+  {
+    *root = *container;
+    return true;
+  }
 
-    case JSON_DECIMAL:
-    {
-      char* endptr = NULL;
-      double cast_value = strtod(parse_info->parsed_value, &endptr);
-      success = json_add_item(json, JSON_DECIMAL, parse_info->parsed_key, &cast_value);
-      break;
-    }
+  // once attached, the container is owned by its parent and will be
+  // cleaned up with it if anything fails later on
+  if (!_json_attach_value(parse_info, type, *container))
+  {
+    if (type == JSON_OBJECT)
+      json_free((struct json_t**)container);
+    else
+      json_array_free((struct json_array_t**)container);
+    return false;
+  }
 
-    case JSON_INT32:
-    {
-      char* endptr = NULL;
-      int32_t cast_value = strtol(parse_info->parsed_value, &endptr, 10);
-      success = json_add_item(json, JSON_INT32, parse_info->parsed_key, &cast_value);
-      break;
-    }
+  return true;
+}
 
-    case JSON_BOOL:
-    {
-      bool value = false;
-      if (strcmp(parse_info->parsed_value, "true") == 0)
-        value = true;
-      else if (strcmp(parse_info->parsed_value, "false") != 0)
-        return false;
+static bool
+_json_tree_value(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  union value* const value,
+  const size_t start,
+  const size_t len)
+{
+  (void)ctx;
 
-      success = json_add_item(json, JSON_BOOL, parse_info->parsed_key, &value);
-      break;
-    }
+  if (type != JSON_STRING)
+    return _json_attach_value(parse_info, type, value);
 
-    case JSON_NULL:
-    {
-      bool value = true;
-      success = json_add_item(json, JSON_NULL, parse_info->parsed_key, &value);
-      break;
-    }
+  char* str = _json_alloc(parse_info->arena, len + 1);
+  if (!str)
+    return false;
+  memcpy(str, &parse_info->json_string[start], len);
+  str[len] = '\0';
 
-    case JSON_NOTYPE:
-      break;
+  if (!_json_attach_value(parse_info, JSON_STRING, str))
+  {
+    _json_release(parse_info->arena, str);
+    return false;
   }
 
-  _json_reset_parse_info(parse_info);
-
-  return success;
+  return true;
 }
 
-void
-_json_append_char_to_key(
-  struct _json_parse_info_t* const parse_info,
-  const char current_char)
-{
-  size_t key_len = strlen(parse_info->parsed_key);
-  if (key_len == JSON_MAX_KEY_LEN - 1)
-    return;
-  parse_info->parsed_key[key_len] = current_char;
-}
+const struct _json_token_handler_t _json_tree_handler = {
+  .open = _json_tree_open,
+  .close = NULL,
+  .key = NULL,
+  .value = _json_tree_value,
+  .defer_numbers = false
+};
 
-bool 
-_json_append_char_to_value(
-  struct _json_parse_info_t* const parse_info,
-  const char current_char)
+size_t
+_json_scan_literal(
+  const char* const start,
+  const size_t max_len,
+  enum json_type_e* const type,
+  bool* const value)
 {
-  parse_info->parsed_value[parse_info->parsed_value_len++] = current_char;
-  if (parse_info->parsed_value_len == parse_info->parsed_value_capacity)
+  // the only unquoted text allowed is true, false and null, and nothing
+  // can be glued onto them
+  size_t len = 0;
+  while (len < max_len && isalpha((unsigned char)start[len]))
+    len++;
+
+  *type = JSON_BOOL;
+  *value = true;
+  if (len == 4 && strncmp(start, "true", 4) == 0)
+    return len;
+  if (len == 5 && strncmp(start, "false", 5) == 0)
   {
-    size_t new_capacity = parse_info->parsed_value_capacity * 2;
-    void* alloc = realloc(parse_info->parsed_value, new_capacity * sizeof(char));
-    if (!alloc)
-      return false;
-    parse_info->parsed_value = alloc;
-    parse_info->parsed_value_capacity = new_capacity;
-    memset(&parse_info->parsed_value[parse_info->parsed_value_len], 0, new_capacity + 1 - parse_info->parsed_value_len);
+    *value = false;
+    return len;
+  }
+  if (len == 4 && strncmp(start, "null", 4) == 0)
+  {
+    *type = JSON_NULL;
+    return len;
   }
 
-  return true;
+  *type = JSON_NOTYPE;
+  return 0;
 }
 
-#include <stdio.h>
+static bool
+_json_is_number_char(
+  const char c)
+{
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
 
-bool 
-_json_perform_token_action(
-  struct json_t* const json,
-  const enum _token_e current_token,
-  const char current_char,
-  struct _json_parse_info_t* const parse_info)
+bool
+_json_parse_token(
+  struct _json_parse_info_t* const parse_info,
+  const struct _json_token_handler_t* const handler,
+  void* ctx,
+  uint16_t* const expected_token)
 {
+  const char* const json_string = parse_info->json_string;
+  const size_t start = parse_info->json_string_idx;
+  const uint8_t token_class = _json_token_classes[(unsigned char)json_string[start]];
+  const enum _token_e current_token = _json_token_class_masks[token_class];
+  if ((current_token & *expected_token) == 0)
+    return false;
+
   switch (current_token)
   {
     case OPEN_BODY:
+    case OPEN_ARRAY:
     {
-      parse_info->parsing_key = true;
-      parse_info->parsing_value = false;
+      const enum json_type_e type = current_token == OPEN_BODY ? JSON_OBJECT : JSON_ARRAY;
+      void* container = NULL;
+      if ((handler->open && !handler->open(ctx, parse_info, type, start, &container))
+          || !_json_push_container(parse_info, type, container))
+        return false;
 
-      if (parse_info->previous_token == COLON)
-      {
-          parse_info->parsed_value_type = JSON_OBJECT;
-          if (!_json_add_item(json, parse_info))
-            return false;
-      }
+      parse_info->parsing_key = type == JSON_OBJECT;
+      parse_info->json_string_idx++;
       break;
     }
 
-    case OPEN_ARRAY:
+    case CLOSE_BODY:
+    case CLOSE_ARRAY:
     {
-      parse_info->parsed_value_type = JSON_ARRAY;
-      if (!_json_add_item(json, parse_info))
+      const enum json_type_e type = current_token == CLOSE_BODY ? JSON_OBJECT : JSON_ARRAY;
+      if (parse_info->stack[parse_info->stack_len - 1].type != type
+          || (handler->close && !handler->close(ctx, parse_info, start)))
         return false;
-      break;
-    }
-
-    case CLOSE_ARRAY: // no-op
-      break;
 
-    case CLOSE_BODY:
-      // if we still have content in our value when closing off JSON,
-      // try to add the item
-      if (parse_info->parsing_value && strlen(parse_info->parsed_value) > 0)
-      {
-        if (!_json_add_item(json, parse_info))
-          return false;
-      }
+      parse_info->stack_len--;
       parse_info->parsing_key = false;
-      parse_info->parsing_value = false;
+      parse_info->json_string_idx++;
       break;
+    }
 
     case COLON:
-    {
-      // after reading a key, we set the expecting_delimiter flag.
-      // if we encounter another key before this flag is cleared, then
-      // we are missing a delimiter between keys (comma).
-      // this flag is cleared after a successfull _json_add_item()
       parse_info->parsing_key = false;
-      parse_info->parsing_value = true;
-      parse_info->expecting_delimiter = true;
+      parse_info->json_string_idx++;
+      break;
+
+    case COMMA:
+      parse_info->parsing_key = parse_info->stack[parse_info->stack_len - 1].type == JSON_OBJECT;
+      parse_info->json_string_idx++;
       break;
-    }
 
     case QUOTE:
     {
-      if (parse_info->parsing_key && parse_info->expecting_delimiter)
-        return false;
-
-      // a special case for above delimiter check for strings, e.g.,:
-      // { "key1": "value" "key2": "value } <-- missing comma
-      if (!parse_info->inside_quotes && strlen(parse_info->parsed_value) > 0)
+      size_t str_start = 0;
+      size_t len = 0;
+      if (!_json_scan_quote_string(parse_info, &str_start, &len))
         return false;
 
-      // if value starts with a quote, it's a string type
-      if (!parse_info->inside_quotes
-          && parse_info->parsing_value 
-          && strlen(parse_info->parsed_value) == 0)
+      if (parse_info->parsing_key)
       {
-        parse_info->parsed_value_type = JSON_STRING;
-        if (!_json_add_item(json, parse_info))
+        // copied into the object once its value has been parsed
+        parse_info->parsed_key = &json_string[str_start];
+        parse_info->parsed_key_len = len;
+        if (handler->key && !handler->key(ctx, parse_info, str_start, len))
           return false;
         break;
       }
 
-      parse_info->inside_quotes = !parse_info->inside_quotes;
-
-      break;
-    }
-
-    // spaces and commas are technically different tokens, so
-    // by default they would be ignored
-    parse_string:
-    case TEXT:
-    {
-      if (parse_info->parsing_key 
-          && parse_info->inside_quotes)
-      {
-        _json_append_char_to_key(parse_info, current_char);
-      }
-
-      else if (parse_info->parsing_value
-              && !_json_append_char_to_value(parse_info, current_char))
+      if (handler->value && !handler->value(ctx, parse_info, JSON_STRING, NULL, str_start, len))
         return false;
-
       break;
     }
 
     case NUMERIC:
     {
-      // a numeric value inside a string
-      if (parse_info->parsed_value_type == JSON_STRING)
-        goto parse_string;
-
-      if (parse_info->parsing_key)
+      enum json_type_e type = JSON_NOTYPE;
+      union value value;
+      size_t len = 0;
+      if (handler->defer_numbers)
       {
-        _json_append_char_to_key(parse_info, current_char);
-        break;
+        while (start + len < parse_info->json_string_len && _json_is_number_char(json_string[start + len]))
+          len++;
       }
-
-      bool contains_decimal = false;
-      char* numeric_string 
-        = _json_fetch_numeric_string(
-            parse_info->json_string, 
-            &parse_info->json_string_idx,
-            &contains_decimal);
-      if (!numeric_string)
+      else if (!_json_parse_number(
+            &json_string[start],
+            json_string + parse_info->json_string_len,
+            &type,
+            &value,
+            &len))
         return false;
 
-      if (contains_decimal)
-        parse_info->parsed_value_type = JSON_DECIMAL;
-      else
-        parse_info->parsed_value_type = JSON_INT32;
-
-      size_t len = strlen(numeric_string);
-      strncat(parse_info->parsed_value, numeric_string, len);
-      parse_info->parsed_value_len = len;
-
-      if (!_json_add_item(json, parse_info))
+      if (handler->value && !handler->value(ctx, parse_info, type, &value, start, len))
         return false;
-      
-      free(numeric_string);
-      _json_reset_parse_info(parse_info);
-      
+
+      parse_info->json_string_idx += len;
       break;
     }
 
-    case COMMA:
+    case TEXT:
     {
-      if (parse_info->parsing_key 
-          && parse_info->inside_quotes)
-      {
-        _json_append_char_to_key(parse_info, current_char);
-      }
-
-      else if (parse_info->parsing_value 
-              && parse_info->inside_quotes)
-      {
-        _json_append_char_to_value(parse_info, current_char);
-      }
-
-      else if (strlen(parse_info->parsed_key) == 0
-          || strlen(parse_info->parsed_value) == 0)
+      enum json_type_e type = JSON_NOTYPE;
+      union value value;
+      size_t len = _json_scan_literal(
+        &json_string[start],
+        parse_info->json_string_len - start,
+        &type,
+        &value.boolean);
+      if (len == 0
+          || (handler->value && !handler->value(ctx, parse_info, type, &value, start, len)))
         return false;
 
-      else if (!_json_add_item(
-               json,
-               parse_info))
-       return false;
-
+      parse_info->json_string_idx += len;
       break;
     }
 
+    // whitespace is skipped before tokens are classified
     case SPACE:
-    {
-      if (parse_info->parsing_key
-          && parse_info->inside_quotes)
-      {
-        _json_append_char_to_key(parse_info, current_char);
-      }
+    case UNKNOWN:
+    case NONE:
+      return false;
+  }
 
-      else if (parse_info->parsing_value
-          && parse_info->inside_quotes)
-      {
-        _json_append_char_to_value(parse_info, current_char);
-      }
+  enum json_type_e container_type = JSON_NOTYPE;
+  if (parse_info->stack_len > 0)
+    container_type = parse_info->stack[parse_info->stack_len - 1].type;
 
-      break;
-    }
+  *expected_token = _json_token_transitions[token_class][container_type][parse_info->parsing_key];
+  parse_info->previous_token = current_token;
+  return true;
+}
 
-    case UNKNOWN:
-      return false;
+bool
+_json_parse_tokens(
+  struct _json_parse_info_t* const parse_info,
+  const struct _json_token_handler_t* const handler,
+  void* ctx,
+  const uint16_t root_tokens)
+{
+  parse_info->stack_capacity = 16;
+  parse_info->stack = malloc(parse_info->stack_capacity * sizeof(*parse_info->stack));
+  if (!parse_info->stack)
+    return false;
 
-    case NONE: // no-op
-      return true;
+  bool success = false;
+  uint16_t expected_token = root_tokens;
 
+  struct _json_structural_index_t structural_index;
+  if (parse_info->json_string_len - parse_info->json_string_idx >= JSON_STRUCTURAL_INDEX_MIN_LEN)
+  {
+    if (!_json_structural_index_init(
+          &structural_index,
+          parse_info->json_string,
+          parse_info->json_string_len,
+          _json_simd_detect()))
+      goto cleanup;
+    parse_info->structural_index = &structural_index;
   }
 
-  return true;
+  do
+  {
+    if (!_json_advance_to_token(parse_info)
+        || parse_info->json_string_idx == parse_info->json_string_len
+        || !_json_parse_token(parse_info, handler, ctx, &expected_token))
+      goto cleanup;
+  } while (parse_info->stack_len > 0);
+
+  // only trailing whitespace is allowed after the root is closed
+  success = _json_advance_to_token(parse_info)
+    && parse_info->json_string_idx == parse_info->json_string_len;
+
+cleanup:
+  if (parse_info->structural_index)
+  {
+    _json_structural_index_free(parse_info->structural_index);
+    parse_info->structural_index = NULL;
+  }
+  free(parse_info->stack);
+  parse_info->stack = NULL;
+  parse_info->stack_len = 0;
+  parse_info->stack_capacity = 0;
+  return success;
+}
+
+// parses an entire document into root (an already created json_t or
+// json_array_t depending on root_type) in a single pass over the input.
+// nested objects/arrays are created and attached to their parent as soon as
+// they're opened so nothing is ever extracted and re-parsed
+bool
+_json_parse_document(
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e root_type,
+  void* root)
+{
+  return _json_parse_tokens(
+    parse_info,
+    &_json_tree_handler,
+    &root,
+    root_type == JSON_OBJECT ? OPEN_BODY : OPEN_ARRAY);
 }
 
 void
@@ -862,8 +874,12 @@ _json_get_item_value(
 
 void
 _json_deallocate_item(
+  const struct json_arena_t* const arena,
   struct json_item_t* item)
 {
+  if (arena)
+    return;
+
   switch (item->type)
   {
     case JSON_OBJECT:
@@ -888,119 +904,372 @@ _json_deallocate_item(
   }
 }
 
-bool 
-_json_resize_string(
-  char** to_string,
-  size_t* capacity)
+void
+_json_walk_init(
+  struct _json_walk_t* const walk)
+{
+  walk->frames = walk->inline_frames;
+  walk->len = 0;
+  walk->capacity = JSON_WALK_INLINE_DEPTH;
+}
+
+bool
+_json_walk_push(
+  struct _json_walk_t* const walk,
+  const enum json_type_e type,
+  void* const container)
 {
-  size_t new_capacity = *capacity * 2;
-  void* alloc = realloc(*to_string, new_capacity);
-  if (!alloc)
-    return false;
-  *to_string = alloc;
-  *capacity = new_capacity;
+  if (walk->len == walk->capacity)
+  {
+    size_t new_capacity = walk->capacity * 2;
+    struct _json_walk_frame_t* frames = NULL;
+    if (walk->frames == walk->inline_frames)
+    {
+      frames = malloc(new_capacity * sizeof(*frames));
+      if (frames)
+        memcpy(frames, walk->inline_frames, sizeof(walk->inline_frames));
+    }
+    else
+      frames = realloc(walk->frames, new_capacity * sizeof(*frames));
+
+    if (!frames)
+      return false;
+    walk->frames = frames;
+    walk->capacity = new_capacity;
+  }
+
+  walk->frames[walk->len].type = type;
+  walk->frames[walk->len].container = container;
+  walk->frames[walk->len].idx = 0;
+  walk->len++;
   return true;
 }
 
 bool
-_json_write_value_buffer_to_string(
-  char* formatted_buffer,
-  char** to_string,
-  size_t* to_string_len,
-  size_t* to_string_capacity)
-{
-  size_t formatted_buffer_len = strlen(formatted_buffer);
-  if (*to_string_len + formatted_buffer_len  >= *to_string_capacity
-      && !_json_resize_string(to_string, to_string_capacity))
+_json_walk_next(
+  struct _json_walk_t* const walk,
+  struct json_item_t* const item)
+{
+  struct _json_walk_frame_t* frame = &walk->frames[walk->len - 1];
+
+  if (frame->type == JSON_OBJECT)
+  {
+    const struct json_t* json = frame->container;
+    if (frame->idx == json->n_items)
+      return false;
+    *item = json->items[frame->idx++];
+    return true;
+  }
+
+  const struct json_array_t* array = frame->container;
+  if (frame->idx == array->n_items)
     return false;
-  strncat(*to_string, formatted_buffer, formatted_buffer_len);
-  *to_string_len += formatted_buffer_len;
+
+  if (array->packed_type == JSON_NOTYPE)
+  {
+    *item = array->items[frame->idx++];
+    return true;
+  }
+
+  item->type = array->packed_type;
+  item->key = NULL;
+  item->key_len = 0;
+  _json_set_item_value(item, _json_array_get_value(array, frame->idx++));
   return true;
 }
 
-bool 
-_json_value_to_string(
-  char* formatted_buffer,
-  size_t max_buffer_len,
-  const struct json_item_t* const item,
-  char** to_string,
-  size_t* to_string_len,
-  size_t* to_string_capacity)
+void
+_json_walk_free(
+  struct _json_walk_t* const walk)
 {
-  switch (item->type)
+  if (walk->frames != walk->inline_frames)
+    free(walk->frames);
+  walk->frames = walk->inline_frames;
+  walk->len = 0;
+  walk->capacity = JSON_WALK_INLINE_DEPTH;
+}
+
+static void
+_json_release_object(
+  struct json_t* const json)
+{
+  free(json->items);
+  free(json->key_index);
+
+  struct _json_key_chunk_t* chunk = json->keys;
+  while (chunk)
   {
-    case JSON_INT32:
-    {
-      snprintf(formatted_buffer, max_buffer_len, "%d", item->value.int32);
-      if (!_json_write_value_buffer_to_string(formatted_buffer, to_string, to_string_len, to_string_capacity))
-        return false;
-      break;
-    }
+    struct _json_key_chunk_t* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
 
-    case JSON_DECIMAL:
-    {
-      snprintf(formatted_buffer, max_buffer_len, "%f", item->value.decimal);
-      if (!_json_write_value_buffer_to_string(formatted_buffer, to_string, to_string_len, to_string_capacity))
-        return false;
-      break;
-    }
+  free(json);
+}
 
-    case JSON_BOOL:
+static void
+_json_release_array(
+  struct json_array_t* const array)
+{
+  free(array->items);
+  free(array->values);
+  free(array);
+}
+
+// a container is only released once everything in it has been, which
+// happens when it's popped off the walk
+void
+_json_free_container(
+  const enum json_type_e type,
+  void* const container)
+{
+  struct _json_walk_t walk;
+  _json_walk_init(&walk);
+  _json_walk_push(&walk, type, container);
+
+  while (walk.len > 0)
+  {
+    struct _json_walk_frame_t* frame = &walk.frames[walk.len - 1];
+
+    // packed values are never heap items themselves
+    const bool packed = frame->type == JSON_ARRAY
+      && ((struct json_array_t*)frame->container)->packed_type != JSON_NOTYPE;
+
+    struct json_item_t item;
+    if (packed || !_json_walk_next(&walk, &item))
     {
-      if (item->value.boolean) 
-        snprintf(formatted_buffer, max_buffer_len, "%s", "true");
+      if (frame->type == JSON_OBJECT)
+        _json_release_object(frame->container);
       else
-        snprintf(formatted_buffer, max_buffer_len, "%s", "false");
-      if (!_json_write_value_buffer_to_string(formatted_buffer, to_string, to_string_len, to_string_capacity))
-        return false;
-      break;
+        _json_release_array(frame->container);
+      walk.len--;
+      continue;
     }
 
-    case JSON_NULL:
+    void* child = NULL;
+    switch (item.type)
     {
-      snprintf(formatted_buffer, max_buffer_len, "%s", "null");
-      if (!_json_write_value_buffer_to_string(formatted_buffer, to_string, to_string_len, to_string_capacity))
-        return false;
-      break;
+      case JSON_STRING:
+        free(item.value.str);
+        break;
+      case JSON_OBJECT:
+        if (item.value.object && !item.value.object->arena)
+          child = item.value.object;
+        break;
+      case JSON_ARRAY:
+        if (item.value.array && !item.value.array->arena)
+          child = item.value.array;
+        break;
+      case JSON_INT32:
+      case JSON_DECIMAL:
+      case JSON_BOOL:
+      case JSON_NULL:
+      case JSON_NOTYPE:
+        break;
     }
 
-    case JSON_STRING:
-    {
-      // need to add quotes before an after string content
-      if (!_json_write_value_buffer_to_string("\"", to_string, to_string_len, to_string_capacity))
-        return false;
-      if (!_json_write_value_buffer_to_string(item->value.str, to_string, to_string_len, to_string_capacity))
-        return false;
-      if (!_json_write_value_buffer_to_string("\"", to_string, to_string_len, to_string_capacity))
-        return false;
+    // out of memory for the walk, so fall back to recursing (the inline
+    // frames still cover JSON_WALK_INLINE_DEPTH levels per call)
+    if (child && !_json_walk_push(&walk, item.type, child))
+      _json_free_container(item.type, child);
+  }
+
+  _json_walk_free(&walk);
+}
+
+bool
+_json_string_builder_init(
+  struct _json_string_builder_t* const builder,
+  const size_t initial_capacity)
+{
+  builder->len = 0;
+  builder->capacity = initial_capacity > 0 ? initial_capacity : 1;
+  builder->data = malloc(builder->capacity);
+  if (!builder->data)
+    return false;
+  builder->data[0] = '\0';
+  return true;
+}
+
+// grows geometrically, but always by at least enough to hold the pending
+// chunk, so appends are amortized O(len) no matter how large a chunk is
+bool
+_json_string_builder_reserve(
+  struct _json_string_builder_t* const builder,
+  const size_t additional)
+{
+  // +1 for the null terminator
+  size_t required = builder->len + additional + 1;
+  if (required <= builder->capacity)
+    return true;
+
+  size_t new_capacity = builder->capacity * 2;
+  if (new_capacity < required)
+    new_capacity = required;
+
+  void* alloc = realloc(builder->data, new_capacity);
+  if (!alloc)
+    return false;
+  builder->data = alloc;
+  builder->capacity = new_capacity;
+  return true;
+}
+
+bool
+_json_string_builder_append(
+  struct _json_string_builder_t* const builder,
+  const char* const data,
+  const size_t len)
+{
+  if (!_json_string_builder_reserve(builder, len))
+    return false;
+
+  memcpy(&builder->data[builder->len], data, len);
+  builder->len += len;
+  builder->data[builder->len] = '\0';
+  return true;
+}
+
+char*
+_json_string_builder_release(
+  struct _json_string_builder_t* const builder)
+{
+  char* data = builder->data;
+  builder->data = NULL;
+  builder->len = 0;
+  builder->capacity = 0;
+  return data;
+}
+
+void
+_json_string_builder_free(
+  struct _json_string_builder_t* const builder)
+{
+  free(builder->data);
+  builder->data = NULL;
+  builder->len = 0;
+  builder->capacity = 0;
+}
+
+// reads a whole stream into a heap buffer. used when the file can't be
+// mapped, e.g., pipes or other files that don't report a size
+static bool
+_json_read_stream(
+  FILE* stream,
+  struct _json_file_buffer_t* const file_buffer)
+{
+  size_t capacity = 65536;
+  size_t len = 0;
+  char* contents = malloc(capacity);
+  if (!contents)
+    return false;
+
+  while (true)
+  {
+    len += fread(&contents[len], sizeof(char), capacity - len, stream);
+    if (len < capacity)
       break;
-    }
 
-    case JSON_ARRAY:
+    size_t new_capacity = capacity * 2;
+    void* alloc = realloc(contents, new_capacity);
+    if (!alloc)
     {
-      char* array_string = json_array_to_string(item->value.array);
-      if (!array_string)
-        return false;
-      if (!_json_write_value_buffer_to_string(array_string, to_string, to_string_len, to_string_capacity))
-        return false;
-      free(array_string);
-      break;
+      free(contents);
+      return false;
     }
+    contents = alloc;
+    capacity = new_capacity;
+  }
 
-    case JSON_OBJECT:
+  if (ferror(stream))
+  {
+    free(contents);
+    return false;
+  }
+
+  file_buffer->contents = contents;
+  file_buffer->len = len;
+  file_buffer->mapped = false;
+  return true;
+}
+
+bool
+_json_load_file(
+  const char* const filepath,
+  struct _json_file_buffer_t* const file_buffer)
+{
+#ifdef JSON_HAS_MMAP
+  // regular files are mapped and parsed straight out of the page cache
+  // so the contents never need to be copied onto the heap
+  int fd = open(filepath, O_RDONLY);
+  if (fd == -1)
+    return false;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0
+      && S_ISREG(file_stat.st_mode)
+      && file_stat.st_size > 0
+      && (uintmax_t)file_stat.st_size <= SIZE_MAX)
+  {
+    size_t len = (size_t)file_stat.st_size;
+    void* contents = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (contents != MAP_FAILED)
     {
-      char* json_string = json_to_string(item->value.object);
-      if (!json_string)
-        return false;
-      if (!_json_write_value_buffer_to_string(json_string, to_string, to_string_len, to_string_capacity))
-        return false;
-      free(json_string);
-      break;
+      // the parser only ever moves forward through the input
+      madvise(contents, len, MADV_SEQUENTIAL);
+      close(fd);
+
+      file_buffer->contents = contents;
+      file_buffer->len = len;
+      file_buffer->mapped = true;
+      return true;
     }
+  }
 
-    case JSON_NOTYPE:
-      break;
+  // couldn't map it, fall back to reading from the descriptor
+  FILE* json_file = fdopen(fd, "rb");
+  if (!json_file)
+  {
+    close(fd);
+    return false;
   }
+#else
+  FILE* json_file = fopen(filepath, "rb");
+  if (!json_file)
+    return false;
+#endif
 
-  return true;
+  bool success = _json_read_stream(json_file, file_buffer);
+  fclose(json_file);
+  return success;
+}
+
+void
+_json_release_file(
+  struct _json_file_buffer_t* const file_buffer)
+{
+#ifdef JSON_HAS_MMAP
+  if (file_buffer->mapped)
+    munmap(file_buffer->contents, file_buffer->len);
+  else
+    free(file_buffer->contents);
+#else
+  free(file_buffer->contents);
+#endif
+
+  file_buffer->contents = NULL;
+  file_buffer->len = 0;
+  file_buffer->mapped = false;
+}
+
+size_t
+_json_default_thread_count()
+{
+  // sysconf comes from unistd.h along with mmap
+#ifdef JSON_HAS_MMAP
+  long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n_cpus > 0)
+    return (size_t)n_cpus;
+#endif
+  return 1;
 }
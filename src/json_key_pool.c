@@ -0,0 +1,201 @@
+#include "json.h"
+#include "json_internal.h"
+
+#define JSON_KEY_POOL_INITIAL_CAPACITY 64
+
+struct json_key_pool_t*
+json_key_pool_create(void)
+{
+  struct json_key_pool_t* pool = malloc(sizeof(*pool));
+  if (!pool)
+    return NULL;
+
+  pool->capacity = JSON_KEY_POOL_INITIAL_CAPACITY;
+  pool->n_keys = 0;
+  pool->chunks = NULL;
+  pool->entries = calloc(pool->capacity, sizeof(*pool->entries));
+  if (!pool->entries)
+  {
+    free(pool);
+    return NULL;
+  }
+
+  if (pthread_rwlock_init(&pool->lock, NULL) != 0)
+  {
+    free(pool->entries);
+    free(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+void
+json_key_pool_destroy(
+  struct json_key_pool_t** pool)
+{
+  if (!*pool)
+    return;
+
+  struct _json_key_chunk_t* chunk = (*pool)->chunks;
+  while (chunk)
+  {
+    struct _json_key_chunk_t* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+
+  pthread_rwlock_destroy(&(*pool)->lock);
+  free((*pool)->entries);
+  free(*pool);
+  *pool = NULL;
+}
+
+size_t
+json_key_pool_size(
+  struct json_key_pool_t* const pool)
+{
+  pthread_rwlock_rdlock(&pool->lock);
+  size_t n_keys = pool->n_keys;
+  pthread_rwlock_unlock(&pool->lock);
+  return n_keys;
+}
+
+// the slot holding key, or the empty slot it would go in.
+// the caller holds the lock
+static struct _json_key_pool_entry_t*
+_json_key_pool_slot(
+  const struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len,
+  const size_t hash)
+{
+  size_t mask = pool->capacity - 1;
+  size_t slot = hash & mask;
+  while (pool->entries[slot].key)
+  {
+    const struct _json_key_pool_entry_t* entry = &pool->entries[slot];
+    if (entry->hash == hash
+        && entry->len == key_len
+        && memcmp(entry->key, key, key_len) == 0)
+      break;
+    slot = (slot + 1) & mask;
+  }
+
+  return &pool->entries[slot];
+}
+
+// doubles the table, the caller holds the lock for writing
+static bool
+_json_key_pool_grow(
+  struct json_key_pool_t* const pool)
+{
+  size_t new_capacity = pool->capacity * 2;
+  struct _json_key_pool_entry_t* entries = calloc(new_capacity, sizeof(*entries));
+  if (!entries)
+    return false;
+
+  size_t mask = new_capacity - 1;
+  for (size_t i = 0; i < pool->capacity; ++i)
+  {
+    if (!pool->entries[i].key)
+      continue;
+
+    size_t slot = pool->entries[i].hash & mask;
+    while (entries[slot].key)
+      slot = (slot + 1) & mask;
+    entries[slot] = pool->entries[i];
+  }
+
+  free(pool->entries);
+  pool->entries = entries;
+  pool->capacity = new_capacity;
+  return true;
+}
+
+// copies key into the newest chunk (or a new one), the caller
+// holds the lock for writing
+static const char*
+_json_key_pool_store(
+  struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len)
+{
+  struct _json_key_chunk_t* chunk = pool->chunks;
+  if (!chunk || chunk->capacity - chunk->used < key_len + 1)
+  {
+    size_t capacity = key_len + 1 > JSON_KEY_POOL_CHUNK_SIZE ? key_len + 1 : JSON_KEY_POOL_CHUNK_SIZE;
+    chunk = malloc(sizeof(*chunk) + capacity);
+    if (!chunk)
+      return NULL;
+    chunk->next = pool->chunks;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    pool->chunks = chunk;
+  }
+
+  char* stored = &chunk->data[chunk->used];
+  memcpy(stored, key, key_len);
+  stored[key_len] = '\0';
+  chunk->used += key_len + 1;
+  return stored;
+}
+
+const char*
+_json_key_pool_find(
+  struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len)
+{
+  size_t hash = _json_hash_key(key, key_len);
+
+  pthread_rwlock_rdlock(&pool->lock);
+  const char* interned = _json_key_pool_slot(pool, key, key_len, hash)->key;
+  pthread_rwlock_unlock(&pool->lock);
+
+  return interned;
+}
+
+const char*
+_json_key_pool_intern(
+  struct json_key_pool_t* const pool,
+  const char* const key,
+  const size_t key_len)
+{
+  size_t hash = _json_hash_key(key, key_len);
+
+  // almost every key is already in the pool
+  pthread_rwlock_rdlock(&pool->lock);
+  const char* interned = _json_key_pool_slot(pool, key, key_len, hash)->key;
+  pthread_rwlock_unlock(&pool->lock);
+  if (interned)
+    return interned;
+
+  // another thread may have added it between the two locks
+  pthread_rwlock_wrlock(&pool->lock);
+  struct _json_key_pool_entry_t* entry = _json_key_pool_slot(pool, key, key_len, hash);
+  if (!entry->key)
+  {
+    // kept at most half full
+    if ((pool->n_keys + 1) * 2 > pool->capacity)
+    {
+      if (!_json_key_pool_grow(pool))
+        goto cleanup;
+      entry = _json_key_pool_slot(pool, key, key_len, hash);
+    }
+
+    const char* stored = _json_key_pool_store(pool, key, key_len);
+    if (!stored)
+      goto cleanup;
+
+    entry->key = stored;
+    entry->len = key_len;
+    entry->hash = hash;
+    pool->n_keys++;
+  }
+  interned = entry->key;
+
+cleanup:
+  pthread_rwlock_unlock(&pool->lock);
+  return interned;
+}
@@ -0,0 +1,481 @@
+#include "json.h"
+#include "json_internal.h"
+#include "json_lines.h"
+
+// finds the next line in input[*idx, len) that isn't blank, moving idx
+// past it. line is advanced for every line passed over (blank or not)
+static bool
+_json_lines_next_line(
+  const char* const input,
+  const size_t len,
+  size_t* const idx,
+  size_t* const line,
+  size_t* const start,
+  size_t* const end)
+{
+  while (*idx < len)
+  {
+    *start = *idx;
+    const char* newline = memchr(&input[*start], '\n', len - *start);
+    *end = newline ? (size_t)(newline - input) : len;
+    *idx = newline ? *end + 1 : *end;
+    (*line)++;
+
+    if (*end > *start && input[*end - 1] == '\r')
+      (*end)--;
+
+    if (_json_find_non_whitespace(input, *start, *end) != *end)
+      return true;
+  }
+
+  return false;
+}
+
+struct json_lines_reader_t*
+json_lines_reader_open(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags)
+{
+  struct json_lines_reader_t* reader = calloc(1, sizeof(*reader));
+  if (!reader)
+    return NULL;
+
+  reader->input = buffer;
+  reader->input_len = len;
+  reader->idx = 0;
+  reader->line = 0;
+  reader->flags = flags;
+  reader->failed = false;
+  reader->arena = json_arena_create(0);
+  if (!reader->arena)
+  {
+    free(reader);
+    return NULL;
+  }
+
+  return reader;
+}
+
+struct json_lines_reader_t*
+json_lines_reader_open_file(
+  const char* const filepath,
+  const uint32_t flags)
+{
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return NULL;
+
+  struct json_lines_reader_t* reader = json_lines_reader_open(file_buffer.contents, file_buffer.len, flags);
+  if (!reader)
+  {
+    _json_release_file(&file_buffer);
+    return NULL;
+  }
+
+  reader->file = file_buffer;
+  return reader;
+}
+
+struct json_t*
+json_lines_reader_next(
+  struct json_lines_reader_t* const reader)
+{
+  if (reader->failed)
+    return NULL;
+
+  // the last record goes with the arena
+  json_arena_reset(reader->arena);
+
+  size_t start = 0;
+  size_t end = 0;
+  if (!_json_lines_next_line(reader->input, reader->input_len, &reader->idx, &reader->line, &start, &end))
+    return NULL;
+
+  const struct json_parse_options_t options = {
+    .flags = reader->flags,
+    .arena = reader->arena,
+    .key_pool = NULL
+  };
+  struct json_t* json = json_parse_with_options(&reader->input[start], end - start, &options);
+  if (!json)
+    reader->failed = true;
+  return json;
+}
+
+bool
+json_lines_reader_failed(
+  const struct json_lines_reader_t* const reader)
+{
+  return reader->failed;
+}
+
+size_t
+json_lines_reader_line(
+  const struct json_lines_reader_t* const reader)
+{
+  return reader->line;
+}
+
+void
+json_lines_reader_close(
+  struct json_lines_reader_t** reader)
+{
+  if (!*reader)
+    return;
+
+  json_arena_destroy(&(*reader)->arena);
+  if ((*reader)->file.contents)
+    _json_release_file(&(*reader)->file);
+  free(*reader);
+  *reader = NULL;
+}
+
+// the next chunk to parse, up to (and including) the first newline
+// after chunk_size bytes. false once there's nothing left to hand out
+static bool
+_json_lines_take_chunk(
+  struct _json_lines_job_t* const job,
+  size_t* const chunk,
+  size_t* const start,
+  size_t* const end)
+{
+  pthread_mutex_lock(&job->lock);
+  bool taken = false;
+  if (!job->failed && !job->stopped && job->next_start < job->input_len)
+  {
+    *start = job->next_start;
+    *end = job->input_len;
+    if (job->input_len - *start > job->chunk_size)
+    {
+      const size_t search = *start + job->chunk_size;
+      const char* newline = memchr(&job->input[search], '\n', job->input_len - search);
+      if (newline)
+        *end = (size_t)(newline - job->input) + 1;
+    }
+
+    *chunk = job->next_chunk++;
+    job->next_start = *end;
+    taken = true;
+  }
+  pthread_mutex_unlock(&job->lock);
+  return taken;
+}
+
+static void
+_json_lines_fail(
+  struct _json_lines_job_t* const job,
+  const size_t offset)
+{
+  pthread_mutex_lock(&job->lock);
+  job->failed = true;
+  if (offset < job->error_offset)
+    job->error_offset = offset;
+  pthread_mutex_unlock(&job->lock);
+}
+
+static bool
+_json_lines_keep_record(
+  struct _json_lines_worker_t* const worker,
+  struct json_t* const json,
+  const size_t offset)
+{
+  if (worker->n_records == worker->records_capacity)
+  {
+    size_t new_capacity = worker->records_capacity == 0 ? 256 : worker->records_capacity * 2;
+    void* records = realloc(worker->records, new_capacity * sizeof(*worker->records));
+    if (!records)
+      return false;
+    worker->records = records;
+
+    void* offsets = realloc(worker->offsets, new_capacity * sizeof(*worker->offsets));
+    if (!offsets)
+      return false;
+    worker->offsets = offsets;
+    worker->records_capacity = new_capacity;
+  }
+
+  worker->records[worker->n_records] = json;
+  worker->offsets[worker->n_records] = offset;
+  worker->n_records++;
+  return true;
+}
+
+// waits for this chunk's turn, hands over the records it parsed and
+// then lets the next chunk go
+static void
+_json_lines_deliver_in_order(
+  struct _json_lines_worker_t* const worker,
+  const size_t chunk,
+  const bool chunk_failed)
+{
+  struct _json_lines_job_t* const job = worker->job;
+
+  pthread_mutex_lock(&job->lock);
+  while (job->next_delivery != chunk)
+    pthread_cond_wait(&job->delivered, &job->lock);
+  bool stopped = job->stopped;
+  pthread_mutex_unlock(&job->lock);
+
+  // only this thread delivers until next_delivery moves on, so the
+  // callback is never called concurrently
+  for (size_t i = 0; i < worker->n_records && !stopped; ++i)
+    stopped = !job->callback(worker->records[i], worker->offsets[i], job->ctx);
+
+  pthread_mutex_lock(&job->lock);
+  // nothing after an invalid line is delivered
+  if (stopped || chunk_failed)
+    job->stopped = true;
+  job->next_delivery++;
+  pthread_cond_broadcast(&job->delivered);
+  pthread_mutex_unlock(&job->lock);
+}
+
+static void*
+_json_lines_work(
+  void* arg)
+{
+  struct _json_lines_worker_t* const worker = arg;
+  struct _json_lines_job_t* const job = worker->job;
+
+  size_t chunk = 0;
+  size_t chunk_start = 0;
+  size_t chunk_end = 0;
+  while (_json_lines_take_chunk(job, &chunk, &chunk_start, &chunk_end))
+  {
+    json_arena_reset(worker->arena);
+    worker->n_records = 0;
+
+    const struct json_parse_options_t options = {
+      .flags = job->flags,
+      .arena = worker->arena,
+      .key_pool = NULL
+    };
+
+    bool chunk_failed = false;
+    size_t idx = chunk_start;
+    size_t line = 0;
+    size_t start = 0;
+    size_t end = 0;
+    while (!chunk_failed && _json_lines_next_line(job->input, chunk_end, &idx, &line, &start, &end))
+    {
+      struct json_t* json = json_parse_with_options(&job->input[start], end - start, &options);
+      if (!json)
+      {
+        _json_lines_fail(job, start);
+        chunk_failed = true;
+      }
+      else if (job->ordered)
+      {
+        if (!_json_lines_keep_record(worker, json, start))
+        {
+          _json_lines_fail(job, SIZE_MAX);
+          chunk_failed = true;
+        }
+      }
+      else
+      {
+        if (!job->callback(json, start, job->ctx))
+        {
+          pthread_mutex_lock(&job->lock);
+          job->stopped = true;
+          pthread_mutex_unlock(&job->lock);
+          break;
+        }
+        // nothing needs to outlive the callback
+        json_arena_reset(worker->arena);
+      }
+    }
+
+    if (job->ordered)
+      _json_lines_deliver_in_order(worker, chunk, chunk_failed);
+  }
+
+  return NULL;
+}
+
+bool
+json_lines_parse_parallel(
+  const char* const buffer,
+  const size_t len,
+  const struct json_lines_parallel_options_t* const options,
+  json_lines_record_fn callback,
+  void* ctx,
+  size_t* const error_offset)
+{
+  // set up front so it's valid however this returns
+  if (error_offset)
+    *error_offset = SIZE_MAX;
+
+  const struct json_lines_parallel_options_t defaults = {0};
+  const struct json_lines_parallel_options_t* const opts = options ? options : &defaults;
+
+  struct _json_lines_job_t job = {
+    .input = buffer,
+    .input_len = len,
+    .chunk_size = opts->chunk_size > 0 ? opts->chunk_size : JSON_LINES_CHUNK_SIZE,
+    .ordered = opts->ordered,
+    .flags = opts->flags,
+    .callback = callback,
+    .ctx = ctx,
+    .next_start = 0,
+    .next_chunk = 0,
+    .next_delivery = 0,
+    .failed = false,
+    .stopped = false,
+    .error_offset = SIZE_MAX
+  };
+
+  // no point starting more threads than there are chunks
+  size_t n_threads = opts->n_threads > 0 ? opts->n_threads : _json_default_thread_count();
+  const size_t n_chunks = len / job.chunk_size + 1;
+  if (n_threads > n_chunks)
+    n_threads = n_chunks;
+
+  struct _json_lines_worker_t* workers = calloc(n_threads, sizeof(*workers));
+  if (!workers)
+    return false;
+
+  if (pthread_mutex_init(&job.lock, NULL) != 0)
+  {
+    free(workers);
+    return false;
+  }
+  if (pthread_cond_init(&job.delivered, NULL) != 0)
+  {
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
+    return false;
+  }
+
+  bool success = true;
+  size_t n_started = 0;
+  for (size_t i = 0; i < n_threads; ++i)
+  {
+    workers[i].job = &job;
+    workers[i].arena = json_arena_create(0);
+    if (!workers[i].arena)
+    {
+      success = false;
+      break;
+    }
+  }
+
+  // the calling thread is worker 0
+  if (success)
+  {
+    for (n_started = 1; n_started < n_threads; ++n_started)
+    {
+      if (pthread_create(&workers[n_started].thread, NULL, _json_lines_work, &workers[n_started]) != 0)
+        break;
+    }
+    _json_lines_work(&workers[0]);
+  }
+
+  for (size_t i = 1; i < n_started; ++i)
+    pthread_join(workers[i].thread, NULL);
+
+  for (size_t i = 0; i < n_threads; ++i)
+  {
+    json_arena_destroy(&workers[i].arena);
+    free(workers[i].records);
+    free(workers[i].offsets);
+  }
+  free(workers);
+  pthread_cond_destroy(&job.delivered);
+  pthread_mutex_destroy(&job.lock);
+
+  if (error_offset)
+    *error_offset = job.error_offset;
+  return success && !job.failed && !job.stopped;
+}
+
+bool
+json_lines_parse_parallel_file(
+  const char* const filepath,
+  const struct json_lines_parallel_options_t* const options,
+  json_lines_record_fn callback,
+  void* ctx,
+  size_t* const error_offset)
+{
+  if (error_offset)
+    *error_offset = SIZE_MAX;
+
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return false;
+
+  bool success = json_lines_parse_parallel(file_buffer.contents, file_buffer.len, options, callback, ctx, error_offset);
+  _json_release_file(&file_buffer);
+
+  return success;
+}
+
+struct json_lines_writer_t*
+json_lines_writer_open(
+  const char* const filepath)
+{
+  FILE* file = fopen(filepath, "wb");
+  if (!file)
+    return NULL;
+
+  struct json_lines_writer_t* writer = json_lines_writer_open_sink(json_file_sink, file);
+  if (!writer)
+  {
+    fclose(file);
+    return NULL;
+  }
+
+  writer->file = file;
+  return writer;
+}
+
+struct json_lines_writer_t*
+json_lines_writer_open_sink(
+  json_sink_fn sink,
+  void* ctx)
+{
+  struct json_lines_writer_t* writer = malloc(sizeof(*writer));
+  if (!writer)
+    return NULL;
+
+  writer->sink = sink;
+  writer->ctx = ctx;
+  writer->file = NULL;
+  writer->failed = false;
+  return writer;
+}
+
+bool
+json_lines_writer_write(
+  struct json_lines_writer_t* const writer,
+  const struct json_t* const json)
+{
+  // each record goes straight to the sink, the same as json_to_string
+  // would format it but without building the string first
+  if (writer->failed
+      || !json_write(json, writer->sink, writer->ctx)
+      || !writer->sink("\n", 1, writer->ctx))
+  {
+    writer->failed = true;
+    return false;
+  }
+
+  return true;
+}
+
+bool
+json_lines_writer_close(
+  struct json_lines_writer_t** writer)
+{
+  if (!*writer)
+    return false;
+
+  bool success = !(*writer)->failed;
+  if ((*writer)->file && fclose((*writer)->file) != 0)
+    success = false;
+
+  free(*writer);
+  *writer = NULL;
+  return success;
+}
@@ -0,0 +1,1813 @@
+#include "json.h"
+#include "json_internal.h"
+#include <math.h>
+
+// number formatting for the writer. integers are written two digits at a
+// time from a lookup table and decimals use Grisu2 (Loitsch, "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers"), which
+// produces the shortest (or very nearly so) digits that parse back to
+// exactly the same double.
+
+static const char _json_digit_pairs[200] = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const uint32_t _json_pow10_32[] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// writes value without a sign and returns the number of characters
+static size_t
+_json_format_uint32(
+  uint32_t value,
+  char* const buffer)
+{
+  char reversed[10];
+  size_t len = 0;
+
+  while (value >= 100)
+  {
+    const uint32_t pair = (value % 100) * 2;
+    value /= 100;
+    reversed[len++] = _json_digit_pairs[pair + 1];
+    reversed[len++] = _json_digit_pairs[pair];
+  }
+
+  if (value >= 10)
+  {
+    reversed[len++] = _json_digit_pairs[value * 2 + 1];
+    reversed[len++] = _json_digit_pairs[value * 2];
+  }
+  else
+    reversed[len++] = '0' + value;
+
+  for (size_t i = 0; i < len; ++i)
+    buffer[i] = reversed[len - 1 - i];
+
+  return len;
+}
+
+size_t
+_json_format_int32(
+  const int32_t value,
+  char* const buffer)
+{
+  if (value < 0)
+  {
+    buffer[0] = '-';
+    // negate as unsigned so INT32_MIN doesn't overflow
+    return 1 + _json_format_uint32(0u - (uint32_t)value, &buffer[1]);
+  }
+
+  return _json_format_uint32((uint32_t)value, buffer);
+}
+
+// a double as f * 2^e with a full 64-bit significand
+struct _json_diy_fp_t
+{
+  uint64_t f;
+  int e;
+};
+
+#define JSON_DP_SIGNIFICAND_MASK UINT64_C(0x000FFFFFFFFFFFFF)
+#define JSON_DP_EXPONENT_MASK UINT64_C(0x7FF0000000000000)
+#define JSON_DP_HIDDEN_BIT UINT64_C(0x0010000000000000)
+#define JSON_DP_SIGNIFICAND_SIZE 52
+#define JSON_DP_EXPONENT_BIAS (0x3FF + JSON_DP_SIGNIFICAND_SIZE)
+#define JSON_DP_MIN_EXPONENT (-JSON_DP_EXPONENT_BIAS)
+
+// 10^k for k = -348, -340, ..., 340 normalized to 64-bit significands,
+// generated with exact rational arithmetic and rounded to nearest
+static const struct _json_diy_fp_t _json_cached_powers[] = {
+  { UINT64_C(0xfa8fd5a0081c0288), -1220 },
+  { UINT64_C(0xbaaee17fa23ebf76), -1193 },
+  { UINT64_C(0x8b16fb203055ac76), -1166 },
+  { UINT64_C(0xcf42894a5dce35ea), -1140 },
+  { UINT64_C(0x9a6bb0aa55653b2d), -1113 },
+  { UINT64_C(0xe61acf033d1a45df), -1087 },
+  { UINT64_C(0xab70fe17c79ac6ca), -1060 },
+  { UINT64_C(0xff77b1fcbebcdc4f), -1034 },
+  { UINT64_C(0xbe5691ef416bd60c), -1007 },
+  { UINT64_C(0x8dd01fad907ffc3c), -980 },
+  { UINT64_C(0xd3515c2831559a83), -954 },
+  { UINT64_C(0x9d71ac8fada6c9b5), -927 },
+  { UINT64_C(0xea9c227723ee8bcb), -901 },
+  { UINT64_C(0xaecc49914078536d), -874 },
+  { UINT64_C(0x823c12795db6ce57), -847 },
+  { UINT64_C(0xc21094364dfb5637), -821 },
+  { UINT64_C(0x9096ea6f3848984f), -794 },
+  { UINT64_C(0xd77485cb25823ac7), -768 },
+  { UINT64_C(0xa086cfcd97bf97f4), -741 },
+  { UINT64_C(0xef340a98172aace5), -715 },
+  { UINT64_C(0xb23867fb2a35b28e), -688 },
+  { UINT64_C(0x84c8d4dfd2c63f3b), -661 },
+  { UINT64_C(0xc5dd44271ad3cdba), -635 },
+  { UINT64_C(0x936b9fcebb25c996), -608 },
+  { UINT64_C(0xdbac6c247d62a584), -582 },
+  { UINT64_C(0xa3ab66580d5fdaf6), -555 },
+  { UINT64_C(0xf3e2f893dec3f126), -529 },
+  { UINT64_C(0xb5b5ada8aaff80b8), -502 },
+  { UINT64_C(0x87625f056c7c4a8b), -475 },
+  { UINT64_C(0xc9bcff6034c13053), -449 },
+  { UINT64_C(0x964e858c91ba2655), -422 },
+  { UINT64_C(0xdff9772470297ebd), -396 },
+  { UINT64_C(0xa6dfbd9fb8e5b88f), -369 },
+  { UINT64_C(0xf8a95fcf88747d94), -343 },
+  { UINT64_C(0xb94470938fa89bcf), -316 },
+  { UINT64_C(0x8a08f0f8bf0f156b), -289 },
+  { UINT64_C(0xcdb02555653131b6), -263 },
+  { UINT64_C(0x993fe2c6d07b7fac), -236 },
+  { UINT64_C(0xe45c10c42a2b3b06), -210 },
+  { UINT64_C(0xaa242499697392d3), -183 },
+  { UINT64_C(0xfd87b5f28300ca0e), -157 },
+  { UINT64_C(0xbce5086492111aeb), -130 },
+  { UINT64_C(0x8cbccc096f5088cc), -103 },
+  { UINT64_C(0xd1b71758e219652c), -77 },
+  { UINT64_C(0x9c40000000000000), -50 },
+  { UINT64_C(0xe8d4a51000000000), -24 },
+  { UINT64_C(0xad78ebc5ac620000), 3 },
+  { UINT64_C(0x813f3978f8940984), 30 },
+  { UINT64_C(0xc097ce7bc90715b3), 56 },
+  { UINT64_C(0x8f7e32ce7bea5c70), 83 },
+  { UINT64_C(0xd5d238a4abe98068), 109 },
+  { UINT64_C(0x9f4f2726179a2245), 136 },
+  { UINT64_C(0xed63a231d4c4fb27), 162 },
+  { UINT64_C(0xb0de65388cc8ada8), 189 },
+  { UINT64_C(0x83c7088e1aab65db), 216 },
+  { UINT64_C(0xc45d1df942711d9a), 242 },
+  { UINT64_C(0x924d692ca61be758), 269 },
+  { UINT64_C(0xda01ee641a708dea), 295 },
+  { UINT64_C(0xa26da3999aef774a), 322 },
+  { UINT64_C(0xf209787bb47d6b85), 348 },
+  { UINT64_C(0xb454e4a179dd1877), 375 },
+  { UINT64_C(0x865b86925b9bc5c2), 402 },
+  { UINT64_C(0xc83553c5c8965d3d), 428 },
+  { UINT64_C(0x952ab45cfa97a0b3), 455 },
+  { UINT64_C(0xde469fbd99a05fe3), 481 },
+  { UINT64_C(0xa59bc234db398c25), 508 },
+  { UINT64_C(0xf6c69a72a3989f5c), 534 },
+  { UINT64_C(0xb7dcbf5354e9bece), 561 },
+  { UINT64_C(0x88fcf317f22241e2), 588 },
+  { UINT64_C(0xcc20ce9bd35c78a5), 614 },
+  { UINT64_C(0x98165af37b2153df), 641 },
+  { UINT64_C(0xe2a0b5dc971f303a), 667 },
+  { UINT64_C(0xa8d9d1535ce3b396), 694 },
+  { UINT64_C(0xfb9b7cd9a4a7443c), 720 },
+  { UINT64_C(0xbb764c4ca7a44410), 747 },
+  { UINT64_C(0x8bab8eefb6409c1a), 774 },
+  { UINT64_C(0xd01fef10a657842c), 800 },
+  { UINT64_C(0x9b10a4e5e9913129), 827 },
+  { UINT64_C(0xe7109bfba19c0c9d), 853 },
+  { UINT64_C(0xac2820d9623bf429), 880 },
+  { UINT64_C(0x80444b5e7aa7cf85), 907 },
+  { UINT64_C(0xbf21e44003acdd2d), 933 },
+  { UINT64_C(0x8e679c2f5e44ff8f), 960 },
+  { UINT64_C(0xd433179d9c8cb841), 986 },
+  { UINT64_C(0x9e19db92b4e31ba9), 1013 },
+  { UINT64_C(0xeb96bf6ebadf77d9), 1039 },
+  { UINT64_C(0xaf87023b9bf0ee6b), 1066 }
+};
+
+#define JSON_CACHED_POWERS_MIN_EXPONENT (-348)
+#define JSON_CACHED_POWERS_STEP 8
+
+static struct _json_diy_fp_t
+_json_diy_fp_from_double(
+  const double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  const int biased_exponent = (int)((bits & JSON_DP_EXPONENT_MASK) >> JSON_DP_SIGNIFICAND_SIZE);
+  const uint64_t significand = bits & JSON_DP_SIGNIFICAND_MASK;
+
+  struct _json_diy_fp_t fp;
+  if (biased_exponent != 0)
+  {
+    fp.f = significand + JSON_DP_HIDDEN_BIT;
+    fp.e = biased_exponent - JSON_DP_EXPONENT_BIAS;
+  }
+  else
+  {
+    // subnormal
+    fp.f = significand;
+    fp.e = JSON_DP_MIN_EXPONENT + 1;
+  }
+
+  return fp;
+}
+
+static struct _json_diy_fp_t
+_json_diy_fp_multiply(
+  const struct _json_diy_fp_t lhs,
+  const struct _json_diy_fp_t rhs)
+{
+  const uint64_t mask32 = UINT64_C(0xFFFFFFFF);
+  const uint64_t a = lhs.f >> 32;
+  const uint64_t b = lhs.f & mask32;
+  const uint64_t c = rhs.f >> 32;
+  const uint64_t d = rhs.f & mask32;
+
+  const uint64_t ac = a * c;
+  const uint64_t bc = b * c;
+  const uint64_t ad = a * d;
+  const uint64_t bd = b * d;
+
+  uint64_t tmp = (bd >> 32) + (ad & mask32) + (bc & mask32);
+  // round the discarded low half
+  tmp += UINT64_C(1) << 31;
+
+  struct _json_diy_fp_t result = {
+    .f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32),
+    .e = lhs.e + rhs.e + 64
+  };
+  return result;
+}
+
+static struct _json_diy_fp_t
+_json_diy_fp_normalize(
+  struct _json_diy_fp_t fp)
+{
+  while (!(fp.f & (UINT64_C(1) << 63)))
+  {
+    fp.f <<= 1;
+    fp.e--;
+  }
+  return fp;
+}
+
+// the boundaries halfway to the neighbouring doubles, anything strictly
+// between them reads back as value
+static void
+_json_diy_fp_boundaries(
+  const struct _json_diy_fp_t value,
+  struct _json_diy_fp_t* const minus,
+  struct _json_diy_fp_t* const plus)
+{
+  struct _json_diy_fp_t upper = { .f = (value.f << 1) + 1, .e = value.e - 1 };
+  while (!(upper.f & (JSON_DP_HIDDEN_BIT << 1)))
+  {
+    upper.f <<= 1;
+    upper.e--;
+  }
+  upper.f <<= 64 - JSON_DP_SIGNIFICAND_SIZE - 2;
+  upper.e -= 64 - JSON_DP_SIGNIFICAND_SIZE - 2;
+
+  // the gap below a power of two is half as wide
+  struct _json_diy_fp_t lower;
+  if (value.f == JSON_DP_HIDDEN_BIT)
+  {
+    lower.f = (value.f << 2) - 1;
+    lower.e = value.e - 2;
+  }
+  else
+  {
+    lower.f = (value.f << 1) - 1;
+    lower.e = value.e - 1;
+  }
+  lower.f <<= lower.e - upper.e;
+  lower.e = upper.e;
+
+  *minus = lower;
+  *plus = upper;
+}
+
+// picks the cached power that brings a number with exponent e into
+// Grisu's working range, k receives the decimal exponent to undo it
+static struct _json_diy_fp_t
+_json_get_cached_power(
+  const int e,
+  int* const k)
+{
+  // 0.30102999566398114 = log10(2)
+  const double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = (int)dk;
+  if (dk - ik > 0.0)
+    ik++;
+
+  const size_t index = (size_t)((ik >> 3) + 1);
+  *k = -(JSON_CACHED_POWERS_MIN_EXPONENT + (int)index * JSON_CACHED_POWERS_STEP);
+  return _json_cached_powers[index];
+}
+
+static void
+_json_grisu_round(
+  char* const buffer,
+  const size_t len,
+  const uint64_t delta,
+  uint64_t rest,
+  const uint64_t ten_kappa,
+  const uint64_t wp_w)
+{
+  while (rest < wp_w
+      && delta - rest >= ten_kappa
+      && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+  {
+    buffer[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+static size_t
+_json_count_digits(
+  const uint32_t value)
+{
+  size_t n_digits = 1;
+  while (n_digits < 10 && value >= _json_pow10_32[n_digits])
+    n_digits++;
+  return n_digits;
+}
+
+static size_t
+_json_grisu_digit_gen(
+  const struct _json_diy_fp_t w,
+  const struct _json_diy_fp_t mp,
+  uint64_t delta,
+  char* const buffer,
+  int* const k)
+{
+  const struct _json_diy_fp_t one = { .f = UINT64_C(1) << -mp.e, .e = mp.e };
+  const uint64_t wp_w = mp.f - w.f;
+  uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+  uint64_t p2 = mp.f & (one.f - 1);
+  int kappa = (int)_json_count_digits(p1);
+  size_t len = 0;
+
+  while (kappa > 0)
+  {
+    const uint32_t digit = p1 / _json_pow10_32[kappa - 1];
+    p1 %= _json_pow10_32[kappa - 1];
+    if (digit || len)
+      buffer[len++] = '0' + digit;
+    kappa--;
+
+    const uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+    if (rest <= delta)
+    {
+      *k += kappa;
+      _json_grisu_round(buffer, len, delta, rest, (uint64_t)_json_pow10_32[kappa] << -one.e, wp_w);
+      return len;
+    }
+  }
+
+  for (;;)
+  {
+    p2 *= 10;
+    delta *= 10;
+    const char digit = (char)(p2 >> -one.e);
+    if (digit || len)
+      buffer[len++] = '0' + digit;
+    p2 &= one.f - 1;
+    kappa--;
+
+    if (p2 < delta)
+    {
+      *k += kappa;
+      const int index = -kappa;
+      _json_grisu_round(buffer, len, delta, p2, one.f, wp_w * (index < 10 ? _json_pow10_32[index] : 0));
+      return len;
+    }
+  }
+}
+
+// writes the digits of a positive, finite value to buffer and returns
+// how many there are. the value is digits * 10^k
+static size_t
+_json_grisu2(
+  const double value,
+  char* const buffer,
+  int* const k)
+{
+  const struct _json_diy_fp_t v = _json_diy_fp_from_double(value);
+  struct _json_diy_fp_t w_minus;
+  struct _json_diy_fp_t w_plus;
+  _json_diy_fp_boundaries(v, &w_minus, &w_plus);
+
+  const struct _json_diy_fp_t c_mk = _json_get_cached_power(w_plus.e, k);
+  const struct _json_diy_fp_t w = _json_diy_fp_multiply(_json_diy_fp_normalize(v), c_mk);
+  struct _json_diy_fp_t wp = _json_diy_fp_multiply(w_plus, c_mk);
+  struct _json_diy_fp_t wm = _json_diy_fp_multiply(w_minus, c_mk);
+
+  // stay strictly inside the boundaries to absorb the multiplication error
+  wm.f++;
+  wp.f--;
+
+  return _json_grisu_digit_gen(w, wp, wp.f - wm.f, buffer, k);
+}
+
+static size_t
+_json_write_exponent(
+  int exponent,
+  char* const buffer)
+{
+  size_t len = 0;
+  if (exponent < 0)
+  {
+    buffer[len++] = '-';
+    exponent = -exponent;
+  }
+
+  return len + _json_format_uint32((uint32_t)exponent, &buffer[len]);
+}
+
+// lays out digits * 10^k as either plain decimal or scientific notation.
+// plain output always gets a fractional part (e.g., "5.0") so it's read
+// back as a decimal rather than an int
+static size_t
+_json_prettify_decimal(
+  char* const buffer,
+  const size_t len,
+  const int k)
+{
+  const int n = (int)len;
+  // 10^(kk - 1) <= value < 10^kk
+  const int kk = n + k;
+
+  if (k >= 0 && kk <= 21)
+  {
+    // 1234e7 -> 12340000000.0
+    for (int i = n; i < kk; ++i)
+      buffer[i] = '0';
+    buffer[kk] = '.';
+    buffer[kk + 1] = '0';
+    return (size_t)kk + 2;
+  }
+
+  if (kk > 0 && kk <= 21)
+  {
+    // 1234e-2 -> 12.34
+    memmove(&buffer[kk + 1], &buffer[kk], (size_t)(n - kk));
+    buffer[kk] = '.';
+    return len + 1;
+  }
+
+  if (kk > -6 && kk <= 0)
+  {
+    // 1234e-6 -> 0.001234
+    const int offset = 2 - kk;
+    memmove(&buffer[offset], buffer, len);
+    buffer[0] = '0';
+    buffer[1] = '.';
+    for (int i = 2; i < offset; ++i)
+      buffer[i] = '0';
+    return len + (size_t)offset;
+  }
+
+  if (n == 1)
+  {
+    // 1e30
+    buffer[1] = 'e';
+    return 2 + _json_write_exponent(kk - 1, &buffer[2]);
+  }
+
+  // 1234e30 -> 1.234e33
+  memmove(&buffer[2], &buffer[1], len - 1);
+  buffer[1] = '.';
+  buffer[len + 1] = 'e';
+  return len + 2 + _json_write_exponent(kk - 1, &buffer[len + 2]);
+}
+
+size_t
+_json_format_decimal(
+  const double value,
+  char* const buffer)
+{
+  // JSON has no representation for these
+  if (isnan(value) || isinf(value))
+  {
+    memcpy(buffer, "null", 4);
+    return 4;
+  }
+
+  size_t len = 0;
+  if (signbit(value))
+    buffer[len++] = '-';
+
+  if (value == 0.0)
+  {
+    memcpy(&buffer[len], "0.0", 3);
+    return len + 3;
+  }
+
+  int k = 0;
+  const size_t n_digits = _json_grisu2(fabs(value), &buffer[len], &k);
+  return len + _json_prettify_decimal(&buffer[len], n_digits, k);
+}
+
+// ---- parsing ----
+//
+// numbers are converted straight from the input with no copies, no
+// allocation and no dependence on the C locale (strtod reads the decimal
+// point from it). doubles try, in order: Clinger's fast path (exact when
+// the digits and the power of ten both fit in a double), the
+// Eisel-Lemire algorithm (Lemire, "Number Parsing at a Gigabyte per
+// Second") and, for the rare inputs those can't decide, an exact
+// big-integer comparison against the halfway point between neighbouring
+// doubles.
+
+// 10^0 through 10^22 are exactly representable as doubles
+static const double _json_exact_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define JSON_POW5_MIN_EXPONENT (-342)
+#define JSON_POW5_MAX_EXPONENT 308
+
+// 128-bit approximations of 5^q for q = -342, ..., 308 as {high, low},
+// normalized so the top bit is set. positive powers are truncated and
+// negative ones are 2^b / 5^-q + 1, the same tables as the fast_float
+// library
+static const uint64_t _json_pow5_128[][2] = {
+  { UINT64_C(0xeef453d6923bd65a), UINT64_C(0x113faa2906a13b3f) }, // 5^-342
+  { UINT64_C(0x9558b4661b6565f8), UINT64_C(0x4ac7ca59a424c507) }, // 5^-341
+  { UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x5d79bcf00d2df649) }, // 5^-340
+  { UINT64_C(0xe95a99df8ace6f53), UINT64_C(0xf4d82c2c107973dc) }, // 5^-339
+  { UINT64_C(0x91d8a02bb6c10594), UINT64_C(0x79071b9b8a4be869) }, // 5^-338
+  { UINT64_C(0xb64ec836a47146f9), UINT64_C(0x9748e2826cdee284) }, // 5^-337
+  { UINT64_C(0xe3e27a444d8d98b7), UINT64_C(0xfd1b1b2308169b25) }, // 5^-336
+  { UINT64_C(0x8e6d8c6ab0787f72), UINT64_C(0xfe30f0f5e50e20f7) }, // 5^-335
+  { UINT64_C(0xb208ef855c969f4f), UINT64_C(0xbdbd2d335e51a935) }, // 5^-334
+  { UINT64_C(0xde8b2b66b3bc4723), UINT64_C(0xad2c788035e61382) }, // 5^-333
+  { UINT64_C(0x8b16fb203055ac76), UINT64_C(0x4c3bcb5021afcc31) }, // 5^-332
+  { UINT64_C(0xaddcb9e83c6b1793), UINT64_C(0xdf4abe242a1bbf3d) }, // 5^-331
+  { UINT64_C(0xd953e8624b85dd78), UINT64_C(0xd71d6dad34a2af0d) }, // 5^-330
+  { UINT64_C(0x87d4713d6f33aa6b), UINT64_C(0x8672648c40e5ad68) }, // 5^-329
+  { UINT64_C(0xa9c98d8ccb009506), UINT64_C(0x680efdaf511f18c2) }, // 5^-328
+  { UINT64_C(0xd43bf0effdc0ba48), UINT64_C(0x0212bd1b2566def2) }, // 5^-327
+  { UINT64_C(0x84a57695fe98746d), UINT64_C(0x014bb630f7604b57) }, // 5^-326
+  { UINT64_C(0xa5ced43b7e3e9188), UINT64_C(0x419ea3bd35385e2d) }, // 5^-325
+  { UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x52064cac828675b9) }, // 5^-324
+  { UINT64_C(0x818995ce7aa0e1b2), UINT64_C(0x7343efebd1940993) }, // 5^-323
+  { UINT64_C(0xa1ebfb4219491a1f), UINT64_C(0x1014ebe6c5f90bf8) }, // 5^-322
+  { UINT64_C(0xca66fa129f9b60a6), UINT64_C(0xd41a26e077774ef6) }, // 5^-321
+  { UINT64_C(0xfd00b897478238d0), UINT64_C(0x8920b098955522b4) }, // 5^-320
+  { UINT64_C(0x9e20735e8cb16382), UINT64_C(0x55b46e5f5d5535b0) }, // 5^-319
+  { UINT64_C(0xc5a890362fddbc62), UINT64_C(0xeb2189f734aa831d) }, // 5^-318
+  { UINT64_C(0xf712b443bbd52b7b), UINT64_C(0xa5e9ec7501d523e4) }, // 5^-317
+  { UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0x47b233c92125366e) }, // 5^-316
+  { UINT64_C(0xc1069cd4eabe89f8), UINT64_C(0x999ec0bb696e840a) }, // 5^-315
+  { UINT64_C(0xf148440a256e2c76), UINT64_C(0xc00670ea43ca250d) }, // 5^-314
+  { UINT64_C(0x96cd2a865764dbca), UINT64_C(0x380406926a5e5728) }, // 5^-313
+  { UINT64_C(0xbc807527ed3e12bc), UINT64_C(0xc605083704f5ecf2) }, // 5^-312
+  { UINT64_C(0xeba09271e88d976b), UINT64_C(0xf7864a44c633682e) }, // 5^-311
+  { UINT64_C(0x93445b8731587ea3), UINT64_C(0x7ab3ee6afbe0211d) }, // 5^-310
+  { UINT64_C(0xb8157268fdae9e4c), UINT64_C(0x5960ea05bad82964) }, // 5^-309
+  { UINT64_C(0xe61acf033d1a45df), UINT64_C(0x6fb92487298e33bd) }, // 5^-308
+  { UINT64_C(0x8fd0c16206306bab), UINT64_C(0xa5d3b6d479f8e056) }, // 5^-307
+  { UINT64_C(0xb3c4f1ba87bc8696), UINT64_C(0x8f48a4899877186c) }, // 5^-306
+  { UINT64_C(0xe0b62e2929aba83c), UINT64_C(0x331acdabfe94de87) }, // 5^-305
+  { UINT64_C(0x8c71dcd9ba0b4925), UINT64_C(0x9ff0c08b7f1d0b14) }, // 5^-304
+  { UINT64_C(0xaf8e5410288e1b6f), UINT64_C(0x07ecf0ae5ee44dd9) }, // 5^-303
+  { UINT64_C(0xdb71e91432b1a24a), UINT64_C(0xc9e82cd9f69d6150) }, // 5^-302
+  { UINT64_C(0x892731ac9faf056e), UINT64_C(0xbe311c083a225cd2) }, // 5^-301
+  { UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0x6dbd630a48aaf406) }, // 5^-300
+  { UINT64_C(0xd64d3d9db981787d), UINT64_C(0x092cbbccdad5b108) }, // 5^-299
+  { UINT64_C(0x85f0468293f0eb4e), UINT64_C(0x25bbf56008c58ea5) }, // 5^-298
+  { UINT64_C(0xa76c582338ed2621), UINT64_C(0xaf2af2b80af6f24e) }, // 5^-297
+  { UINT64_C(0xd1476e2c07286faa), UINT64_C(0x1af5af660db4aee1) }, // 5^-296
+  { UINT64_C(0x82cca4db847945ca), UINT64_C(0x50d98d9fc890ed4d) }, // 5^-295
+  { UINT64_C(0xa37fce126597973c), UINT64_C(0xe50ff107bab528a0) }, // 5^-294
+  { UINT64_C(0xcc5fc196fefd7d0c), UINT64_C(0x1e53ed49a96272c8) }, // 5^-293
+  { UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0x25e8e89c13bb0f7a) }, // 5^-292
+  { UINT64_C(0x9faacf3df73609b1), UINT64_C(0x77b191618c54e9ac) }, // 5^-291
+  { UINT64_C(0xc795830d75038c1d), UINT64_C(0xd59df5b9ef6a2417) }, // 5^-290
+  { UINT64_C(0xf97ae3d0d2446f25), UINT64_C(0x4b0573286b44ad1d) }, // 5^-289
+  { UINT64_C(0x9becce62836ac577), UINT64_C(0x4ee367f9430aec32) }, // 5^-288
+  { UINT64_C(0xc2e801fb244576d5), UINT64_C(0x229c41f793cda73f) }, // 5^-287
+  { UINT64_C(0xf3a20279ed56d48a), UINT64_C(0x6b43527578c1110f) }, // 5^-286
+  { UINT64_C(0x9845418c345644d6), UINT64_C(0x830a13896b78aaa9) }, // 5^-285
+  { UINT64_C(0xbe5691ef416bd60c), UINT64_C(0x23cc986bc656d553) }, // 5^-284
+  { UINT64_C(0xedec366b11c6cb8f), UINT64_C(0x2cbfbe86b7ec8aa8) }, // 5^-283
+  { UINT64_C(0x94b3a202eb1c3f39), UINT64_C(0x7bf7d71432f3d6a9) }, // 5^-282
+  { UINT64_C(0xb9e08a83a5e34f07), UINT64_C(0xdaf5ccd93fb0cc53) }, // 5^-281
+  { UINT64_C(0xe858ad248f5c22c9), UINT64_C(0xd1b3400f8f9cff68) }, // 5^-280
+  { UINT64_C(0x91376c36d99995be), UINT64_C(0x23100809b9c21fa1) }, // 5^-279
+  { UINT64_C(0xb58547448ffffb2d), UINT64_C(0xabd40a0c2832a78a) }, // 5^-278
+  { UINT64_C(0xe2e69915b3fff9f9), UINT64_C(0x16c90c8f323f516c) }, // 5^-277
+  { UINT64_C(0x8dd01fad907ffc3b), UINT64_C(0xae3da7d97f6792e3) }, // 5^-276
+  { UINT64_C(0xb1442798f49ffb4a), UINT64_C(0x99cd11cfdf41779c) }, // 5^-275
+  { UINT64_C(0xdd95317f31c7fa1d), UINT64_C(0x40405643d711d583) }, // 5^-274
+  { UINT64_C(0x8a7d3eef7f1cfc52), UINT64_C(0x482835ea666b2572) }, // 5^-273
+  { UINT64_C(0xad1c8eab5ee43b66), UINT64_C(0xda3243650005eecf) }, // 5^-272
+  { UINT64_C(0xd863b256369d4a40), UINT64_C(0x90bed43e40076a82) }, // 5^-271
+  { UINT64_C(0x873e4f75e2224e68), UINT64_C(0x5a7744a6e804a291) }, // 5^-270
+  { UINT64_C(0xa90de3535aaae202), UINT64_C(0x711515d0a205cb36) }, // 5^-269
+  { UINT64_C(0xd3515c2831559a83), UINT64_C(0x0d5a5b44ca873e03) }, // 5^-268
+  { UINT64_C(0x8412d9991ed58091), UINT64_C(0xe858790afe9486c2) }, // 5^-267
+  { UINT64_C(0xa5178fff668ae0b6), UINT64_C(0x626e974dbe39a872) }, // 5^-266
+  { UINT64_C(0xce5d73ff402d98e3), UINT64_C(0xfb0a3d212dc8128f) }, // 5^-265
+  { UINT64_C(0x80fa687f881c7f8e), UINT64_C(0x7ce66634bc9d0b99) }, // 5^-264
+  { UINT64_C(0xa139029f6a239f72), UINT64_C(0x1c1fffc1ebc44e80) }, // 5^-263
+  { UINT64_C(0xc987434744ac874e), UINT64_C(0xa327ffb266b56220) }, // 5^-262
+  { UINT64_C(0xfbe9141915d7a922), UINT64_C(0x4bf1ff9f0062baa8) }, // 5^-261
+  { UINT64_C(0x9d71ac8fada6c9b5), UINT64_C(0x6f773fc3603db4a9) }, // 5^-260
+  { UINT64_C(0xc4ce17b399107c22), UINT64_C(0xcb550fb4384d21d3) }, // 5^-259
+  { UINT64_C(0xf6019da07f549b2b), UINT64_C(0x7e2a53a146606a48) }, // 5^-258
+  { UINT64_C(0x99c102844f94e0fb), UINT64_C(0x2eda7444cbfc426d) }, // 5^-257
+  { UINT64_C(0xc0314325637a1939), UINT64_C(0xfa911155fefb5308) }, // 5^-256
+  { UINT64_C(0xf03d93eebc589f88), UINT64_C(0x793555ab7eba27ca) }, // 5^-255
+  { UINT64_C(0x96267c7535b763b5), UINT64_C(0x4bc1558b2f3458de) }, // 5^-254
+  { UINT64_C(0xbbb01b9283253ca2), UINT64_C(0x9eb1aaedfb016f16) }, // 5^-253
+  { UINT64_C(0xea9c227723ee8bcb), UINT64_C(0x465e15a979c1cadc) }, // 5^-252
+  { UINT64_C(0x92a1958a7675175f), UINT64_C(0x0bfacd89ec191ec9) }, // 5^-251
+  { UINT64_C(0xb749faed14125d36), UINT64_C(0xcef980ec671f667b) }, // 5^-250
+  { UINT64_C(0xe51c79a85916f484), UINT64_C(0x82b7e12780e7401a) }, // 5^-249
+  { UINT64_C(0x8f31cc0937ae58d2), UINT64_C(0xd1b2ecb8b0908810) }, // 5^-248
+  { UINT64_C(0xb2fe3f0b8599ef07), UINT64_C(0x861fa7e6dcb4aa15) }, // 5^-247
+  { UINT64_C(0xdfbdcece67006ac9), UINT64_C(0x67a791e093e1d49a) }, // 5^-246
+  { UINT64_C(0x8bd6a141006042bd), UINT64_C(0xe0c8bb2c5c6d24e0) }, // 5^-245
+  { UINT64_C(0xaecc49914078536d), UINT64_C(0x58fae9f773886e18) }, // 5^-244
+  { UINT64_C(0xda7f5bf590966848), UINT64_C(0xaf39a475506a899e) }, // 5^-243
+  { UINT64_C(0x888f99797a5e012d), UINT64_C(0x6d8406c952429603) }, // 5^-242
+  { UINT64_C(0xaab37fd7d8f58178), UINT64_C(0xc8e5087ba6d33b83) }, // 5^-241
+  { UINT64_C(0xd5605fcdcf32e1d6), UINT64_C(0xfb1e4a9a90880a64) }, // 5^-240
+  { UINT64_C(0x855c3be0a17fcd26), UINT64_C(0x5cf2eea09a55067f) }, // 5^-239
+  { UINT64_C(0xa6b34ad8c9dfc06f), UINT64_C(0xf42faa48c0ea481e) }, // 5^-238
+  { UINT64_C(0xd0601d8efc57b08b), UINT64_C(0xf13b94daf124da26) }, // 5^-237
+  { UINT64_C(0x823c12795db6ce57), UINT64_C(0x76c53d08d6b70858) }, // 5^-236
+  { UINT64_C(0xa2cb1717b52481ed), UINT64_C(0x54768c4b0c64ca6e) }, // 5^-235
+  { UINT64_C(0xcb7ddcdda26da268), UINT64_C(0xa9942f5dcf7dfd09) }, // 5^-234
+  { UINT64_C(0xfe5d54150b090b02), UINT64_C(0xd3f93b35435d7c4c) }, // 5^-233
+  { UINT64_C(0x9efa548d26e5a6e1), UINT64_C(0xc47bc5014a1a6daf) }, // 5^-232
+  { UINT64_C(0xc6b8e9b0709f109a), UINT64_C(0x359ab6419ca1091b) }, // 5^-231
+  { UINT64_C(0xf867241c8cc6d4c0), UINT64_C(0xc30163d203c94b62) }, // 5^-230
+  { UINT64_C(0x9b407691d7fc44f8), UINT64_C(0x79e0de63425dcf1d) }, // 5^-229
+  { UINT64_C(0xc21094364dfb5636), UINT64_C(0x985915fc12f542e4) }, // 5^-228
+  { UINT64_C(0xf294b943e17a2bc4), UINT64_C(0x3e6f5b7b17b2939d) }, // 5^-227
+  { UINT64_C(0x979cf3ca6cec5b5a), UINT64_C(0xa705992ceecf9c42) }, // 5^-226
+  { UINT64_C(0xbd8430bd08277231), UINT64_C(0x50c6ff782a838353) }, // 5^-225
+  { UINT64_C(0xece53cec4a314ebd), UINT64_C(0xa4f8bf5635246428) }, // 5^-224
+  { UINT64_C(0x940f4613ae5ed136), UINT64_C(0x871b7795e136be99) }, // 5^-223
+  { UINT64_C(0xb913179899f68584), UINT64_C(0x28e2557b59846e3f) }, // 5^-222
+  { UINT64_C(0xe757dd7ec07426e5), UINT64_C(0x331aeada2fe589cf) }, // 5^-221
+  { UINT64_C(0x9096ea6f3848984f), UINT64_C(0x3ff0d2c85def7621) }, // 5^-220
+  { UINT64_C(0xb4bca50b065abe63), UINT64_C(0x0fed077a756b53a9) }, // 5^-219
+  { UINT64_C(0xe1ebce4dc7f16dfb), UINT64_C(0xd3e8495912c62894) }, // 5^-218
+  { UINT64_C(0x8d3360f09cf6e4bd), UINT64_C(0x64712dd7abbbd95c) }, // 5^-217
+  { UINT64_C(0xb080392cc4349dec), UINT64_C(0xbd8d794d96aacfb3) }, // 5^-216
+  { UINT64_C(0xdca04777f541c567), UINT64_C(0xecf0d7a0fc5583a0) }, // 5^-215
+  { UINT64_C(0x89e42caaf9491b60), UINT64_C(0xf41686c49db57244) }, // 5^-214
+  { UINT64_C(0xac5d37d5b79b6239), UINT64_C(0x311c2875c522ced5) }, // 5^-213
+  { UINT64_C(0xd77485cb25823ac7), UINT64_C(0x7d633293366b828b) }, // 5^-212
+  { UINT64_C(0x86a8d39ef77164bc), UINT64_C(0xae5dff9c02033197) }, // 5^-211
+  { UINT64_C(0xa8530886b54dbdeb), UINT64_C(0xd9f57f830283fdfc) }, // 5^-210
+  { UINT64_C(0xd267caa862a12d66), UINT64_C(0xd072df63c324fd7b) }, // 5^-209
+  { UINT64_C(0x8380dea93da4bc60), UINT64_C(0x4247cb9e59f71e6d) }, // 5^-208
+  { UINT64_C(0xa46116538d0deb78), UINT64_C(0x52d9be85f074e608) }, // 5^-207
+  { UINT64_C(0xcd795be870516656), UINT64_C(0x67902e276c921f8b) }, // 5^-206
+  { UINT64_C(0x806bd9714632dff6), UINT64_C(0x00ba1cd8a3db53b6) }, // 5^-205
+  { UINT64_C(0xa086cfcd97bf97f3), UINT64_C(0x80e8a40eccd228a4) }, // 5^-204
+  { UINT64_C(0xc8a883c0fdaf7df0), UINT64_C(0x6122cd128006b2cd) }, // 5^-203
+  { UINT64_C(0xfad2a4b13d1b5d6c), UINT64_C(0x796b805720085f81) }, // 5^-202
+  { UINT64_C(0x9cc3a6eec6311a63), UINT64_C(0xcbe3303674053bb0) }, // 5^-201
+  { UINT64_C(0xc3f490aa77bd60fc), UINT64_C(0xbedbfc4411068a9c) }, // 5^-200
+  { UINT64_C(0xf4f1b4d515acb93b), UINT64_C(0xee92fb5515482d44) }, // 5^-199
+  { UINT64_C(0x991711052d8bf3c5), UINT64_C(0x751bdd152d4d1c4a) }, // 5^-198
+  { UINT64_C(0xbf5cd54678eef0b6), UINT64_C(0xd262d45a78a0635d) }, // 5^-197
+  { UINT64_C(0xef340a98172aace4), UINT64_C(0x86fb897116c87c34) }, // 5^-196
+  { UINT64_C(0x9580869f0e7aac0e), UINT64_C(0xd45d35e6ae3d4da0) }, // 5^-195
+  { UINT64_C(0xbae0a846d2195712), UINT64_C(0x8974836059cca109) }, // 5^-194
+  { UINT64_C(0xe998d258869facd7), UINT64_C(0x2bd1a438703fc94b) }, // 5^-193
+  { UINT64_C(0x91ff83775423cc06), UINT64_C(0x7b6306a34627ddcf) }, // 5^-192
+  { UINT64_C(0xb67f6455292cbf08), UINT64_C(0x1a3bc84c17b1d542) }, // 5^-191
+  { UINT64_C(0xe41f3d6a7377eeca), UINT64_C(0x20caba5f1d9e4a93) }, // 5^-190
+  { UINT64_C(0x8e938662882af53e), UINT64_C(0x547eb47b7282ee9c) }, // 5^-189
+  { UINT64_C(0xb23867fb2a35b28d), UINT64_C(0xe99e619a4f23aa43) }, // 5^-188
+  { UINT64_C(0xdec681f9f4c31f31), UINT64_C(0x6405fa00e2ec94d4) }, // 5^-187
+  { UINT64_C(0x8b3c113c38f9f37e), UINT64_C(0xde83bc408dd3dd04) }, // 5^-186
+  { UINT64_C(0xae0b158b4738705e), UINT64_C(0x9624ab50b148d445) }, // 5^-185
+  { UINT64_C(0xd98ddaee19068c76), UINT64_C(0x3badd624dd9b0957) }, // 5^-184
+  { UINT64_C(0x87f8a8d4cfa417c9), UINT64_C(0xe54ca5d70a80e5d6) }, // 5^-183
+  { UINT64_C(0xa9f6d30a038d1dbc), UINT64_C(0x5e9fcf4ccd211f4c) }, // 5^-182
+  { UINT64_C(0xd47487cc8470652b), UINT64_C(0x7647c3200069671f) }, // 5^-181
+  { UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0x29ecd9f40041e073) }, // 5^-180
+  { UINT64_C(0xa5fb0a17c777cf09), UINT64_C(0xf468107100525890) }, // 5^-179
+  { UINT64_C(0xcf79cc9db955c2cc), UINT64_C(0x7182148d4066eeb4) }, // 5^-178
+  { UINT64_C(0x81ac1fe293d599bf), UINT64_C(0xc6f14cd848405530) }, // 5^-177
+  { UINT64_C(0xa21727db38cb002f), UINT64_C(0xb8ada00e5a506a7c) }, // 5^-176
+  { UINT64_C(0xca9cf1d206fdc03b), UINT64_C(0xa6d90811f0e4851c) }, // 5^-175
+  { UINT64_C(0xfd442e4688bd304a), UINT64_C(0x908f4a166d1da663) }, // 5^-174
+  { UINT64_C(0x9e4a9cec15763e2e), UINT64_C(0x9a598e4e043287fe) }, // 5^-173
+  { UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x40eff1e1853f29fd) }, // 5^-172
+  { UINT64_C(0xf7549530e188c128), UINT64_C(0xd12bee59e68ef47c) }, // 5^-171
+  { UINT64_C(0x9a94dd3e8cf578b9), UINT64_C(0x82bb74f8301958ce) }, // 5^-170
+  { UINT64_C(0xc13a148e3032d6e7), UINT64_C(0xe36a52363c1faf01) }, // 5^-169
+  { UINT64_C(0xf18899b1bc3f8ca1), UINT64_C(0xdc44e6c3cb279ac1) }, // 5^-168
+  { UINT64_C(0x96f5600f15a7b7e5), UINT64_C(0x29ab103a5ef8c0b9) }, // 5^-167
+  { UINT64_C(0xbcb2b812db11a5de), UINT64_C(0x7415d448f6b6f0e7) }, // 5^-166
+  { UINT64_C(0xebdf661791d60f56), UINT64_C(0x111b495b3464ad21) }, // 5^-165
+  { UINT64_C(0x936b9fcebb25c995), UINT64_C(0xcab10dd900beec34) }, // 5^-164
+  { UINT64_C(0xb84687c269ef3bfb), UINT64_C(0x3d5d514f40eea742) }, // 5^-163
+  { UINT64_C(0xe65829b3046b0afa), UINT64_C(0x0cb4a5a3112a5112) }, // 5^-162
+  { UINT64_C(0x8ff71a0fe2c2e6dc), UINT64_C(0x47f0e785eaba72ab) }, // 5^-161
+  { UINT64_C(0xb3f4e093db73a093), UINT64_C(0x59ed216765690f56) }, // 5^-160
+  { UINT64_C(0xe0f218b8d25088b8), UINT64_C(0x306869c13ec3532c) }, // 5^-159
+  { UINT64_C(0x8c974f7383725573), UINT64_C(0x1e414218c73a13fb) }, // 5^-158
+  { UINT64_C(0xafbd2350644eeacf), UINT64_C(0xe5d1929ef90898fa) }, // 5^-157
+  { UINT64_C(0xdbac6c247d62a583), UINT64_C(0xdf45f746b74abf39) }, // 5^-156
+  { UINT64_C(0x894bc396ce5da772), UINT64_C(0x6b8bba8c328eb783) }, // 5^-155
+  { UINT64_C(0xab9eb47c81f5114f), UINT64_C(0x066ea92f3f326564) }, // 5^-154
+  { UINT64_C(0xd686619ba27255a2), UINT64_C(0xc80a537b0efefebd) }, // 5^-153
+  { UINT64_C(0x8613fd0145877585), UINT64_C(0xbd06742ce95f5f36) }, // 5^-152
+  { UINT64_C(0xa798fc4196e952e7), UINT64_C(0x2c48113823b73704) }, // 5^-151
+  { UINT64_C(0xd17f3b51fca3a7a0), UINT64_C(0xf75a15862ca504c5) }, // 5^-150
+  { UINT64_C(0x82ef85133de648c4), UINT64_C(0x9a984d73dbe722fb) }, // 5^-149
+  { UINT64_C(0xa3ab66580d5fdaf5), UINT64_C(0xc13e60d0d2e0ebba) }, // 5^-148
+  { UINT64_C(0xcc963fee10b7d1b3), UINT64_C(0x318df905079926a8) }, // 5^-147
+  { UINT64_C(0xffbbcfe994e5c61f), UINT64_C(0xfdf17746497f7052) }, // 5^-146
+  { UINT64_C(0x9fd561f1fd0f9bd3), UINT64_C(0xfeb6ea8bedefa633) }, // 5^-145
+  { UINT64_C(0xc7caba6e7c5382c8), UINT64_C(0xfe64a52ee96b8fc0) }, // 5^-144
+  { UINT64_C(0xf9bd690a1b68637b), UINT64_C(0x3dfdce7aa3c673b0) }, // 5^-143
+  { UINT64_C(0x9c1661a651213e2d), UINT64_C(0x06bea10ca65c084e) }, // 5^-142
+  { UINT64_C(0xc31bfa0fe5698db8), UINT64_C(0x486e494fcff30a62) }, // 5^-141
+  { UINT64_C(0xf3e2f893dec3f126), UINT64_C(0x5a89dba3c3efccfa) }, // 5^-140
+  { UINT64_C(0x986ddb5c6b3a76b7), UINT64_C(0xf89629465a75e01c) }, // 5^-139
+  { UINT64_C(0xbe89523386091465), UINT64_C(0xf6bbb397f1135823) }, // 5^-138
+  { UINT64_C(0xee2ba6c0678b597f), UINT64_C(0x746aa07ded582e2c) }, // 5^-137
+  { UINT64_C(0x94db483840b717ef), UINT64_C(0xa8c2a44eb4571cdc) }, // 5^-136
+  { UINT64_C(0xba121a4650e4ddeb), UINT64_C(0x92f34d62616ce413) }, // 5^-135
+  { UINT64_C(0xe896a0d7e51e1566), UINT64_C(0x77b020baf9c81d17) }, // 5^-134
+  { UINT64_C(0x915e2486ef32cd60), UINT64_C(0x0ace1474dc1d122e) }, // 5^-133
+  { UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x0d819992132456ba) }, // 5^-132
+  { UINT64_C(0xe3231912d5bf60e6), UINT64_C(0x10e1fff697ed6c69) }, // 5^-131
+  { UINT64_C(0x8df5efabc5979c8f), UINT64_C(0xca8d3ffa1ef463c1) }, // 5^-130
+  { UINT64_C(0xb1736b96b6fd83b3), UINT64_C(0xbd308ff8a6b17cb2) }, // 5^-129
+  { UINT64_C(0xddd0467c64bce4a0), UINT64_C(0xac7cb3f6d05ddbde) }, // 5^-128
+  { UINT64_C(0x8aa22c0dbef60ee4), UINT64_C(0x6bcdf07a423aa96b) }, // 5^-127
+  { UINT64_C(0xad4ab7112eb3929d), UINT64_C(0x86c16c98d2c953c6) }, // 5^-126
+  { UINT64_C(0xd89d64d57a607744), UINT64_C(0xe871c7bf077ba8b7) }, // 5^-125
+  { UINT64_C(0x87625f056c7c4a8b), UINT64_C(0x11471cd764ad4972) }, // 5^-124
+  { UINT64_C(0xa93af6c6c79b5d2d), UINT64_C(0xd598e40d3dd89bcf) }, // 5^-123
+  { UINT64_C(0xd389b47879823479), UINT64_C(0x4aff1d108d4ec2c3) }, // 5^-122
+  { UINT64_C(0x843610cb4bf160cb), UINT64_C(0xcedf722a585139ba) }, // 5^-121
+  { UINT64_C(0xa54394fe1eedb8fe), UINT64_C(0xc2974eb4ee658828) }, // 5^-120
+  { UINT64_C(0xce947a3da6a9273e), UINT64_C(0x733d226229feea32) }, // 5^-119
+  { UINT64_C(0x811ccc668829b887), UINT64_C(0x0806357d5a3f525f) }, // 5^-118
+  { UINT64_C(0xa163ff802a3426a8), UINT64_C(0xca07c2dcb0cf26f7) }, // 5^-117
+  { UINT64_C(0xc9bcff6034c13052), UINT64_C(0xfc89b393dd02f0b5) }, // 5^-116
+  { UINT64_C(0xfc2c3f3841f17c67), UINT64_C(0xbbac2078d443ace2) }, // 5^-115
+  { UINT64_C(0x9d9ba7832936edc0), UINT64_C(0xd54b944b84aa4c0d) }, // 5^-114
+  { UINT64_C(0xc5029163f384a931), UINT64_C(0x0a9e795e65d4df11) }, // 5^-113
+  { UINT64_C(0xf64335bcf065d37d), UINT64_C(0x4d4617b5ff4a16d5) }, // 5^-112
+  { UINT64_C(0x99ea0196163fa42e), UINT64_C(0x504bced1bf8e4e45) }, // 5^-111
+  { UINT64_C(0xc06481fb9bcf8d39), UINT64_C(0xe45ec2862f71e1d6) }, // 5^-110
+  { UINT64_C(0xf07da27a82c37088), UINT64_C(0x5d767327bb4e5a4c) }, // 5^-109
+  { UINT64_C(0x964e858c91ba2655), UINT64_C(0x3a6a07f8d510f86f) }, // 5^-108
+  { UINT64_C(0xbbe226efb628afea), UINT64_C(0x890489f70a55368b) }, // 5^-107
+  { UINT64_C(0xeadab0aba3b2dbe5), UINT64_C(0x2b45ac74ccea842e) }, // 5^-106
+  { UINT64_C(0x92c8ae6b464fc96f), UINT64_C(0x3b0b8bc90012929d) }, // 5^-105
+  { UINT64_C(0xb77ada0617e3bbcb), UINT64_C(0x09ce6ebb40173744) }, // 5^-104
+  { UINT64_C(0xe55990879ddcaabd), UINT64_C(0xcc420a6a101d0515) }, // 5^-103
+  { UINT64_C(0x8f57fa54c2a9eab6), UINT64_C(0x9fa946824a12232d) }, // 5^-102
+  { UINT64_C(0xb32df8e9f3546564), UINT64_C(0x47939822dc96abf9) }, // 5^-101
+  { UINT64_C(0xdff9772470297ebd), UINT64_C(0x59787e2b93bc56f7) }, // 5^-100
+  { UINT64_C(0x8bfbea76c619ef36), UINT64_C(0x57eb4edb3c55b65a) }, // 5^-99
+  { UINT64_C(0xaefae51477a06b03), UINT64_C(0xede622920b6b23f1) }, // 5^-98
+  { UINT64_C(0xdab99e59958885c4), UINT64_C(0xe95fab368e45eced) }, // 5^-97
+  { UINT64_C(0x88b402f7fd75539b), UINT64_C(0x11dbcb0218ebb414) }, // 5^-96
+  { UINT64_C(0xaae103b5fcd2a881), UINT64_C(0xd652bdc29f26a119) }, // 5^-95
+  { UINT64_C(0xd59944a37c0752a2), UINT64_C(0x4be76d3346f0495f) }, // 5^-94
+  { UINT64_C(0x857fcae62d8493a5), UINT64_C(0x6f70a4400c562ddb) }, // 5^-93
+  { UINT64_C(0xa6dfbd9fb8e5b88e), UINT64_C(0xcb4ccd500f6bb952) }, // 5^-92
+  { UINT64_C(0xd097ad07a71f26b2), UINT64_C(0x7e2000a41346a7a7) }, // 5^-91
+  { UINT64_C(0x825ecc24c873782f), UINT64_C(0x8ed400668c0c28c8) }, // 5^-90
+  { UINT64_C(0xa2f67f2dfa90563b), UINT64_C(0x728900802f0f32fa) }, // 5^-89
+  { UINT64_C(0xcbb41ef979346bca), UINT64_C(0x4f2b40a03ad2ffb9) }, // 5^-88
+  { UINT64_C(0xfea126b7d78186bc), UINT64_C(0xe2f610c84987bfa8) }, // 5^-87
+  { UINT64_C(0x9f24b832e6b0f436), UINT64_C(0x0dd9ca7d2df4d7c9) }, // 5^-86
+  { UINT64_C(0xc6ede63fa05d3143), UINT64_C(0x91503d1c79720dbb) }, // 5^-85
+  { UINT64_C(0xf8a95fcf88747d94), UINT64_C(0x75a44c6397ce912a) }, // 5^-84
+  { UINT64_C(0x9b69dbe1b548ce7c), UINT64_C(0xc986afbe3ee11aba) }, // 5^-83
+  { UINT64_C(0xc24452da229b021b), UINT64_C(0xfbe85badce996168) }, // 5^-82
+  { UINT64_C(0xf2d56790ab41c2a2), UINT64_C(0xfae27299423fb9c3) }, // 5^-81
+  { UINT64_C(0x97c560ba6b0919a5), UINT64_C(0xdccd879fc967d41a) }, // 5^-80
+  { UINT64_C(0xbdb6b8e905cb600f), UINT64_C(0x5400e987bbc1c920) }, // 5^-79
+  { UINT64_C(0xed246723473e3813), UINT64_C(0x290123e9aab23b68) }, // 5^-78
+  { UINT64_C(0x9436c0760c86e30b), UINT64_C(0xf9a0b6720aaf6521) }, // 5^-77
+  { UINT64_C(0xb94470938fa89bce), UINT64_C(0xf808e40e8d5b3e69) }, // 5^-76
+  { UINT64_C(0xe7958cb87392c2c2), UINT64_C(0xb60b1d1230b20e04) }, // 5^-75
+  { UINT64_C(0x90bd77f3483bb9b9), UINT64_C(0xb1c6f22b5e6f48c2) }, // 5^-74
+  { UINT64_C(0xb4ecd5f01a4aa828), UINT64_C(0x1e38aeb6360b1af3) }, // 5^-73
+  { UINT64_C(0xe2280b6c20dd5232), UINT64_C(0x25c6da63c38de1b0) }, // 5^-72
+  { UINT64_C(0x8d590723948a535f), UINT64_C(0x579c487e5a38ad0e) }, // 5^-71
+  { UINT64_C(0xb0af48ec79ace837), UINT64_C(0x2d835a9df0c6d851) }, // 5^-70
+  { UINT64_C(0xdcdb1b2798182244), UINT64_C(0xf8e431456cf88e65) }, // 5^-69
+  { UINT64_C(0x8a08f0f8bf0f156b), UINT64_C(0x1b8e9ecb641b58ff) }, // 5^-68
+  { UINT64_C(0xac8b2d36eed2dac5), UINT64_C(0xe272467e3d222f3f) }, // 5^-67
+  { UINT64_C(0xd7adf884aa879177), UINT64_C(0x5b0ed81dcc6abb0f) }, // 5^-66
+  { UINT64_C(0x86ccbb52ea94baea), UINT64_C(0x98e947129fc2b4e9) }, // 5^-65
+  { UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224) }, // 5^-64
+  { UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad) }, // 5^-63
+  { UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac) }, // 5^-62
+  { UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7) }, // 5^-61
+  { UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d) }, // 5^-60
+  { UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0) }, // 5^-59
+  { UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4) }, // 5^-58
+  { UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275) }, // 5^-57
+  { UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712) }, // 5^-56
+  { UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b) }, // 5^-55
+  { UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886) }, // 5^-54
+  { UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8) }, // 5^-53
+  { UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029) }, // 5^-52
+  { UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033) }, // 5^-51
+  { UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440) }, // 5^-50
+  { UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8) }, // 5^-49
+  { UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52) }, // 5^-48
+  { UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6) }, // 5^-47
+  { UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8) }, // 5^-46
+  { UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22) }, // 5^-45
+  { UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a) }, // 5^-44
+  { UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242) }, // 5^-43
+  { UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3) }, // 5^-42
+  { UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688) }, // 5^-41
+  { UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015) }, // 5^-40
+  { UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a) }, // 5^-39
+  { UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21) }, // 5^-38
+  { UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54) }, // 5^-37
+  { UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9) }, // 5^-36
+  { UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864) }, // 5^-35
+  { UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e) }, // 5^-34
+  { UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e) }, // 5^-33
+  { UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2) }, // 5^-32
+  { UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7) }, // 5^-31
+  { UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d) }, // 5^-30
+  { UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330) }, // 5^-29
+  { UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc) }, // 5^-28
+  { UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e) }, // 5^-27
+  { UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e) }, // 5^-26
+  { UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205) }, // 5^-25
+  { UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543) }, // 5^-24
+  { UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294) }, // 5^-23
+  { UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339) }, // 5^-22
+  { UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04) }, // 5^-21
+  { UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585) }, // 5^-20
+  { UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6) }, // 5^-19
+  { UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0) }, // 5^-18
+  { UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3) }, // 5^-17
+  { UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4) }, // 5^-16
+  { UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11) }, // 5^-15
+  { UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95) }, // 5^-14
+  { UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba) }, // 5^-13
+  { UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4) }, // 5^-12
+  { UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749) }, // 5^-11
+  { UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c) }, // 5^-10
+  { UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031) }, // 5^-9
+  { UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e) }, // 5^-8
+  { UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d) }, // 5^-7
+  { UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110) }, // 5^-6
+  { UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54) }, // 5^-5
+  { UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9) }, // 5^-4
+  { UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea) }, // 5^-3
+  { UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4) }, // 5^-2
+  { UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd) }, // 5^-1
+  { UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000) }, // 5^0
+  { UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000) }, // 5^1
+  { UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000) }, // 5^2
+  { UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000) }, // 5^3
+  { UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000) }, // 5^4
+  { UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000) }, // 5^5
+  { UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000) }, // 5^6
+  { UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000) }, // 5^7
+  { UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000) }, // 5^8
+  { UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000) }, // 5^9
+  { UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000) }, // 5^10
+  { UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000) }, // 5^11
+  { UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000) }, // 5^12
+  { UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000) }, // 5^13
+  { UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000) }, // 5^14
+  { UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000) }, // 5^15
+  { UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000) }, // 5^16
+  { UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000) }, // 5^17
+  { UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000) }, // 5^18
+  { UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000) }, // 5^19
+  { UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000) }, // 5^20
+  { UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000) }, // 5^21
+  { UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000) }, // 5^22
+  { UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000) }, // 5^23
+  { UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000) }, // 5^24
+  { UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000) }, // 5^25
+  { UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000) }, // 5^26
+  { UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000) }, // 5^27
+  { UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000) }, // 5^28
+  { UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000) }, // 5^29
+  { UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000) }, // 5^30
+  { UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000) }, // 5^31
+  { UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000) }, // 5^32
+  { UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000) }, // 5^33
+  { UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000) }, // 5^34
+  { UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000) }, // 5^35
+  { UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000) }, // 5^36
+  { UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000) }, // 5^37
+  { UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000) }, // 5^38
+  { UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000) }, // 5^39
+  { UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000) }, // 5^40
+  { UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000) }, // 5^41
+  { UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000) }, // 5^42
+  { UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000) }, // 5^43
+  { UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000) }, // 5^44
+  { UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000) }, // 5^45
+  { UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000) }, // 5^46
+  { UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000) }, // 5^47
+  { UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000) }, // 5^48
+  { UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000) }, // 5^49
+  { UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800) }, // 5^50
+  { UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00) }, // 5^51
+  { UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880) }, // 5^52
+  { UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750) }, // 5^53
+  { UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924) }, // 5^54
+  { UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d) }, // 5^55
+  { UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4) }, // 5^56
+  { UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d) }, // 5^57
+  { UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490) }, // 5^58
+  { UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4) }, // 5^59
+  { UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590) }, // 5^60
+  { UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5) }, // 5^61
+  { UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2) }, // 5^62
+  { UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f) }, // 5^63
+  { UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb) }, // 5^64
+  { UINT64_C(0xf316271c7fc3908a), UINT64_C(0x8bef464e3945ef7a) }, // 5^65
+  { UINT64_C(0x97edd871cfda3a56), UINT64_C(0x97758bf0e3cbb5ac) }, // 5^66
+  { UINT64_C(0xbde94e8e43d0c8ec), UINT64_C(0x3d52eeed1cbea317) }, // 5^67
+  { UINT64_C(0xed63a231d4c4fb27), UINT64_C(0x4ca7aaa863ee4bdd) }, // 5^68
+  { UINT64_C(0x945e455f24fb1cf8), UINT64_C(0x8fe8caa93e74ef6a) }, // 5^69
+  { UINT64_C(0xb975d6b6ee39e436), UINT64_C(0xb3e2fd538e122b44) }, // 5^70
+  { UINT64_C(0xe7d34c64a9c85d44), UINT64_C(0x60dbbca87196b616) }, // 5^71
+  { UINT64_C(0x90e40fbeea1d3a4a), UINT64_C(0xbc8955e946fe31cd) }, // 5^72
+  { UINT64_C(0xb51d13aea4a488dd), UINT64_C(0x6babab6398bdbe41) }, // 5^73
+  { UINT64_C(0xe264589a4dcdab14), UINT64_C(0xc696963c7eed2dd1) }, // 5^74
+  { UINT64_C(0x8d7eb76070a08aec), UINT64_C(0xfc1e1de5cf543ca2) }, // 5^75
+  { UINT64_C(0xb0de65388cc8ada8), UINT64_C(0x3b25a55f43294bcb) }, // 5^76
+  { UINT64_C(0xdd15fe86affad912), UINT64_C(0x49ef0eb713f39ebe) }, // 5^77
+  { UINT64_C(0x8a2dbf142dfcc7ab), UINT64_C(0x6e3569326c784337) }, // 5^78
+  { UINT64_C(0xacb92ed9397bf996), UINT64_C(0x49c2c37f07965404) }, // 5^79
+  { UINT64_C(0xd7e77a8f87daf7fb), UINT64_C(0xdc33745ec97be906) }, // 5^80
+  { UINT64_C(0x86f0ac99b4e8dafd), UINT64_C(0x69a028bb3ded71a3) }, // 5^81
+  { UINT64_C(0xa8acd7c0222311bc), UINT64_C(0xc40832ea0d68ce0c) }, // 5^82
+  { UINT64_C(0xd2d80db02aabd62b), UINT64_C(0xf50a3fa490c30190) }, // 5^83
+  { UINT64_C(0x83c7088e1aab65db), UINT64_C(0x792667c6da79e0fa) }, // 5^84
+  { UINT64_C(0xa4b8cab1a1563f52), UINT64_C(0x577001b891185938) }, // 5^85
+  { UINT64_C(0xcde6fd5e09abcf26), UINT64_C(0xed4c0226b55e6f86) }, // 5^86
+  { UINT64_C(0x80b05e5ac60b6178), UINT64_C(0x544f8158315b05b4) }, // 5^87
+  { UINT64_C(0xa0dc75f1778e39d6), UINT64_C(0x696361ae3db1c721) }, // 5^88
+  { UINT64_C(0xc913936dd571c84c), UINT64_C(0x03bc3a19cd1e38e9) }, // 5^89
+  { UINT64_C(0xfb5878494ace3a5f), UINT64_C(0x04ab48a04065c723) }, // 5^90
+  { UINT64_C(0x9d174b2dcec0e47b), UINT64_C(0x62eb0d64283f9c76) }, // 5^91
+  { UINT64_C(0xc45d1df942711d9a), UINT64_C(0x3ba5d0bd324f8394) }, // 5^92
+  { UINT64_C(0xf5746577930d6500), UINT64_C(0xca8f44ec7ee36479) }, // 5^93
+  { UINT64_C(0x9968bf6abbe85f20), UINT64_C(0x7e998b13cf4e1ecb) }, // 5^94
+  { UINT64_C(0xbfc2ef456ae276e8), UINT64_C(0x9e3fedd8c321a67e) }, // 5^95
+  { UINT64_C(0xefb3ab16c59b14a2), UINT64_C(0xc5cfe94ef3ea101e) }, // 5^96
+  { UINT64_C(0x95d04aee3b80ece5), UINT64_C(0xbba1f1d158724a12) }, // 5^97
+  { UINT64_C(0xbb445da9ca61281f), UINT64_C(0x2a8a6e45ae8edc97) }, // 5^98
+  { UINT64_C(0xea1575143cf97226), UINT64_C(0xf52d09d71a3293bd) }, // 5^99
+  { UINT64_C(0x924d692ca61be758), UINT64_C(0x593c2626705f9c56) }, // 5^100
+  { UINT64_C(0xb6e0c377cfa2e12e), UINT64_C(0x6f8b2fb00c77836c) }, // 5^101
+  { UINT64_C(0xe498f455c38b997a), UINT64_C(0x0b6dfb9c0f956447) }, // 5^102
+  { UINT64_C(0x8edf98b59a373fec), UINT64_C(0x4724bd4189bd5eac) }, // 5^103
+  { UINT64_C(0xb2977ee300c50fe7), UINT64_C(0x58edec91ec2cb657) }, // 5^104
+  { UINT64_C(0xdf3d5e9bc0f653e1), UINT64_C(0x2f2967b66737e3ed) }, // 5^105
+  { UINT64_C(0x8b865b215899f46c), UINT64_C(0xbd79e0d20082ee74) }, // 5^106
+  { UINT64_C(0xae67f1e9aec07187), UINT64_C(0xecd8590680a3aa11) }, // 5^107
+  { UINT64_C(0xda01ee641a708de9), UINT64_C(0xe80e6f4820cc9495) }, // 5^108
+  { UINT64_C(0x884134fe908658b2), UINT64_C(0x3109058d147fdcdd) }, // 5^109
+  { UINT64_C(0xaa51823e34a7eede), UINT64_C(0xbd4b46f0599fd415) }, // 5^110
+  { UINT64_C(0xd4e5e2cdc1d1ea96), UINT64_C(0x6c9e18ac7007c91a) }, // 5^111
+  { UINT64_C(0x850fadc09923329e), UINT64_C(0x03e2cf6bc604ddb0) }, // 5^112
+  { UINT64_C(0xa6539930bf6bff45), UINT64_C(0x84db8346b786151c) }, // 5^113
+  { UINT64_C(0xcfe87f7cef46ff16), UINT64_C(0xe612641865679a63) }, // 5^114
+  { UINT64_C(0x81f14fae158c5f6e), UINT64_C(0x4fcb7e8f3f60c07e) }, // 5^115
+  { UINT64_C(0xa26da3999aef7749), UINT64_C(0xe3be5e330f38f09d) }, // 5^116
+  { UINT64_C(0xcb090c8001ab551c), UINT64_C(0x5cadf5bfd3072cc5) }, // 5^117
+  { UINT64_C(0xfdcb4fa002162a63), UINT64_C(0x73d9732fc7c8f7f6) }, // 5^118
+  { UINT64_C(0x9e9f11c4014dda7e), UINT64_C(0x2867e7fddcdd9afa) }, // 5^119
+  { UINT64_C(0xc646d63501a1511d), UINT64_C(0xb281e1fd541501b8) }, // 5^120
+  { UINT64_C(0xf7d88bc24209a565), UINT64_C(0x1f225a7ca91a4226) }, // 5^121
+  { UINT64_C(0x9ae757596946075f), UINT64_C(0x3375788de9b06958) }, // 5^122
+  { UINT64_C(0xc1a12d2fc3978937), UINT64_C(0x0052d6b1641c83ae) }, // 5^123
+  { UINT64_C(0xf209787bb47d6b84), UINT64_C(0xc0678c5dbd23a49a) }, // 5^124
+  { UINT64_C(0x9745eb4d50ce6332), UINT64_C(0xf840b7ba963646e0) }, // 5^125
+  { UINT64_C(0xbd176620a501fbff), UINT64_C(0xb650e5a93bc3d898) }, // 5^126
+  { UINT64_C(0xec5d3fa8ce427aff), UINT64_C(0xa3e51f138ab4cebe) }, // 5^127
+  { UINT64_C(0x93ba47c980e98cdf), UINT64_C(0xc66f336c36b10137) }, // 5^128
+  { UINT64_C(0xb8a8d9bbe123f017), UINT64_C(0xb80b0047445d4184) }, // 5^129
+  { UINT64_C(0xe6d3102ad96cec1d), UINT64_C(0xa60dc059157491e5) }, // 5^130
+  { UINT64_C(0x9043ea1ac7e41392), UINT64_C(0x87c89837ad68db2f) }, // 5^131
+  { UINT64_C(0xb454e4a179dd1877), UINT64_C(0x29babe4598c311fb) }, // 5^132
+  { UINT64_C(0xe16a1dc9d8545e94), UINT64_C(0xf4296dd6fef3d67a) }, // 5^133
+  { UINT64_C(0x8ce2529e2734bb1d), UINT64_C(0x1899e4a65f58660c) }, // 5^134
+  { UINT64_C(0xb01ae745b101e9e4), UINT64_C(0x5ec05dcff72e7f8f) }, // 5^135
+  { UINT64_C(0xdc21a1171d42645d), UINT64_C(0x76707543f4fa1f73) }, // 5^136
+  { UINT64_C(0x899504ae72497eba), UINT64_C(0x6a06494a791c53a8) }, // 5^137
+  { UINT64_C(0xabfa45da0edbde69), UINT64_C(0x0487db9d17636892) }, // 5^138
+  { UINT64_C(0xd6f8d7509292d603), UINT64_C(0x45a9d2845d3c42b6) }, // 5^139
+  { UINT64_C(0x865b86925b9bc5c2), UINT64_C(0x0b8a2392ba45a9b2) }, // 5^140
+  { UINT64_C(0xa7f26836f282b732), UINT64_C(0x8e6cac7768d7141e) }, // 5^141
+  { UINT64_C(0xd1ef0244af2364ff), UINT64_C(0x3207d795430cd926) }, // 5^142
+  { UINT64_C(0x8335616aed761f1f), UINT64_C(0x7f44e6bd49e807b8) }, // 5^143
+  { UINT64_C(0xa402b9c5a8d3a6e7), UINT64_C(0x5f16206c9c6209a6) }, // 5^144
+  { UINT64_C(0xcd036837130890a1), UINT64_C(0x36dba887c37a8c0f) }, // 5^145
+  { UINT64_C(0x802221226be55a64), UINT64_C(0xc2494954da2c9789) }, // 5^146
+  { UINT64_C(0xa02aa96b06deb0fd), UINT64_C(0xf2db9baa10b7bd6c) }, // 5^147
+  { UINT64_C(0xc83553c5c8965d3d), UINT64_C(0x6f92829494e5acc7) }, // 5^148
+  { UINT64_C(0xfa42a8b73abbf48c), UINT64_C(0xcb772339ba1f17f9) }, // 5^149
+  { UINT64_C(0x9c69a97284b578d7), UINT64_C(0xff2a760414536efb) }, // 5^150
+  { UINT64_C(0xc38413cf25e2d70d), UINT64_C(0xfef5138519684aba) }, // 5^151
+  { UINT64_C(0xf46518c2ef5b8cd1), UINT64_C(0x7eb258665fc25d69) }, // 5^152
+  { UINT64_C(0x98bf2f79d5993802), UINT64_C(0xef2f773ffbd97a61) }, // 5^153
+  { UINT64_C(0xbeeefb584aff8603), UINT64_C(0xaafb550ffacfd8fa) }, // 5^154
+  { UINT64_C(0xeeaaba2e5dbf6784), UINT64_C(0x95ba2a53f983cf38) }, // 5^155
+  { UINT64_C(0x952ab45cfa97a0b2), UINT64_C(0xdd945a747bf26183) }, // 5^156
+  { UINT64_C(0xba756174393d88df), UINT64_C(0x94f971119aeef9e4) }, // 5^157
+  { UINT64_C(0xe912b9d1478ceb17), UINT64_C(0x7a37cd5601aab85d) }, // 5^158
+  { UINT64_C(0x91abb422ccb812ee), UINT64_C(0xac62e055c10ab33a) }, // 5^159
+  { UINT64_C(0xb616a12b7fe617aa), UINT64_C(0x577b986b314d6009) }, // 5^160
+  { UINT64_C(0xe39c49765fdf9d94), UINT64_C(0xed5a7e85fda0b80b) }, // 5^161
+  { UINT64_C(0x8e41ade9fbebc27d), UINT64_C(0x14588f13be847307) }, // 5^162
+  { UINT64_C(0xb1d219647ae6b31c), UINT64_C(0x596eb2d8ae258fc8) }, // 5^163
+  { UINT64_C(0xde469fbd99a05fe3), UINT64_C(0x6fca5f8ed9aef3bb) }, // 5^164
+  { UINT64_C(0x8aec23d680043bee), UINT64_C(0x25de7bb9480d5854) }, // 5^165
+  { UINT64_C(0xada72ccc20054ae9), UINT64_C(0xaf561aa79a10ae6a) }, // 5^166
+  { UINT64_C(0xd910f7ff28069da4), UINT64_C(0x1b2ba1518094da04) }, // 5^167
+  { UINT64_C(0x87aa9aff79042286), UINT64_C(0x90fb44d2f05d0842) }, // 5^168
+  { UINT64_C(0xa99541bf57452b28), UINT64_C(0x353a1607ac744a53) }, // 5^169
+  { UINT64_C(0xd3fa922f2d1675f2), UINT64_C(0x42889b8997915ce8) }, // 5^170
+  { UINT64_C(0x847c9b5d7c2e09b7), UINT64_C(0x69956135febada11) }, // 5^171
+  { UINT64_C(0xa59bc234db398c25), UINT64_C(0x43fab9837e699095) }, // 5^172
+  { UINT64_C(0xcf02b2c21207ef2e), UINT64_C(0x94f967e45e03f4bb) }, // 5^173
+  { UINT64_C(0x8161afb94b44f57d), UINT64_C(0x1d1be0eebac278f5) }, // 5^174
+  { UINT64_C(0xa1ba1ba79e1632dc), UINT64_C(0x6462d92a69731732) }, // 5^175
+  { UINT64_C(0xca28a291859bbf93), UINT64_C(0x7d7b8f7503cfdcfe) }, // 5^176
+  { UINT64_C(0xfcb2cb35e702af78), UINT64_C(0x5cda735244c3d43e) }, // 5^177
+  { UINT64_C(0x9defbf01b061adab), UINT64_C(0x3a0888136afa64a7) }, // 5^178
+  { UINT64_C(0xc56baec21c7a1916), UINT64_C(0x088aaa1845b8fdd0) }, // 5^179
+  { UINT64_C(0xf6c69a72a3989f5b), UINT64_C(0x8aad549e57273d45) }, // 5^180
+  { UINT64_C(0x9a3c2087a63f6399), UINT64_C(0x36ac54e2f678864b) }, // 5^181
+  { UINT64_C(0xc0cb28a98fcf3c7f), UINT64_C(0x84576a1bb416a7dd) }, // 5^182
+  { UINT64_C(0xf0fdf2d3f3c30b9f), UINT64_C(0x656d44a2a11c51d5) }, // 5^183
+  { UINT64_C(0x969eb7c47859e743), UINT64_C(0x9f644ae5a4b1b325) }, // 5^184
+  { UINT64_C(0xbc4665b596706114), UINT64_C(0x873d5d9f0dde1fee) }, // 5^185
+  { UINT64_C(0xeb57ff22fc0c7959), UINT64_C(0xa90cb506d155a7ea) }, // 5^186
+  { UINT64_C(0x9316ff75dd87cbd8), UINT64_C(0x09a7f12442d588f2) }, // 5^187
+  { UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x0c11ed6d538aeb2f) }, // 5^188
+  { UINT64_C(0xe5d3ef282a242e81), UINT64_C(0x8f1668c8a86da5fa) }, // 5^189
+  { UINT64_C(0x8fa475791a569d10), UINT64_C(0xf96e017d694487bc) }, // 5^190
+  { UINT64_C(0xb38d92d760ec4455), UINT64_C(0x37c981dcc395a9ac) }, // 5^191
+  { UINT64_C(0xe070f78d3927556a), UINT64_C(0x85bbe253f47b1417) }, // 5^192
+  { UINT64_C(0x8c469ab843b89562), UINT64_C(0x93956d7478ccec8e) }, // 5^193
+  { UINT64_C(0xaf58416654a6babb), UINT64_C(0x387ac8d1970027b2) }, // 5^194
+  { UINT64_C(0xdb2e51bfe9d0696a), UINT64_C(0x06997b05fcc0319e) }, // 5^195
+  { UINT64_C(0x88fcf317f22241e2), UINT64_C(0x441fece3bdf81f03) }, // 5^196
+  { UINT64_C(0xab3c2fddeeaad25a), UINT64_C(0xd527e81cad7626c3) }, // 5^197
+  { UINT64_C(0xd60b3bd56a5586f1), UINT64_C(0x8a71e223d8d3b074) }, // 5^198
+  { UINT64_C(0x85c7056562757456), UINT64_C(0xf6872d5667844e49) }, // 5^199
+  { UINT64_C(0xa738c6bebb12d16c), UINT64_C(0xb428f8ac016561db) }, // 5^200
+  { UINT64_C(0xd106f86e69d785c7), UINT64_C(0xe13336d701beba52) }, // 5^201
+  { UINT64_C(0x82a45b450226b39c), UINT64_C(0xecc0024661173473) }, // 5^202
+  { UINT64_C(0xa34d721642b06084), UINT64_C(0x27f002d7f95d0190) }, // 5^203
+  { UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x31ec038df7b441f4) }, // 5^204
+  { UINT64_C(0xff290242c83396ce), UINT64_C(0x7e67047175a15271) }, // 5^205
+  { UINT64_C(0x9f79a169bd203e41), UINT64_C(0x0f0062c6e984d386) }, // 5^206
+  { UINT64_C(0xc75809c42c684dd1), UINT64_C(0x52c07b78a3e60868) }, // 5^207
+  { UINT64_C(0xf92e0c3537826145), UINT64_C(0xa7709a56ccdf8a82) }, // 5^208
+  { UINT64_C(0x9bbcc7a142b17ccb), UINT64_C(0x88a66076400bb691) }, // 5^209
+  { UINT64_C(0xc2abf989935ddbfe), UINT64_C(0x6acff893d00ea435) }, // 5^210
+  { UINT64_C(0xf356f7ebf83552fe), UINT64_C(0x0583f6b8c4124d43) }, // 5^211
+  { UINT64_C(0x98165af37b2153de), UINT64_C(0xc3727a337a8b704a) }, // 5^212
+  { UINT64_C(0xbe1bf1b059e9a8d6), UINT64_C(0x744f18c0592e4c5c) }, // 5^213
+  { UINT64_C(0xeda2ee1c7064130c), UINT64_C(0x1162def06f79df73) }, // 5^214
+  { UINT64_C(0x9485d4d1c63e8be7), UINT64_C(0x8addcb5645ac2ba8) }, // 5^215
+  { UINT64_C(0xb9a74a0637ce2ee1), UINT64_C(0x6d953e2bd7173692) }, // 5^216
+  { UINT64_C(0xe8111c87c5c1ba99), UINT64_C(0xc8fa8db6ccdd0437) }, // 5^217
+  { UINT64_C(0x910ab1d4db9914a0), UINT64_C(0x1d9c9892400a22a2) }, // 5^218
+  { UINT64_C(0xb54d5e4a127f59c8), UINT64_C(0x2503beb6d00cab4b) }, // 5^219
+  { UINT64_C(0xe2a0b5dc971f303a), UINT64_C(0x2e44ae64840fd61d) }, // 5^220
+  { UINT64_C(0x8da471a9de737e24), UINT64_C(0x5ceaecfed289e5d2) }, // 5^221
+  { UINT64_C(0xb10d8e1456105dad), UINT64_C(0x7425a83e872c5f47) }, // 5^222
+  { UINT64_C(0xdd50f1996b947518), UINT64_C(0xd12f124e28f77719) }, // 5^223
+  { UINT64_C(0x8a5296ffe33cc92f), UINT64_C(0x82bd6b70d99aaa6f) }, // 5^224
+  { UINT64_C(0xace73cbfdc0bfb7b), UINT64_C(0x636cc64d1001550b) }, // 5^225
+  { UINT64_C(0xd8210befd30efa5a), UINT64_C(0x3c47f7e05401aa4e) }, // 5^226
+  { UINT64_C(0x8714a775e3e95c78), UINT64_C(0x65acfaec34810a71) }, // 5^227
+  { UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0x7f1839a741a14d0d) }, // 5^228
+  { UINT64_C(0xd31045a8341ca07c), UINT64_C(0x1ede48111209a050) }, // 5^229
+  { UINT64_C(0x83ea2b892091e44d), UINT64_C(0x934aed0aab460432) }, // 5^230
+  { UINT64_C(0xa4e4b66b68b65d60), UINT64_C(0xf81da84d5617853f) }, // 5^231
+  { UINT64_C(0xce1de40642e3f4b9), UINT64_C(0x36251260ab9d668e) }, // 5^232
+  { UINT64_C(0x80d2ae83e9ce78f3), UINT64_C(0xc1d72b7c6b426019) }, // 5^233
+  { UINT64_C(0xa1075a24e4421730), UINT64_C(0xb24cf65b8612f81f) }, // 5^234
+  { UINT64_C(0xc94930ae1d529cfc), UINT64_C(0xdee033f26797b627) }, // 5^235
+  { UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0x169840ef017da3b1) }, // 5^236
+  { UINT64_C(0x9d412e0806e88aa5), UINT64_C(0x8e1f289560ee864e) }, // 5^237
+  { UINT64_C(0xc491798a08a2ad4e), UINT64_C(0xf1a6f2bab92a27e2) }, // 5^238
+  { UINT64_C(0xf5b5d7ec8acb58a2), UINT64_C(0xae10af696774b1db) }, // 5^239
+  { UINT64_C(0x9991a6f3d6bf1765), UINT64_C(0xacca6da1e0a8ef29) }, // 5^240
+  { UINT64_C(0xbff610b0cc6edd3f), UINT64_C(0x17fd090a58d32af3) }, // 5^241
+  { UINT64_C(0xeff394dcff8a948e), UINT64_C(0xddfc4b4cef07f5b0) }, // 5^242
+  { UINT64_C(0x95f83d0a1fb69cd9), UINT64_C(0x4abdaf101564f98e) }, // 5^243
+  { UINT64_C(0xbb764c4ca7a4440f), UINT64_C(0x9d6d1ad41abe37f1) }, // 5^244
+  { UINT64_C(0xea53df5fd18d5513), UINT64_C(0x84c86189216dc5ed) }, // 5^245
+  { UINT64_C(0x92746b9be2f8552c), UINT64_C(0x32fd3cf5b4e49bb4) }, // 5^246
+  { UINT64_C(0xb7118682dbb66a77), UINT64_C(0x3fbc8c33221dc2a1) }, // 5^247
+  { UINT64_C(0xe4d5e82392a40515), UINT64_C(0x0fabaf3feaa5334a) }, // 5^248
+  { UINT64_C(0x8f05b1163ba6832d), UINT64_C(0x29cb4d87f2a7400e) }, // 5^249
+  { UINT64_C(0xb2c71d5bca9023f8), UINT64_C(0x743e20e9ef511012) }, // 5^250
+  { UINT64_C(0xdf78e4b2bd342cf6), UINT64_C(0x914da9246b255416) }, // 5^251
+  { UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0x1ad089b6c2f7548e) }, // 5^252
+  { UINT64_C(0xae9672aba3d0c320), UINT64_C(0xa184ac2473b529b1) }, // 5^253
+  { UINT64_C(0xda3c0f568cc4f3e8), UINT64_C(0xc9e5d72d90a2741e) }, // 5^254
+  { UINT64_C(0x8865899617fb1871), UINT64_C(0x7e2fa67c7a658892) }, // 5^255
+  { UINT64_C(0xaa7eebfb9df9de8d), UINT64_C(0xddbb901b98feeab7) }, // 5^256
+  { UINT64_C(0xd51ea6fa85785631), UINT64_C(0x552a74227f3ea565) }, // 5^257
+  { UINT64_C(0x8533285c936b35de), UINT64_C(0xd53a88958f87275f) }, // 5^258
+  { UINT64_C(0xa67ff273b8460356), UINT64_C(0x8a892abaf368f137) }, // 5^259
+  { UINT64_C(0xd01fef10a657842c), UINT64_C(0x2d2b7569b0432d85) }, // 5^260
+  { UINT64_C(0x8213f56a67f6b29b), UINT64_C(0x9c3b29620e29fc73) }, // 5^261
+  { UINT64_C(0xa298f2c501f45f42), UINT64_C(0x8349f3ba91b47b8f) }, // 5^262
+  { UINT64_C(0xcb3f2f7642717713), UINT64_C(0x241c70a936219a73) }, // 5^263
+  { UINT64_C(0xfe0efb53d30dd4d7), UINT64_C(0xed238cd383aa0110) }, // 5^264
+  { UINT64_C(0x9ec95d1463e8a506), UINT64_C(0xf4363804324a40aa) }, // 5^265
+  { UINT64_C(0xc67bb4597ce2ce48), UINT64_C(0xb143c6053edcd0d5) }, // 5^266
+  { UINT64_C(0xf81aa16fdc1b81da), UINT64_C(0xdd94b7868e94050a) }, // 5^267
+  { UINT64_C(0x9b10a4e5e9913128), UINT64_C(0xca7cf2b4191c8326) }, // 5^268
+  { UINT64_C(0xc1d4ce1f63f57d72), UINT64_C(0xfd1c2f611f63a3f0) }, // 5^269
+  { UINT64_C(0xf24a01a73cf2dccf), UINT64_C(0xbc633b39673c8cec) }, // 5^270
+  { UINT64_C(0x976e41088617ca01), UINT64_C(0xd5be0503e085d813) }, // 5^271
+  { UINT64_C(0xbd49d14aa79dbc82), UINT64_C(0x4b2d8644d8a74e18) }, // 5^272
+  { UINT64_C(0xec9c459d51852ba2), UINT64_C(0xddf8e7d60ed1219e) }, // 5^273
+  { UINT64_C(0x93e1ab8252f33b45), UINT64_C(0xcabb90e5c942b503) }, // 5^274
+  { UINT64_C(0xb8da1662e7b00a17), UINT64_C(0x3d6a751f3b936243) }, // 5^275
+  { UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0x0cc512670a783ad4) }, // 5^276
+  { UINT64_C(0x906a617d450187e2), UINT64_C(0x27fb2b80668b24c5) }, // 5^277
+  { UINT64_C(0xb484f9dc9641e9da), UINT64_C(0xb1f9f660802dedf6) }, // 5^278
+  { UINT64_C(0xe1a63853bbd26451), UINT64_C(0x5e7873f8a0396973) }, // 5^279
+  { UINT64_C(0x8d07e33455637eb2), UINT64_C(0xdb0b487b6423e1e8) }, // 5^280
+  { UINT64_C(0xb049dc016abc5e5f), UINT64_C(0x91ce1a9a3d2cda62) }, // 5^281
+  { UINT64_C(0xdc5c5301c56b75f7), UINT64_C(0x7641a140cc7810fb) }, // 5^282
+  { UINT64_C(0x89b9b3e11b6329ba), UINT64_C(0xa9e904c87fcb0a9d) }, // 5^283
+  { UINT64_C(0xac2820d9623bf429), UINT64_C(0x546345fa9fbdcd44) }, // 5^284
+  { UINT64_C(0xd732290fbacaf133), UINT64_C(0xa97c177947ad4095) }, // 5^285
+  { UINT64_C(0x867f59a9d4bed6c0), UINT64_C(0x49ed8eabcccc485d) }, // 5^286
+  { UINT64_C(0xa81f301449ee8c70), UINT64_C(0x5c68f256bfff5a74) }, // 5^287
+  { UINT64_C(0xd226fc195c6a2f8c), UINT64_C(0x73832eec6fff3111) }, // 5^288
+  { UINT64_C(0x83585d8fd9c25db7), UINT64_C(0xc831fd53c5ff7eab) }, // 5^289
+  { UINT64_C(0xa42e74f3d032f525), UINT64_C(0xba3e7ca8b77f5e55) }, // 5^290
+  { UINT64_C(0xcd3a1230c43fb26f), UINT64_C(0x28ce1bd2e55f35eb) }, // 5^291
+  { UINT64_C(0x80444b5e7aa7cf85), UINT64_C(0x7980d163cf5b81b3) }, // 5^292
+  { UINT64_C(0xa0555e361951c366), UINT64_C(0xd7e105bcc332621f) }, // 5^293
+  { UINT64_C(0xc86ab5c39fa63440), UINT64_C(0x8dd9472bf3fefaa7) }, // 5^294
+  { UINT64_C(0xfa856334878fc150), UINT64_C(0xb14f98f6f0feb951) }, // 5^295
+  { UINT64_C(0x9c935e00d4b9d8d2), UINT64_C(0x6ed1bf9a569f33d3) }, // 5^296
+  { UINT64_C(0xc3b8358109e84f07), UINT64_C(0x0a862f80ec4700c8) }, // 5^297
+  { UINT64_C(0xf4a642e14c6262c8), UINT64_C(0xcd27bb612758c0fa) }, // 5^298
+  { UINT64_C(0x98e7e9cccfbd7dbd), UINT64_C(0x8038d51cb897789c) }, // 5^299
+  { UINT64_C(0xbf21e44003acdd2c), UINT64_C(0xe0470a63e6bd56c3) }, // 5^300
+  { UINT64_C(0xeeea5d5004981478), UINT64_C(0x1858ccfce06cac74) }, // 5^301
+  { UINT64_C(0x95527a5202df0ccb), UINT64_C(0x0f37801e0c43ebc8) }, // 5^302
+  { UINT64_C(0xbaa718e68396cffd), UINT64_C(0xd30560258f54e6ba) }, // 5^303
+  { UINT64_C(0xe950df20247c83fd), UINT64_C(0x47c6b82ef32a2069) }, // 5^304
+  { UINT64_C(0x91d28b7416cdd27e), UINT64_C(0x4cdc331d57fa5441) }, // 5^305
+  { UINT64_C(0xb6472e511c81471d), UINT64_C(0xe0133fe4adf8e952) }, // 5^306
+  { UINT64_C(0xe3d8f9e563a198e5), UINT64_C(0x58180fddd97723a6) }, // 5^307
+  { UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0x570f09eaa7ea7648) },  // 5^308
+};
+
+// at most this many significant digits are used by the slow path, any
+// after that only matter as to whether they're all zero
+#define JSON_SLOW_PATH_MAX_DIGITS 800
+
+// enough for 5^(JSON_SLOW_PATH_MAX_DIGITS + 326) times a 55-bit mantissa
+// or the digits themselves shifted by as much, with room to spare
+#define JSON_BIGINT_LIMBS 128
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 _json_native_uint128_t;
+#endif
+
+struct _json_uint128_t
+{
+  uint64_t high;
+  uint64_t low;
+};
+
+static struct _json_uint128_t
+_json_multiply_64(
+  const uint64_t a,
+  const uint64_t b)
+{
+  struct _json_uint128_t result;
+#ifdef __SIZEOF_INT128__
+  const _json_native_uint128_t product = (_json_native_uint128_t)a * b;
+  result.high = (uint64_t)(product >> 64);
+  result.low = (uint64_t)product;
+#else
+  const uint64_t mask32 = UINT64_C(0xFFFFFFFF);
+  const uint64_t a_lo = a & mask32;
+  const uint64_t a_hi = a >> 32;
+  const uint64_t b_lo = b & mask32;
+  const uint64_t b_hi = b >> 32;
+
+  const uint64_t lo_lo = a_lo * b_lo;
+  const uint64_t hi_lo = a_hi * b_lo;
+  const uint64_t lo_hi = a_lo * b_hi;
+  const uint64_t hi_hi = a_hi * b_hi;
+
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & mask32) + lo_hi;
+  result.high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+  result.low = (cross << 32) | (lo_lo & mask32);
+#endif
+  return result;
+}
+
+static int
+_json_leading_zeros(
+  uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(value);
+#else
+  int n_zeros = 0;
+  while (!(value & (UINT64_C(1) << 63)))
+  {
+    value <<= 1;
+    n_zeros++;
+  }
+  return n_zeros;
+#endif
+}
+
+static double
+_json_double_from_parts(
+  const uint64_t mantissa,
+  const int biased_exponent,
+  const bool negative)
+{
+  uint64_t bits = ((uint64_t)biased_exponent << JSON_DP_SIGNIFICAND_SIZE) | mantissa;
+  if (negative)
+    bits |= UINT64_C(1) << 63;
+
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Eisel-Lemire: w * 10^q rounded to nearest, as a 52-bit mantissa (hidden
+// bit removed) and biased exponent. w must be non-zero and q within the
+// table. returns false if the result might be off by one, in which case
+// the outputs are still the nearest guess
+static bool
+_json_eisel_lemire(
+  const int64_t q,
+  uint64_t w,
+  uint64_t* const mantissa,
+  int* const biased_exponent)
+{
+  const int n_zeros = _json_leading_zeros(w);
+  w <<= n_zeros;
+
+  const size_t index = (size_t)(q - JSON_POW5_MIN_EXPONENT);
+  struct _json_uint128_t product = _json_multiply_64(w, _json_pow5_128[index][0]);
+
+  // only 55 bits are needed, the low word of the power matters only if
+  // the bits below those are all ones and could carry into them
+  const uint64_t precision_mask = UINT64_C(0xFFFFFFFFFFFFFFFF) >> 55;
+  if ((product.high & precision_mask) == precision_mask)
+  {
+    const struct _json_uint128_t second = _json_multiply_64(w, _json_pow5_128[index][1]);
+    product.low += second.high;
+    if (second.high > product.low)
+      product.high++;
+  }
+
+  // 5^q is exact in 128 bits for -27 <= q <= 55, otherwise a low word of
+  // all ones means the truncated tail could still carry
+  bool exact = true;
+  if (product.low == UINT64_C(0xFFFFFFFFFFFFFFFF) && (q < -27 || q > 55))
+    exact = false;
+
+  const int upper_bit = (int)(product.high >> 63);
+  uint64_t m = product.high >> (upper_bit + 64 - JSON_DP_SIGNIFICAND_SIZE - 3);
+  // floor(log2(10^q)) + 63, plus the exponent bias of 1023
+  int power2 = (int)((((152170 + 65536) * q) >> 16) + 63) + upper_bit - n_zeros + 1023;
+
+  if (power2 <= 0)
+  {
+    // subnormal
+    if (-power2 + 1 >= 64)
+    {
+      *mantissa = 0;
+      *biased_exponent = 0;
+      return exact;
+    }
+
+    m >>= -power2 + 1;
+    m += m & 1;
+    m >>= 1;
+    // rounding can carry it back up into the normal range
+    *biased_exponent = m < (UINT64_C(1) << JSON_DP_SIGNIFICAND_SIZE) ? 0 : 1;
+    *mantissa = m & JSON_DP_SIGNIFICAND_MASK;
+    return exact;
+  }
+
+  // exactly halfway between two doubles, round to even rather than up.
+  // this can only happen for small powers where the product is exact
+  if (product.low <= 1 && q >= -4 && q <= 23 && (m & 3) == 1
+      && (m << (upper_bit + 64 - JSON_DP_SIGNIFICAND_SIZE - 3)) == product.high)
+    m &= ~UINT64_C(1);
+
+  m += m & 1;
+  m >>= 1;
+  if (m >= (UINT64_C(2) << JSON_DP_SIGNIFICAND_SIZE))
+  {
+    m = UINT64_C(1) << JSON_DP_SIGNIFICAND_SIZE;
+    power2++;
+  }
+
+  if (power2 >= 0x7FF)
+  {
+    *mantissa = 0;
+    *biased_exponent = 0x7FF;
+    return exact;
+  }
+
+  *mantissa = m & JSON_DP_SIGNIFICAND_MASK;
+  *biased_exponent = power2;
+  return exact;
+}
+
+struct _json_bigint_t
+{
+  // least significant first
+  uint32_t limbs[JSON_BIGINT_LIMBS];
+  size_t len;
+};
+
+static void
+_json_bigint_set(
+  struct _json_bigint_t* const bigint,
+  uint64_t value)
+{
+  bigint->len = 0;
+  while (value > 0)
+  {
+    bigint->limbs[bigint->len++] = (uint32_t)value;
+    value >>= 32;
+  }
+}
+
+static void
+_json_bigint_multiply_add(
+  struct _json_bigint_t* const bigint,
+  const uint32_t multiplier,
+  uint32_t addend)
+{
+  uint64_t carry = addend;
+  for (size_t i = 0; i < bigint->len; ++i)
+  {
+    const uint64_t product = (uint64_t)bigint->limbs[i] * multiplier + carry;
+    bigint->limbs[i] = (uint32_t)product;
+    carry = product >> 32;
+  }
+
+  if (carry > 0 && bigint->len < JSON_BIGINT_LIMBS)
+    bigint->limbs[bigint->len++] = (uint32_t)carry;
+}
+
+static void
+_json_bigint_multiply_pow5(
+  struct _json_bigint_t* const bigint,
+  size_t exponent)
+{
+  // 5^13 is the largest power of 5 that fits in 32 bits
+  while (exponent >= 13)
+  {
+    _json_bigint_multiply_add(bigint, UINT32_C(1220703125), 0);
+    exponent -= 13;
+  }
+
+  uint32_t remainder = 1;
+  while (exponent-- > 0)
+    remainder *= 5;
+  _json_bigint_multiply_add(bigint, remainder, 0);
+}
+
+static void
+_json_bigint_shift_left(
+  struct _json_bigint_t* const bigint,
+  const size_t n_bits)
+{
+  if (bigint->len == 0)
+    return;
+
+  const size_t n_limbs = n_bits / 32;
+  const size_t n_shift = n_bits % 32;
+
+  if (n_shift > 0)
+  {
+    uint32_t carry = 0;
+    for (size_t i = 0; i < bigint->len; ++i)
+    {
+      const uint32_t limb = bigint->limbs[i];
+      bigint->limbs[i] = (limb << n_shift) | carry;
+      carry = limb >> (32 - n_shift);
+    }
+    if (carry > 0 && bigint->len < JSON_BIGINT_LIMBS)
+      bigint->limbs[bigint->len++] = carry;
+  }
+
+  if (n_limbs > 0)
+  {
+    size_t new_len = bigint->len + n_limbs;
+    if (new_len > JSON_BIGINT_LIMBS)
+      new_len = JSON_BIGINT_LIMBS;
+    for (size_t i = new_len; i-- > n_limbs;)
+      bigint->limbs[i] = bigint->limbs[i - n_limbs];
+    memset(bigint->limbs, 0, n_limbs * sizeof(uint32_t));
+    bigint->len = new_len;
+  }
+}
+
+static int
+_json_bigint_compare(
+  const struct _json_bigint_t* const lhs,
+  const struct _json_bigint_t* const rhs)
+{
+  if (lhs->len != rhs->len)
+    return lhs->len < rhs->len ? -1 : 1;
+
+  for (size_t i = lhs->len; i-- > 0;)
+    if (lhs->limbs[i] != rhs->limbs[i])
+      return lhs->limbs[i] < rhs->limbs[i] ? -1 : 1;
+
+  return 0;
+}
+
+// the significant digits of a number as an exact integer, value = digits * 10^exponent
+struct _json_decimal_digits_t
+{
+  struct _json_bigint_t digits;
+  int64_t exponent;
+  // true if non-zero digits past JSON_SLOW_PATH_MAX_DIGITS were dropped
+  bool truncated;
+};
+
+// a positive double (or infinity) as m * 2^e with integer m
+static void
+_json_decompose_double(
+  const double value,
+  uint64_t* const m,
+  int* const e)
+{
+  if (isinf(value))
+  {
+    // treated as 2^1024, the next power of two after DBL_MAX
+    *m = JSON_DP_HIDDEN_BIT;
+    *e = 1024 - JSON_DP_SIGNIFICAND_SIZE;
+    return;
+  }
+
+  const struct _json_diy_fp_t fp = _json_diy_fp_from_double(value);
+  *m = fp.f;
+  *e = fp.e;
+}
+
+// compares the decimal against the point halfway between two adjacent
+// non-negative doubles below < above
+static int
+_json_compare_halfway(
+  const struct _json_decimal_digits_t* const decimal,
+  const double below,
+  const double above)
+{
+  uint64_t m_below;
+  uint64_t m_above;
+  int e_below;
+  int e_above;
+  _json_decompose_double(below, &m_below, &e_below);
+  _json_decompose_double(above, &m_above, &e_above);
+
+  // halfway = (below + above) / 2 = sum * 2^(e - 1)
+  const int e = e_below < e_above ? e_below : e_above;
+  const uint64_t sum = (m_below << (e_below - e)) + (m_above << (e_above - e));
+  const int64_t halfway_exponent = (int64_t)e - 1;
+
+  // digits * 2^exponent * 5^exponent vs sum * 2^halfway_exponent
+  struct _json_bigint_t lhs = decimal->digits;
+  struct _json_bigint_t rhs;
+  _json_bigint_set(&rhs, sum);
+
+  if (decimal->exponent >= 0)
+    _json_bigint_multiply_pow5(&lhs, (size_t)decimal->exponent);
+  else
+    _json_bigint_multiply_pow5(&rhs, (size_t)-decimal->exponent);
+
+  const int64_t shift = decimal->exponent - halfway_exponent;
+  if (shift > 0)
+    _json_bigint_shift_left(&lhs, (size_t)shift);
+  else
+    _json_bigint_shift_left(&rhs, (size_t)-shift);
+
+  const int comparison = _json_bigint_compare(&lhs, &rhs);
+  // dropped digits put the true value just above what was compared
+  if (comparison == 0 && decimal->truncated)
+    return 1;
+  return comparison;
+}
+
+static bool
+_json_is_even(
+  const double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & 1) == 0;
+}
+
+// walks to the correctly rounded double from a guess that's at most a
+// couple of doubles away
+static double
+_json_slow_path(
+  const struct _json_decimal_digits_t* const decimal,
+  double guess)
+{
+  for (;;)
+  {
+    if (!isinf(guess))
+    {
+      const double above = nextafter(guess, INFINITY);
+      const int comparison = _json_compare_halfway(decimal, guess, above);
+      if (comparison > 0 || (comparison == 0 && !_json_is_even(guess)))
+      {
+        guess = above;
+        continue;
+      }
+    }
+
+    if (guess > 0.0)
+    {
+      const double below = nextafter(guess, 0.0);
+      const int comparison = _json_compare_halfway(decimal, below, guess);
+      if (comparison < 0 || (comparison == 0 && !_json_is_even(guess)))
+      {
+        guess = below;
+        continue;
+      }
+    }
+
+    return guess;
+  }
+}
+
+static bool
+_json_is_digit(
+  const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+static void
+_json_collect_digits(
+  const char* current,
+  const char* const end,
+  const int64_t explicit_exponent,
+  struct _json_decimal_digits_t* const decimal)
+{
+  size_t n_digits = 0;
+  bool in_fraction = false;
+  uint32_t chunk = 0;
+  uint32_t chunk_scale = 1;
+
+  _json_bigint_set(&decimal->digits, 0);
+  decimal->exponent = explicit_exponent;
+  decimal->truncated = false;
+
+  for (; current < end; ++current)
+  {
+    if (*current == '.')
+    {
+      in_fraction = true;
+      continue;
+    }
+
+    if (!_json_is_digit(*current))
+      break;
+
+    const uint32_t digit = (uint32_t)(*current - '0');
+    // leading zeros aren't significant
+    if (n_digits == 0 && digit == 0)
+    {
+      if (in_fraction)
+        decimal->exponent--;
+      continue;
+    }
+
+    if (n_digits >= JSON_SLOW_PATH_MAX_DIGITS)
+    {
+      if (digit != 0)
+        decimal->truncated = true;
+      if (!in_fraction)
+        decimal->exponent++;
+      continue;
+    }
+
+    // digits are added in chunks of up to 9 to save on bigint passes
+    chunk = chunk * 10 + digit;
+    chunk_scale *= 10;
+    if (chunk_scale == UINT32_C(1000000000))
+    {
+      _json_bigint_multiply_add(&decimal->digits, chunk_scale, chunk);
+      chunk = 0;
+      chunk_scale = 1;
+    }
+
+    n_digits++;
+    if (in_fraction)
+      decimal->exponent--;
+  }
+
+  if (chunk_scale > 1)
+    _json_bigint_multiply_add(&decimal->digits, chunk_scale, chunk);
+}
+
+bool
+_json_parse_number(
+  const char* const start,
+  const char* const end,
+  enum json_type_e* const type,
+  union value* const value,
+  size_t* const len)
+{
+  const char* current = start;
+  bool negative = false;
+  bool is_decimal = false;
+
+  // the first 19 significant digits always fit in a uint64
+  uint64_t mantissa = 0;
+  size_t n_significant = 0;
+  size_t n_digits = 0;
+  int64_t exponent = 0;
+  bool truncated = false;
+
+  if (current < end && *current == '-')
+  {
+    negative = true;
+    current++;
+  }
+
+  const char* const digits_start = current;
+
+  for (; current < end && _json_is_digit(*current); ++current, ++n_digits)
+  {
+    const uint64_t digit = (uint64_t)(*current - '0');
+    if (n_significant == 0 && digit == 0)
+      continue;
+    if (n_significant < 19)
+    {
+      mantissa = mantissa * 10 + digit;
+      n_significant++;
+    }
+    else
+    {
+      truncated |= digit != 0;
+      exponent++;
+    }
+  }
+
+  if (current < end && *current == '.')
+  {
+    is_decimal = true;
+    current++;
+    for (; current < end && _json_is_digit(*current); ++current, ++n_digits)
+    {
+      const uint64_t digit = (uint64_t)(*current - '0');
+      if (n_significant == 0 && digit == 0)
+      {
+        exponent--;
+        continue;
+      }
+      if (n_significant < 19)
+      {
+        mantissa = mantissa * 10 + digit;
+        n_significant++;
+        exponent--;
+      }
+      else
+        truncated |= digit != 0;
+    }
+  }
+
+  // need at least one digit on either side of the decimal, e.g. "-" or "."
+  if (n_digits == 0)
+    return false;
+
+  int64_t explicit_exponent = 0;
+  if (current < end && (*current == 'e' || *current == 'E'))
+  {
+    is_decimal = true;
+    current++;
+
+    bool negative_exponent = false;
+    if (current < end && (*current == '+' || *current == '-'))
+    {
+      negative_exponent = *current == '-';
+      current++;
+    }
+
+    if (current == end || !_json_is_digit(*current))
+      return false;
+
+    for (; current < end && _json_is_digit(*current); ++current)
+      // anything this large is already well past zero or infinity
+      if (explicit_exponent < 100000)
+        explicit_exponent = explicit_exponent * 10 + (*current - '0');
+
+    if (negative_exponent)
+      explicit_exponent = -explicit_exponent;
+  }
+
+  *len = current - start;
+  exponent += explicit_exponent;
+
+  if (!is_decimal)
+  {
+    const uint64_t limit = negative ? UINT64_C(2147483648) : UINT64_C(2147483647);
+    if (exponent == 0 && mantissa <= limit)
+    {
+      *type = JSON_INT32;
+      value->int32 = negative ? (int32_t)(0 - mantissa) : (int32_t)mantissa;
+      return true;
+    }
+    // too big for an int32, keep it as a decimal instead of wrapping around
+  }
+
+  *type = JSON_DECIMAL;
+
+  if (mantissa == 0)
+  {
+    value->decimal = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+  // Clinger's fast path, both operands are exact so the one rounding
+  // in the multiply/divide gives the correctly rounded result
+  if (!truncated && exponent >= -22 && exponent <= 22
+      && mantissa <= (UINT64_C(1) << 53))
+  {
+    double result = (double)mantissa;
+    if (exponent < 0)
+      result /= _json_exact_pow10[-exponent];
+    else
+      result *= _json_exact_pow10[exponent];
+    value->decimal = negative ? -result : result;
+    return true;
+  }
+
+  // 10^(exponent + n_significant - 1) <= value, so these are certainly
+  // below the smallest subnormal / above DBL_MAX
+  if (exponent < JSON_POW5_MIN_EXPONENT)
+  {
+    value->decimal = negative ? -0.0 : 0.0;
+    return true;
+  }
+  if (exponent > JSON_POW5_MAX_EXPONENT)
+  {
+    value->decimal = negative ? -INFINITY : INFINITY;
+    return true;
+  }
+
+  uint64_t m = 0;
+  int biased_exponent = 0;
+  bool exact = _json_eisel_lemire(exponent, mantissa, &m, &biased_exponent);
+
+  // the real value is somewhere in [mantissa, mantissa + 1) * 10^exponent,
+  // if both ends round to the same double that's the answer
+  if (exact && truncated)
+  {
+    uint64_t m_upper = 0;
+    int biased_exponent_upper = 0;
+    exact = _json_eisel_lemire(exponent, mantissa + 1, &m_upper, &biased_exponent_upper)
+      && m == m_upper
+      && biased_exponent == biased_exponent_upper;
+  }
+
+  double result = _json_double_from_parts(m, biased_exponent, false);
+
+  if (!exact)
+  {
+    struct _json_decimal_digits_t decimal;
+    _json_collect_digits(digits_start, current, explicit_exponent, &decimal);
+    result = _json_slow_path(&decimal, result);
+  }
+
+  value->decimal = negative ? -result : result;
+  return true;
+}
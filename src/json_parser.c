@@ -0,0 +1,271 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_parser.h"
+#include "json_internal.h"
+
+struct json_parser_t*
+json_parser_new()
+{
+  return json_parser_new_with_options(NULL);
+}
+
+struct json_parser_t*
+json_parser_new_with_options(
+  const struct json_parse_options_t* const options)
+{
+  const struct json_parse_options_t* opts = options ? options : &_json_default_parse_options;
+
+  struct json_parser_t* parser = calloc(1, sizeof(*parser));
+  if (!parser)
+    return NULL;
+
+  // parse_info has const members, so it's built here and copied in
+  struct _json_parse_info_t parse_info = {
+    .json_string = NULL,
+    .json_string_len = 0,
+    .json_string_idx = 0,
+    .arena = opts->arena,
+    .flags = opts->flags,
+    .key_pool = opts->key_pool,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 16,
+    .structural_index = NULL
+  };
+  memcpy(&parser->parse_info, &parse_info, sizeof(parse_info));
+
+  parser->root_type = JSON_NOTYPE;
+  parser->root = NULL;
+  parser->expected_token = OPEN_BODY | OPEN_ARRAY;
+  parser->scanned = 0;
+  parser->failed = false;
+  parser->finished = false;
+
+  parser->parse_info.stack = malloc(parser->parse_info.stack_capacity * sizeof(*parser->parse_info.stack));
+  if (!parser->parse_info.stack
+      || !_json_string_builder_init(&parser->buffer, 256)
+      || !_json_string_builder_init(&parser->key, 64))
+  {
+    json_parser_free(&parser);
+    return NULL;
+  }
+
+  return parser;
+}
+
+// whether the token starting at idx also ends before the end of the
+// input. once the parser is finishing, the end of the input ends
+// numbers and literals too (but not strings)
+static bool
+_json_parser_token_complete(
+  struct json_parser_t* const parser,
+  const size_t idx,
+  const enum _token_e token)
+{
+  const char* const input = parser->parse_info.json_string;
+  const size_t len = parser->parse_info.json_string_len;
+
+  switch (token)
+  {
+    case QUOTE:
+    {
+      // pick up wherever the scan stopped at the end of the last chunk
+      size_t scan_idx = idx + 1 + parser->scanned;
+      for (;;)
+      {
+        scan_idx = _json_find_quote_or_backslash(input, scan_idx, len);
+        if (scan_idx >= len)
+        {
+          parser->scanned = len - idx - 1;
+          return false;
+        }
+
+        if (input[scan_idx] == '\"')
+        {
+          parser->scanned = 0;
+          return true;
+        }
+
+        // an escape cut off by the end of the chunk is scanned again
+        if (scan_idx + 1 >= len)
+        {
+          parser->scanned = scan_idx - idx - 1;
+          return false;
+        }
+        scan_idx += 2;
+      }
+    }
+
+    case NUMERIC:
+    case TEXT:
+    {
+      if (parser->finished)
+        return true;
+
+      size_t end_idx = idx;
+      while (end_idx < len
+          && (isalnum((unsigned char)input[end_idx])
+            || input[end_idx] == '.'
+            || input[end_idx] == '-'
+            || input[end_idx] == '+'))
+        end_idx++;
+      return end_idx < len;
+    }
+
+    default:
+      return true;
+  }
+}
+
+// parses every complete token in input[0, len), then keeps whatever is
+// left over (a cut off token) in the buffer for the next chunk. input
+// is either a newly fed chunk or the buffer itself
+static bool
+_json_parser_run(
+  struct json_parser_t* const parser,
+  const char* const input,
+  const size_t len)
+{
+  struct _json_parse_info_t* const parse_info = &parser->parse_info;
+  parse_info->json_string = input;
+  parse_info->json_string_len = len;
+  parse_info->json_string_idx = 0;
+
+  for (;;)
+  {
+    _json_skip_whitespace(parse_info);
+    const size_t idx = parse_info->json_string_idx;
+    if (idx == len)
+      break;
+
+    // nothing is expected once the root is closed
+    enum _token_e current_token = _json_token_class_masks[_json_token_classes[(unsigned char)input[idx]]];
+    if ((current_token & parser->expected_token) == 0)
+      return false;
+
+    if (!_json_parser_token_complete(parser, idx, current_token))
+      break;
+
+    // the root is created when its opening token arrives, since that's
+    // when it's known whether it's an object or array
+    const bool success = _json_parse_token(parse_info, &_json_tree_handler, &parser->root, &parser->expected_token);
+    if (parser->root && parser->root_type == JSON_NOTYPE)
+      parser->root_type = current_token == OPEN_BODY ? JSON_OBJECT : JSON_ARRAY;
+    if (!success)
+      return false;
+  }
+
+  // a key waiting for its value may point into input, which is about
+  // to be overwritten or handed back to the caller
+  if (parse_info->parsed_key >= input && parse_info->parsed_key < input + len)
+  {
+    parser->key.len = 0;
+    if (!_json_string_builder_append(&parser->key, parse_info->parsed_key, parse_info->parsed_key_len))
+      return false;
+    parse_info->parsed_key = parser->key.data;
+  }
+
+  const size_t consumed = parse_info->json_string_idx;
+  if (input == parser->buffer.data)
+  {
+    memmove(parser->buffer.data, &parser->buffer.data[consumed], len - consumed);
+    parser->buffer.len = len - consumed;
+    parser->buffer.data[parser->buffer.len] = '\0';
+    return true;
+  }
+
+  return _json_string_builder_append(&parser->buffer, &input[consumed], len - consumed);
+}
+
+bool
+json_parser_feed(
+  struct json_parser_t* const parser,
+  const char* const chunk,
+  const size_t len)
+{
+  if (!parser || parser->failed || parser->finished)
+    return false;
+
+  // if nothing was left over from the last chunk this one can be
+  // parsed in place, and only its own leftovers are copied
+  bool success = false;
+  if (parser->buffer.len == 0)
+    success = _json_parser_run(parser, chunk, len);
+  else
+    success = _json_string_builder_append(&parser->buffer, chunk, len)
+      && _json_parser_run(parser, parser->buffer.data, parser->buffer.len);
+
+  parser->failed = !success;
+  return success;
+}
+
+bool
+json_parser_finish(
+  struct json_parser_t* const parser)
+{
+  if (!parser || parser->failed || parser->finished)
+    return false;
+
+  parser->finished = true;
+  bool success = _json_parser_run(parser, parser->buffer.data, parser->buffer.len)
+    && parser->root_type != JSON_NOTYPE
+    && parser->parse_info.stack_len == 0
+    && parser->buffer.len == 0;
+
+  parser->failed = !success;
+  return success;
+}
+
+struct json_t*
+json_parser_take_object(
+  struct json_parser_t* const parser)
+{
+  if (!parser || !parser->finished || parser->failed || parser->root_type != JSON_OBJECT)
+    return NULL;
+
+  struct json_t* json = parser->root;
+  parser->root = NULL;
+  return json;
+}
+
+struct json_array_t*
+json_parser_take_array(
+  struct json_parser_t* const parser)
+{
+  if (!parser || !parser->finished || parser->failed || parser->root_type != JSON_ARRAY)
+    return NULL;
+
+  struct json_array_t* array = parser->root;
+  parser->root = NULL;
+  return array;
+}
+
+void
+json_parser_free(
+  struct json_parser_t** parser)
+{
+  if (!*parser)
+    return;
+
+  if ((*parser)->root && (*parser)->root_type == JSON_OBJECT)
+  {
+    struct json_t* json = (*parser)->root;
+    json_free(&json);
+  }
+  else if ((*parser)->root && (*parser)->root_type == JSON_ARRAY)
+  {
+    struct json_array_t* array = (*parser)->root;
+    json_array_free(&array);
+  }
+
+  free((*parser)->parse_info.stack);
+  _json_string_builder_free(&(*parser)->buffer);
+  _json_string_builder_free(&(*parser)->key);
+  free(*parser);
+  *parser = NULL;
+}
@@ -0,0 +1,147 @@
+#include "json.h"
+#include "json_internal.h"
+#include "json_sax.h"
+
+static bool
+_json_sax_open(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  const size_t start,
+  void** container)
+{
+  (void)parse_info;
+  (void)start;
+  (void)container;
+  const struct _json_sax_parser_t* const parser = ctx;
+  const struct json_sax_handler_t* const handler = parser->handler;
+
+  if (type == JSON_OBJECT)
+    return !handler->start_object || handler->start_object(parser->user_data);
+  return !handler->start_array || handler->start_array(parser->user_data);
+}
+
+static bool
+_json_sax_close(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start)
+{
+  (void)start;
+  const struct _json_sax_parser_t* const parser = ctx;
+  const struct json_sax_handler_t* const handler = parser->handler;
+
+  if (parse_info->stack[parse_info->stack_len - 1].type == JSON_OBJECT)
+    return !handler->end_object || handler->end_object(parser->user_data);
+  return !handler->end_array || handler->end_array(parser->user_data);
+}
+
+static bool
+_json_sax_key(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start,
+  const size_t len)
+{
+  const struct _json_sax_parser_t* const parser = ctx;
+  const struct json_sax_handler_t* const handler = parser->handler;
+  return !handler->key || handler->key(parser->user_data, &parse_info->json_string[start], len);
+}
+
+static bool
+_json_sax_value(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  union value* const value,
+  const size_t start,
+  const size_t len)
+{
+  const struct _json_sax_parser_t* const parser = ctx;
+  const struct json_sax_handler_t* const handler = parser->handler;
+
+  switch (type)
+  {
+    case JSON_STRING:
+      return !handler->string || handler->string(parser->user_data, &parse_info->json_string[start], len);
+    case JSON_INT32:
+      return !handler->int32 || handler->int32(parser->user_data, value->int32);
+    case JSON_DECIMAL:
+      return !handler->decimal || handler->decimal(parser->user_data, value->decimal);
+    case JSON_BOOL:
+      return !handler->boolean || handler->boolean(parser->user_data, value->boolean);
+    case JSON_NULL:
+      return !handler->null || handler->null(parser->user_data);
+    default:
+      return false;
+  }
+}
+
+static const struct _json_token_handler_t _json_sax_token_handler = {
+  .open = _json_sax_open,
+  .close = _json_sax_close,
+  .key = _json_sax_key,
+  .value = _json_sax_value,
+  .defer_numbers = false
+};
+
+bool
+json_sax_parse_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data)
+{
+  struct _json_sax_parser_t parser = {
+    .handler = handler,
+    .user_data = user_data
+  };
+
+  struct _json_parse_info_t parse_info = {
+    .json_string = buffer,
+    .json_string_len = len,
+    .json_string_idx = 0,
+    .arena = NULL,
+    .flags = flags,
+    .key_pool = NULL,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 0,
+    .structural_index = NULL
+  };
+
+  return _json_parse_tokens(&parse_info, &_json_sax_token_handler, &parser, OPEN_BODY | OPEN_ARRAY);
+}
+
+bool
+json_sax_parse_from_string(
+  const char* const json_string,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data)
+{
+  return json_sax_parse_from_buffer(json_string, strlen(json_string), flags, handler, user_data);
+}
+
+bool
+json_sax_parse_from_file(
+  const char* const filepath,
+  const uint32_t flags,
+  const struct json_sax_handler_t* const handler,
+  void* user_data)
+{
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return false;
+
+  bool success = json_sax_parse_from_buffer(file_buffer.contents, file_buffer.len, flags, handler, user_data);
+  _json_release_file(&file_buffer);
+
+  return success;
+}
@@ -9,11 +9,11 @@ json_set_int32(
   const int32_t value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_INT32;
   item->value.int32 = value;
   return true;
@@ -26,11 +26,11 @@ json_set_decimal(
   const double value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_DECIMAL;
   item->value.decimal = value;
   return true;
@@ -43,13 +43,18 @@ json_set_string(
   char* value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_STRING;
   item->value.str = value;
+
+  // heap values given to an arena-backed object are freed with the arena
+  if (json->arena)
+    return _json_arena_adopt(json->arena, JSON_STRING, value);
+
   return true;
 }
 
@@ -60,13 +65,18 @@ json_set_object(
   struct json_t* value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_OBJECT;
   item->value.object = value;
+
+  // heap values given to an arena-backed object are freed with the arena
+  if (json->arena)
+    return _json_arena_adopt(json->arena, JSON_OBJECT, value);
+
   return true;
 }
 
@@ -77,13 +87,18 @@ json_set_array(
   struct json_array_t* value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_ARRAY;
   item->value.array = value;
+
+  // heap values given to an arena-backed object are freed with the arena
+  if (json->arena)
+    return _json_arena_adopt(json->arena, JSON_ARRAY, value);
+
   return true;
 }
 
@@ -94,11 +109,11 @@ json_set_bool(
   const bool value)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_BOOL;
   item->value.boolean = value;
   return true;
@@ -110,11 +125,11 @@ json_set_null(
   const char* const key)
 {
   bool key_exists = false;
-  size_t idx = _json_get_key_index(json, key, &key_exists);
+  size_t idx = _json_get_key_index(json, key, strlen(key), &key_exists);
   if (!key_exists)
     return false;
   struct json_item_t* item = &json->items[idx];
-  _json_deallocate_item(item);
+  _json_deallocate_item(json->arena, item);
   item->type = JSON_NULL;
   item->value.is_null = true;
   return true;
@@ -0,0 +1,1012 @@
+#include "json.h"
+#include "json_internal.h"
+
+// stage 1 of parsing (in the style of simdjson): find every structural
+// character ({}[],:) outside of strings and the first byte of every string,
+// number and literal, 64 bytes at a time. the parser then jumps from one
+// position to the next instead of classifying every byte.
+//
+// only building the per-block bitmasks is architecture specific, everything
+// after that is plain 64-bit arithmetic shared by all of the kernels
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_HAS_X86_SIMD
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define JSON_HAS_NEON_SIMD
+#include <arm_neon.h>
+#endif
+
+// the block loop and everything it calls is inlined into one copy per
+// kernel, so the mask function is a direct call and the AVX2 copy can use
+// popcnt/tzcnt as well
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define JSON_ALWAYS_INLINE inline
+#endif
+
+// bitmasks for one 64-byte block, bit i is byte i
+struct _json_block_masks_t
+{
+  uint64_t backslash;
+  uint64_t quote;
+  uint64_t whitespace;
+  // {}[],:
+  uint64_t op;
+};
+
+static void
+_json_block_masks_scalar(
+  const unsigned char* const block,
+  struct _json_block_masks_t* const masks)
+{
+  masks->backslash = 0;
+  masks->quote = 0;
+  masks->whitespace = 0;
+  masks->op = 0;
+
+  for (size_t i = 0; i < 64; ++i)
+  {
+    const uint64_t bit = UINT64_C(1) << i;
+    switch (block[i])
+    {
+      case '\\':
+        masks->backslash |= bit;
+        break;
+      case '\"':
+        masks->quote |= bit;
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        masks->whitespace |= bit;
+        break;
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ',':
+      case ':':
+        masks->op |= bit;
+        break;
+    }
+  }
+}
+
+#ifdef JSON_HAS_X86_SIMD
+
+__attribute__((target("sse2")))
+static void
+_json_block_masks_sse2(
+  const unsigned char* const block,
+  struct _json_block_masks_t* const masks)
+{
+  masks->backslash = 0;
+  masks->quote = 0;
+  masks->whitespace = 0;
+  masks->op = 0;
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)&block[i * 16]);
+    const size_t shift = i * 16;
+
+    #define JSON_EQ(c) _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c))
+    const __m128i whitespace = _mm_or_si128(
+      _mm_or_si128(JSON_EQ(' '), JSON_EQ('\t')),
+      _mm_or_si128(JSON_EQ('\n'), JSON_EQ('\r')));
+    // '[' and ']' and '{' and '}' only differ in bit 5 (0x20)
+    const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    const __m128i op = _mm_or_si128(
+      _mm_or_si128(
+        _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+        _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+      _mm_or_si128(JSON_EQ(','), JSON_EQ(':')));
+
+    masks->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(JSON_EQ('\\')) << shift;
+    masks->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(JSON_EQ('\"')) << shift;
+    #undef JSON_EQ
+    masks->whitespace |= (uint64_t)(uint16_t)_mm_movemask_epi8(whitespace) << shift;
+    masks->op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+  }
+}
+
+__attribute__((target("avx2")))
+static void
+_json_block_masks_avx2(
+  const unsigned char* const block,
+  struct _json_block_masks_t* const masks)
+{
+  masks->backslash = 0;
+  masks->quote = 0;
+  masks->whitespace = 0;
+  masks->op = 0;
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const __m256i chunk = _mm256_loadu_si256((const __m256i*)&block[i * 32]);
+    const size_t shift = i * 32;
+
+    #define JSON_EQ(c) _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c))
+    const __m256i whitespace = _mm256_or_si256(
+      _mm256_or_si256(JSON_EQ(' '), JSON_EQ('\t')),
+      _mm256_or_si256(JSON_EQ('\n'), JSON_EQ('\r')));
+    const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    const __m256i op = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+        _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+      _mm256_or_si256(JSON_EQ(','), JSON_EQ(':')));
+
+    masks->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(JSON_EQ('\\')) << shift;
+    masks->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(JSON_EQ('\"')) << shift;
+    #undef JSON_EQ
+    masks->whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(whitespace) << shift;
+    masks->op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+  }
+}
+
+#endif
+
+enum _json_simd_level_e
+_json_simd_detect(void)
+{
+#ifdef JSON_HAS_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return JSON_SIMD_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return JSON_SIMD_SSE2;
+#endif
+  return JSON_SIMD_SCALAR;
+}
+
+static JSON_ALWAYS_INLINE size_t
+_json_trailing_zeros(
+  uint64_t bits)
+{
+  bits |= UINT64_C(1) << 63;
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctzll(bits);
+#else
+  size_t n_zeros = 0;
+  while (!(bits & 1))
+  {
+    bits >>= 1;
+    n_zeros++;
+  }
+  return n_zeros;
+#endif
+}
+
+static JSON_ALWAYS_INLINE size_t
+_json_count_bits(
+  uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_popcountll(bits);
+#else
+  size_t n_bits = 0;
+  for (; bits != 0; bits &= bits - 1)
+    n_bits++;
+  return n_bits;
+#endif
+}
+
+// bit i of the result is the xor of bits 0..i, i.e., set for every byte
+// from an opening quote up to (not including) its closing quote
+static JSON_ALWAYS_INLINE uint64_t
+_json_prefix_xor(
+  uint64_t bits)
+{
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// the bytes escaped by an odd-length run of backslashes, carrying a run
+// that reaches the end of the block into the next one
+static JSON_ALWAYS_INLINE uint64_t
+_json_find_escaped(
+  const uint64_t backslash,
+  uint64_t* const prev_ends_odd_backslash)
+{
+  const uint64_t even_bits = UINT64_C(0x5555555555555555);
+  const uint64_t odd_bits = ~even_bits;
+
+  const uint64_t start_edges = backslash & ~(backslash << 1);
+  // flip the parity if the previous block ended in an odd run
+  const uint64_t even_start_mask = even_bits ^ *prev_ends_odd_backslash;
+  const uint64_t even_starts = start_edges & even_start_mask;
+  const uint64_t odd_starts = start_edges & ~even_start_mask;
+  const uint64_t even_carries = backslash + even_starts;
+
+  uint64_t odd_carries = backslash + odd_starts;
+  const bool ends_odd_backslash = odd_carries < backslash;
+  odd_carries |= *prev_ends_odd_backslash;
+  *prev_ends_odd_backslash = ends_odd_backslash ? 1 : 0;
+
+  const uint64_t even_carry_ends = even_carries & ~backslash;
+  const uint64_t odd_carry_ends = odd_carries & ~backslash;
+  const uint64_t even_start_odd_end = even_carry_ends & odd_bits;
+  const uint64_t odd_start_even_end = odd_carry_ends & even_bits;
+  return even_start_odd_end | odd_start_even_end;
+}
+
+static JSON_ALWAYS_INLINE uint64_t
+_json_structural_bits(
+  struct _json_structural_index_t* const index,
+  const struct _json_block_masks_t* const masks)
+{
+  const uint64_t escaped = _json_find_escaped(masks->backslash, &index->prev_ends_odd_backslash);
+  const uint64_t quote = masks->quote & ~escaped;
+  const uint64_t in_string = _json_prefix_xor(quote) ^ index->prev_in_string;
+  index->prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+
+  // the first byte of every run of non-structural, non-whitespace bytes
+  // is where a string, number or literal starts. a quote ends a run, so
+  // something glued onto the end of a string still gets its own position
+  const uint64_t scalar = ~(masks->op | masks->whitespace);
+  const uint64_t nonquote_scalar = scalar & ~quote;
+  const uint64_t follows_nonquote_scalar = (nonquote_scalar << 1) | index->prev_ends_scalar;
+  index->prev_ends_scalar = nonquote_scalar >> 63;
+  const uint64_t scalar_starts = scalar & ~follows_nonquote_scalar;
+
+  // string contents and closing quotes, everything in_string has but the
+  // opening quote
+  const uint64_t string_tail = in_string ^ quote;
+  return (masks->op | scalar_starts) & ~string_tail;
+}
+
+static JSON_ALWAYS_INLINE void
+_json_index_blocks(
+  struct _json_structural_index_t* const index,
+  const size_t window_end,
+  void (*block_masks)(const unsigned char* const, struct _json_block_masks_t* const))
+{
+  while (index->scanned < window_end)
+  {
+    const size_t base = index->scanned;
+    const unsigned char* block = (const unsigned char*)&index->input[base];
+
+    // pad the last partial block with whitespace, which is never indexed
+    unsigned char padded[64];
+    if (window_end - base < 64)
+    {
+      memset(padded, ' ', sizeof(padded));
+      memcpy(padded, block, window_end - base);
+      block = padded;
+    }
+
+    struct _json_block_masks_t masks;
+    block_masks(block, &masks);
+
+    // written 4 at a time, which is cheaper than a mispredicted branch
+    // per position. slots past the last real one are just overwritten by
+    // the next block (positions has room for a whole block of slack)
+    uint64_t bits = _json_structural_bits(index, &masks);
+    uint32_t* positions = &index->positions[index->n_positions];
+    const uint32_t offset = (uint32_t)(base - index->window_start);
+    index->n_positions += _json_count_bits(bits);
+    while (bits != 0)
+    {
+      for (size_t i = 0; i < 4; ++i)
+      {
+        positions[i] = offset + (uint32_t)_json_trailing_zeros(bits);
+        bits &= bits - 1;
+      }
+      positions += 4;
+    }
+
+    index->scanned += 64;
+  }
+}
+
+#ifdef JSON_HAS_X86_SIMD
+
+__attribute__((target("sse2")))
+static void
+_json_index_blocks_sse2(
+  struct _json_structural_index_t* const index,
+  const size_t window_end)
+{
+  _json_index_blocks(index, window_end, _json_block_masks_sse2);
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static void
+_json_index_blocks_avx2(
+  struct _json_structural_index_t* const index,
+  const size_t window_end)
+{
+  _json_index_blocks(index, window_end, _json_block_masks_avx2);
+}
+
+#endif
+
+bool
+_json_structural_index_init(
+  struct _json_structural_index_t* const index,
+  const char* const input,
+  const size_t input_len,
+  const enum _json_simd_level_e level)
+{
+  index->input = input;
+  index->input_len = input_len;
+  index->level = level;
+  index->scanned = 0;
+  index->window_start = index->scanned;
+  index->n_positions = 0;
+  index->position_idx = 0;
+  index->prev_ends_odd_backslash = 0;
+  index->prev_in_string = 0;
+  index->prev_ends_scalar = 0;
+
+  // at most one position per byte, plus slack for the last block's
+  // unrolled writes
+  index->positions = malloc((JSON_STRUCTURAL_WINDOW + 64) * sizeof(*index->positions));
+  return index->positions != NULL;
+}
+
+void
+_json_structural_index_free(
+  struct _json_structural_index_t* const index)
+{
+  free(index->positions);
+  index->positions = NULL;
+}
+
+// indexes the next window of input. returns false once there's nothing
+// left to index
+static bool
+_json_structural_index_fill(
+  struct _json_structural_index_t* const index)
+{
+  if (index->scanned >= index->input_len)
+    return false;
+
+  const size_t window_end = index->input_len - index->scanned > JSON_STRUCTURAL_WINDOW
+    ? index->scanned + JSON_STRUCTURAL_WINDOW
+    : index->input_len;
+
+  index->window_start = index->scanned;
+  index->n_positions = 0;
+  index->position_idx = 0;
+
+  switch (index->level)
+  {
+#ifdef JSON_HAS_X86_SIMD
+    case JSON_SIMD_AVX2:
+      _json_index_blocks_avx2(index, window_end);
+      break;
+    case JSON_SIMD_SSE2:
+      _json_index_blocks_sse2(index, window_end);
+      break;
+#endif
+    default:
+      _json_index_blocks(index, window_end, _json_block_masks_scalar);
+      break;
+  }
+
+  index->scanned = window_end;
+  return true;
+}
+
+bool
+_json_structural_index_next(
+  struct _json_structural_index_t* const index,
+  size_t* const position)
+{
+  while (index->position_idx == index->n_positions)
+    if (!_json_structural_index_fill(index))
+      return false;
+
+  *position = index->window_start + index->positions[index->position_idx++];
+  return true;
+}
+
+// ---- scanning kernels ----
+//
+// used by the parser to skip whitespace and to find the end of strings.
+// the SIMD versions look at 16 or 32 bytes at a time but never read past
+// len, the tail is finished off one byte at a time
+
+static size_t
+_json_find_non_whitespace_scalar(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  while (idx < len && _json_is_whitespace(input[idx]))
+    idx++;
+  return idx;
+}
+
+static size_t
+_json_find_quote_or_backslash_scalar(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  while (idx < len && input[idx] != '\"' && input[idx] != '\\')
+    idx++;
+  return idx;
+}
+
+#ifdef JSON_HAS_X86_SIMD
+
+__attribute__((target("sse2")))
+static size_t
+_json_find_non_whitespace_sse2(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 16 <= len; idx += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)&input[idx]);
+    const __m128i whitespace = _mm_or_si128(
+      _mm_or_si128(
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+      _mm_or_si128(
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+    const uint32_t mask = ~(uint32_t)_mm_movemask_epi8(whitespace) & 0xFFFF;
+    if (mask != 0)
+      return idx + _json_trailing_zeros(mask);
+  }
+
+  return _json_find_non_whitespace_scalar(input, idx, len);
+}
+
+__attribute__((target("avx2")))
+static size_t
+_json_find_non_whitespace_avx2(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 32 <= len; idx += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256((const __m256i*)&input[idx]);
+    const __m256i whitespace = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(
+        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+    const uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(whitespace);
+    if (mask != 0)
+      return idx + _json_trailing_zeros(mask);
+  }
+
+  // the compiler doesn't clear the upper halves before a tail call, and
+  // the (non-VEX) SSE2 code runs much slower until they are
+  _mm256_zeroupper();
+  return _json_find_non_whitespace_sse2(input, idx, len);
+}
+
+__attribute__((target("sse2")))
+static size_t
+_json_find_quote_or_backslash_sse2(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 16 <= len; idx += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)&input[idx]);
+    const __m128i found = _mm_or_si128(
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"')),
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+    const uint32_t mask = (uint32_t)_mm_movemask_epi8(found);
+    if (mask != 0)
+      return idx + _json_trailing_zeros(mask);
+  }
+
+  return _json_find_quote_or_backslash_scalar(input, idx, len);
+}
+
+__attribute__((target("avx2")))
+static size_t
+_json_find_quote_or_backslash_avx2(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 32 <= len; idx += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256((const __m256i*)&input[idx]);
+    const __m256i found = _mm256_or_si256(
+      _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\"')),
+      _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+    const uint32_t mask = (uint32_t)_mm256_movemask_epi8(found);
+    if (mask != 0)
+      return idx + _json_trailing_zeros(mask);
+  }
+
+  // see _json_find_non_whitespace_avx2
+  _mm256_zeroupper();
+  return _json_find_quote_or_backslash_sse2(input, idx, len);
+}
+
+#endif
+
+#ifdef JSON_HAS_NEON_SIMD
+
+// NEON has no movemask, narrowing each 16-bit lane by 4 bits instead
+// leaves a 64-bit mask with 4 bits per byte
+static uint64_t
+_json_neon_nibble_mask(
+  const uint8x16_t matches)
+{
+  const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static size_t
+_json_find_non_whitespace_neon(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 16 <= len; idx += 16)
+  {
+    const uint8x16_t chunk = vld1q_u8((const uint8_t*)&input[idx]);
+    const uint8x16_t whitespace = vorrq_u8(
+      vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\t'))),
+      vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+    const uint64_t mask = _json_neon_nibble_mask(vmvnq_u8(whitespace));
+    if (mask != 0)
+      return idx + (_json_trailing_zeros(mask) >> 2);
+  }
+
+  return _json_find_non_whitespace_scalar(input, idx, len);
+}
+
+static size_t
+_json_find_quote_or_backslash_neon(
+  const char* const input,
+  size_t idx,
+  const size_t len)
+{
+  for (; idx + 16 <= len; idx += 16)
+  {
+    const uint8x16_t chunk = vld1q_u8((const uint8_t*)&input[idx]);
+    const uint8x16_t found = vorrq_u8(
+      vceqq_u8(chunk, vdupq_n_u8('\"')),
+      vceqq_u8(chunk, vdupq_n_u8('\\')));
+    const uint64_t mask = _json_neon_nibble_mask(found);
+    if (mask != 0)
+      return idx + (_json_trailing_zeros(mask) >> 2);
+  }
+
+  return _json_find_quote_or_backslash_scalar(input, idx, len);
+}
+
+#endif
+
+size_t
+_json_find_non_whitespace(
+  const char* const input,
+  const size_t idx,
+  const size_t len)
+{
+  // in minified input there's usually no whitespace at all, and short
+  // runs aren't worth setting up a vector for
+  if (idx >= len || !_json_is_whitespace(input[idx]))
+    return idx;
+  if (idx + 1 >= len || !_json_is_whitespace(input[idx + 1]))
+    return idx + 1;
+
+#if defined(JSON_HAS_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    return _json_find_non_whitespace_avx2(input, idx + 2, len);
+  if (__builtin_cpu_supports("sse2"))
+    return _json_find_non_whitespace_sse2(input, idx + 2, len);
+#elif defined(JSON_HAS_NEON_SIMD)
+  return _json_find_non_whitespace_neon(input, idx + 2, len);
+#endif
+  return _json_find_non_whitespace_scalar(input, idx + 2, len);
+}
+
+size_t
+_json_find_quote_or_backslash(
+  const char* const input,
+  const size_t idx,
+  const size_t len)
+{
+#if defined(JSON_HAS_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    return _json_find_quote_or_backslash_avx2(input, idx, len);
+  if (__builtin_cpu_supports("sse2"))
+    return _json_find_quote_or_backslash_sse2(input, idx, len);
+#elif defined(JSON_HAS_NEON_SIMD)
+  return _json_find_quote_or_backslash_neon(input, idx, len);
+#endif
+  return _json_find_quote_or_backslash_scalar(input, idx, len);
+}
+
+// UTF-8 validation, used by the JSON_PARSE_VALIDATE_UTF8 flag on the
+// bytes of every string as soon as it's been scanned (anything else that
+// isn't ASCII is already rejected by the parser).
+//
+// the AVX2 kernel is the lookup algorithm from simdjson (Keiser & Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte"), which checks
+// 32 bytes at a time without branching on the contents. the others skip
+// over ASCII a vector at a time and decode anything else byte by byte
+
+// the length of the valid sequence starting at input[0], 0 if it isn't one
+static size_t
+_json_utf8_sequence_len(
+  const unsigned char* const input,
+  const size_t len)
+{
+  const unsigned char lead = input[0];
+  if (lead < 0x80)
+    return 1;
+
+  size_t n_bytes;
+  // the allowed range of the second byte, which rules out overlong
+  // encodings, surrogates and anything past U+10FFFF
+  unsigned char min = 0x80;
+  unsigned char max = 0xBF;
+  if (lead < 0xC2)
+    return 0;
+  else if (lead < 0xE0)
+    n_bytes = 2;
+  else if (lead < 0xF0)
+  {
+    n_bytes = 3;
+    if (lead == 0xE0)
+      min = 0xA0;
+    else if (lead == 0xED)
+      max = 0x9F;
+  }
+  else if (lead < 0xF5)
+  {
+    n_bytes = 4;
+    if (lead == 0xF0)
+      min = 0x90;
+    else if (lead == 0xF4)
+      max = 0x8F;
+  }
+  else
+    return 0;
+
+  if (len < n_bytes || input[1] < min || input[1] > max)
+    return 0;
+  for (size_t i = 2; i < n_bytes; ++i)
+    if ((input[i] & 0xC0) != 0x80)
+      return 0;
+
+  return n_bytes;
+}
+
+// validates input[idx, end) and returns where it stopped, which is at or
+// past end if everything was valid and sequences may run past end (up to
+// len). on failure returns SIZE_MAX
+static size_t
+_json_validate_utf8_until(
+  const unsigned char* const input,
+  size_t idx,
+  const size_t end,
+  const size_t len)
+{
+  while (idx < end)
+  {
+    // skip ASCII a word at a time
+    uint64_t word;
+    if (idx + 8 <= end)
+    {
+      memcpy(&word, &input[idx], sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0)
+      {
+        idx += 8;
+        continue;
+      }
+    }
+
+    const size_t n_bytes = _json_utf8_sequence_len(&input[idx], len - idx);
+    if (n_bytes == 0)
+      return SIZE_MAX;
+    idx += n_bytes;
+  }
+
+  return idx;
+}
+
+static bool
+_json_validate_utf8_scalar(
+  const char* const input,
+  const size_t len)
+{
+  return _json_validate_utf8_until((const unsigned char*)input, 0, len, len) != SIZE_MAX;
+}
+
+#ifdef JSON_HAS_X86_SIMD
+
+__attribute__((target("sse2")))
+static bool
+_json_validate_utf8_sse2(
+  const char* const input,
+  const size_t len)
+{
+  size_t idx = 0;
+  while (idx + 16 <= len)
+  {
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)&input[idx]);
+    if (_mm_movemask_epi8(chunk) == 0)
+    {
+      idx += 16;
+      continue;
+    }
+
+    // the chunk starts on a character boundary, so decode up to the end
+    // of it (and whatever sequence straddles the end)
+    idx = _json_validate_utf8_until((const unsigned char*)input, idx, idx + 16, len);
+    if (idx == SIZE_MAX)
+      return false;
+  }
+
+  return _json_validate_utf8_until((const unsigned char*)input, idx, len, len) != SIZE_MAX;
+}
+
+// the error bits each table can contribute, an error is a bit set in all
+// three lookups for a pair of adjacent bytes
+#define JSON_UTF8_TOO_SHORT  (1 << 0) // a lead byte not followed by a continuation
+#define JSON_UTF8_TOO_LONG   (1 << 1) // a continuation after ASCII
+#define JSON_UTF8_OVERLONG_3 (1 << 2) // 11100000 100_____
+#define JSON_UTF8_TOO_LARGE  (1 << 3) // past U+10FFFF
+#define JSON_UTF8_SURROGATE  (1 << 4) // 11101101 101_____
+#define JSON_UTF8_OVERLONG_2 (1 << 5) // 1100000_ 10______
+#define JSON_UTF8_TOO_LARGE_1000 (1 << 6) // 11110101+ 1000____
+#define JSON_UTF8_OVERLONG_4 (1 << 6) // 11110000 1000____
+#define JSON_UTF8_TWO_CONTS  (1 << 7) // two continuations in a row
+#define JSON_UTF8_CARRY (JSON_UTF8_TOO_SHORT | JSON_UTF8_TOO_LONG | JSON_UTF8_TWO_CONTS)
+
+// indexed by the high nibble of the first byte of each pair
+static const uint8_t _json_utf8_byte_1_high[16] =
+{
+  // 0_______ ________
+  JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG,
+  JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG, JSON_UTF8_TOO_LONG,
+  // 10______ ________
+  JSON_UTF8_TWO_CONTS, JSON_UTF8_TWO_CONTS, JSON_UTF8_TWO_CONTS, JSON_UTF8_TWO_CONTS,
+  // 1100____ ________
+  JSON_UTF8_TOO_SHORT | JSON_UTF8_OVERLONG_2,
+  // 1101____ ________
+  JSON_UTF8_TOO_SHORT,
+  // 1110____ ________
+  JSON_UTF8_TOO_SHORT | JSON_UTF8_OVERLONG_3 | JSON_UTF8_SURROGATE,
+  // 1111____ ________
+  JSON_UTF8_TOO_SHORT | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_OVERLONG_4
+};
+
+// indexed by the low nibble of the first byte
+static const uint8_t _json_utf8_byte_1_low[16] =
+{
+  // ____0000 ________
+  JSON_UTF8_CARRY | JSON_UTF8_OVERLONG_3 | JSON_UTF8_OVERLONG_2 | JSON_UTF8_OVERLONG_4,
+  // ____0001 ________
+  JSON_UTF8_CARRY | JSON_UTF8_OVERLONG_2,
+  // ____001_ ________
+  JSON_UTF8_CARRY,
+  JSON_UTF8_CARRY,
+  // ____0100 ________
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE,
+  // ____0101 ________ and up
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  // ____1101 ________
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_SURROGATE,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000,
+  JSON_UTF8_CARRY | JSON_UTF8_TOO_LARGE | JSON_UTF8_TOO_LARGE_1000
+};
+
+// indexed by the high nibble of the second byte
+static const uint8_t _json_utf8_byte_2_high[16] =
+{
+  // ________ 0_______
+  JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT,
+  JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT,
+  // ________ 1000____
+  JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTS | JSON_UTF8_OVERLONG_3
+    | JSON_UTF8_TOO_LARGE_1000 | JSON_UTF8_OVERLONG_4,
+  // ________ 1001____
+  JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTS | JSON_UTF8_OVERLONG_3
+    | JSON_UTF8_TOO_LARGE,
+  // ________ 101_____
+  JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTS | JSON_UTF8_SURROGATE
+    | JSON_UTF8_TOO_LARGE,
+  JSON_UTF8_TOO_LONG | JSON_UTF8_OVERLONG_2 | JSON_UTF8_TWO_CONTS | JSON_UTF8_SURROGATE
+    | JSON_UTF8_TOO_LARGE,
+  // ________ 11______
+  JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT, JSON_UTF8_TOO_SHORT
+};
+
+// each lookup indexes a 16-entry table by a nibble, the tables are
+// repeated in both 128-bit lanes since vpshufb doesn't cross them
+#define JSON_UTF8_TABLE(table) \
+  _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(table)))
+
+__attribute__((target("avx2")))
+static JSON_ALWAYS_INLINE __m256i
+_json_utf8_high_nibbles(
+  const __m256i bytes)
+{
+  return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+}
+
+// the error bits for chunk given the 32 bytes before it
+__attribute__((target("avx2")))
+static JSON_ALWAYS_INLINE __m256i
+_json_utf8_chunk_errors(
+  const __m256i chunk,
+  const __m256i prev_chunk)
+{
+  // the bytes 1, 2 and 3 places before each byte of chunk
+  const __m256i straddle = _mm256_permute2x128_si256(prev_chunk, chunk, 0x21);
+  const __m256i prev1 = _mm256_alignr_epi8(chunk, straddle, 15);
+  const __m256i prev2 = _mm256_alignr_epi8(chunk, straddle, 14);
+  const __m256i prev3 = _mm256_alignr_epi8(chunk, straddle, 13);
+
+  const __m256i byte_1_high = _mm256_shuffle_epi8(
+    JSON_UTF8_TABLE(_json_utf8_byte_1_high),
+    _json_utf8_high_nibbles(prev1));
+
+  const __m256i byte_1_low = _mm256_shuffle_epi8(
+    JSON_UTF8_TABLE(_json_utf8_byte_1_low),
+    _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+
+  const __m256i byte_2_high = _mm256_shuffle_epi8(
+    JSON_UTF8_TABLE(_json_utf8_byte_2_high),
+    _json_utf8_high_nibbles(chunk));
+
+  const __m256i special_cases = _mm256_and_si256(
+    _mm256_and_si256(byte_1_high, byte_1_low),
+    byte_2_high);
+
+  // the third and fourth bytes of a sequence have to be continuations,
+  // which shows up above as TWO_CONTS. anything >= 0x80 after the
+  // saturating subtract was a 3 or 4 byte lead
+  const __m256i must_be_continuation = _mm256_and_si256(
+    _mm256_or_si256(
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)))),
+    _mm256_set1_epi8((char)0x80));
+
+  return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+// non-zero wherever a sequence starting in the last 3 bytes of chunk
+// runs past the end of it
+__attribute__((target("avx2")))
+static JSON_ALWAYS_INLINE __m256i
+_json_utf8_incomplete(
+  const __m256i chunk)
+{
+  const __m256i max = _mm256_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+  return _mm256_subs_epu8(chunk, max);
+}
+
+__attribute__((target("avx2")))
+static bool
+_json_validate_utf8_avx2(
+  const char* const input,
+  const size_t len)
+{
+  __m256i errors = _mm256_setzero_si256();
+  __m256i prev_chunk = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+
+  size_t idx = 0;
+  for (; idx + 32 <= len; idx += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256((const __m256i*)&input[idx]);
+    if (_mm256_movemask_epi8(chunk) == 0)
+    {
+      // an ASCII chunk can't finish a sequence from the one before
+      errors = _mm256_or_si256(errors, prev_incomplete);
+      prev_incomplete = _mm256_setzero_si256();
+    }
+    else
+    {
+      errors = _mm256_or_si256(errors, _json_utf8_chunk_errors(chunk, prev_chunk));
+      prev_incomplete = _json_utf8_incomplete(chunk);
+    }
+    prev_chunk = chunk;
+  }
+
+  // the tail is padded with zeros (ASCII), which also catches a
+  // sequence cut off by the end of the input
+  if (idx < len)
+  {
+    char tail[32] = {0};
+    memcpy(tail, &input[idx], len - idx);
+    const __m256i chunk = _mm256_loadu_si256((const __m256i*)tail);
+    errors = _mm256_or_si256(errors, _json_utf8_chunk_errors(chunk, prev_chunk));
+  }
+  else
+    errors = _mm256_or_si256(errors, prev_incomplete);
+
+  return _mm256_testz_si256(errors, errors);
+}
+
+#undef JSON_UTF8_TABLE
+#undef JSON_UTF8_TOO_SHORT
+#undef JSON_UTF8_TOO_LONG
+#undef JSON_UTF8_OVERLONG_3
+#undef JSON_UTF8_TOO_LARGE
+#undef JSON_UTF8_SURROGATE
+#undef JSON_UTF8_OVERLONG_2
+#undef JSON_UTF8_TOO_LARGE_1000
+#undef JSON_UTF8_OVERLONG_4
+#undef JSON_UTF8_TWO_CONTS
+#undef JSON_UTF8_CARRY
+
+#endif
+
+#ifdef JSON_HAS_NEON_SIMD
+
+static bool
+_json_validate_utf8_neon(
+  const char* const input,
+  const size_t len)
+{
+  size_t idx = 0;
+  while (idx + 16 <= len)
+  {
+    const uint8x16_t chunk = vld1q_u8((const uint8_t*)&input[idx]);
+    if (vmaxvq_u8(chunk) < 0x80)
+    {
+      idx += 16;
+      continue;
+    }
+
+    idx = _json_validate_utf8_until((const unsigned char*)input, idx, idx + 16, len);
+    if (idx == SIZE_MAX)
+      return false;
+  }
+
+  return _json_validate_utf8_until((const unsigned char*)input, idx, len, len) != SIZE_MAX;
+}
+
+#endif
+
+bool
+_json_validate_utf8(
+  const char* const input,
+  const size_t len)
+{
+  // most strings are short enough that setting up a vector isn't worth it
+  if (len < 32)
+    return _json_validate_utf8_scalar(input, len);
+
+#if defined(JSON_HAS_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    return _json_validate_utf8_avx2(input, len);
+  if (__builtin_cpu_supports("sse2"))
+    return _json_validate_utf8_sse2(input, len);
+#elif defined(JSON_HAS_NEON_SIMD)
+  return _json_validate_utf8_neon(input, len);
+#endif
+  return _json_validate_utf8_scalar(input, len);
+}
@@ -0,0 +1,646 @@
+#include "json.h"
+#include "json_internal.h"
+#include "json_tape.h"
+
+static const bool _json_tape_true = true;
+static const bool _json_tape_false = false;
+
+static uint64_t
+_json_tape_word(
+  const char tag,
+  const uint64_t payload)
+{
+  return ((uint64_t)(unsigned char)tag << JSON_TAPE_TAG_SHIFT) | payload;
+}
+
+static char
+_json_tape_tag(
+  const uint64_t word)
+{
+  return (char)(word >> JSON_TAPE_TAG_SHIFT);
+}
+
+static bool
+_json_tape_append(
+  struct _json_tape_builder_t* const builder,
+  const uint64_t word)
+{
+  if (builder->len == builder->capacity)
+  {
+    size_t new_capacity = builder->capacity * 2;
+    void* alloc = realloc(builder->words, new_capacity * sizeof(*builder->words));
+    if (!alloc)
+      return false;
+    builder->words = alloc;
+    builder->capacity = new_capacity;
+  }
+
+  builder->words[builder->len++] = word;
+  return true;
+}
+
+static bool
+_json_tape_open(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  const size_t start,
+  void** container)
+{
+  (void)parse_info;
+  (void)start;
+  (void)container;
+  struct _json_tape_builder_t* const builder = ctx;
+
+  if (builder->stack_len > 0)
+    builder->stack[builder->stack_len - 1].n_items++;
+
+  if (builder->stack_len == builder->stack_capacity)
+  {
+    size_t new_capacity = builder->stack_capacity * 2;
+    void* alloc = realloc(builder->stack, new_capacity * sizeof(*builder->stack));
+    if (!alloc)
+      return false;
+    builder->stack = alloc;
+    builder->stack_capacity = new_capacity;
+  }
+
+  // the payload is filled in once it's closed
+  struct _json_tape_frame_t* frame = &builder->stack[builder->stack_len++];
+  frame->open = builder->len;
+  frame->n_items = 0;
+  return _json_tape_append(builder, _json_tape_word(type == JSON_OBJECT ? '{' : '[', 0));
+}
+
+static bool
+_json_tape_close(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start)
+{
+  (void)start;
+  struct _json_tape_builder_t* const builder = ctx;
+  const bool is_object = parse_info->stack[parse_info->stack_len - 1].type == JSON_OBJECT;
+
+  struct _json_tape_frame_t* frame = &builder->stack[--builder->stack_len];
+  builder->words[frame->open] |= builder->len;
+  return _json_tape_append(builder, _json_tape_word(is_object ? '}' : ']', frame->n_items));
+}
+
+static bool
+_json_tape_append_string(
+  struct _json_tape_builder_t* const builder,
+  const char tag,
+  const char* const str,
+  const size_t len)
+{
+  // keep the null terminator as part of the string
+  const size_t offset = builder->strings.len;
+  if (!_json_string_builder_append(&builder->strings, str, len))
+    return false;
+  builder->strings.len++;
+
+  return _json_tape_append(builder, _json_tape_word(tag, offset));
+}
+
+static bool
+_json_tape_key(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const size_t start,
+  const size_t len)
+{
+  return _json_tape_append_string(ctx, ':', &parse_info->json_string[start], len);
+}
+
+static bool
+_json_tape_value(
+  void* ctx,
+  struct _json_parse_info_t* const parse_info,
+  const enum json_type_e type,
+  union value* const value,
+  const size_t start,
+  const size_t len)
+{
+  struct _json_tape_builder_t* const builder = ctx;
+  builder->stack[builder->stack_len - 1].n_items++;
+
+  switch (type)
+  {
+    case JSON_STRING:
+      return _json_tape_append_string(builder, '\"', &parse_info->json_string[start], len);
+
+    case JSON_INT32:
+    case JSON_DECIMAL:
+    {
+      // the number is stored in the first bytes of the next word, so the
+      // getters can point straight at it
+      uint64_t payload = 0;
+      if (type == JSON_INT32)
+        memcpy(&payload, &value->int32, sizeof(value->int32));
+      else
+        memcpy(&payload, &value->decimal, sizeof(value->decimal));
+
+      return _json_tape_append(builder, _json_tape_word(type == JSON_INT32 ? 'i' : 'd', 0))
+        && _json_tape_append(builder, payload);
+    }
+
+    // 't', 'f' or 'n'
+    default:
+      return _json_tape_append(builder, _json_tape_word(parse_info->json_string[start], 0));
+  }
+}
+
+static const struct _json_token_handler_t _json_tape_handler = {
+  .open = _json_tape_open,
+  .close = _json_tape_close,
+  .key = _json_tape_key,
+  .value = _json_tape_value,
+  .defer_numbers = false
+};
+
+struct json_tape_t*
+json_tape_parse_from_buffer(
+  const char* const buffer,
+  const size_t len,
+  const uint32_t flags)
+{
+  struct json_tape_t* tape = NULL;
+
+  // roughly one word per 8 bytes of typical input, and strings are
+  // never longer than the input
+  struct _json_tape_builder_t builder = {
+    .words = malloc((len / 8 + 16) * sizeof(uint64_t)),
+    .len = 0,
+    .capacity = len / 8 + 16,
+    .strings = {0},
+    .stack = malloc(16 * sizeof(struct _json_tape_frame_t)),
+    .stack_len = 0,
+    .stack_capacity = 16
+  };
+  if (!builder.words
+      || !builder.stack
+      || !_json_string_builder_init(&builder.strings, len / 2 + 16))
+    goto cleanup;
+
+  struct _json_parse_info_t parse_info = {
+    .json_string = buffer,
+    .json_string_len = len,
+    .json_string_idx = 0,
+    .arena = NULL,
+    .flags = flags,
+    .key_pool = NULL,
+    .key_cache = {{0}},
+    .parsed_key = NULL,
+    .parsed_key_len = 0,
+    .parsing_key = false,
+    .previous_token = NONE,
+    .stack = NULL,
+    .stack_len = 0,
+    .stack_capacity = 0,
+    .structural_index = NULL
+  };
+
+  if (!_json_parse_tokens(&parse_info, &_json_tape_handler, &builder, OPEN_BODY | OPEN_ARRAY))
+    goto cleanup;
+
+  // the header, tape and strings all go in one block so the whole
+  // document is a single allocation
+  const size_t words_size = builder.len * sizeof(uint64_t);
+  tape = malloc(sizeof(struct json_tape_t) + words_size + builder.strings.len);
+  if (!tape)
+    goto cleanup;
+
+  uint64_t* words = (uint64_t*)(tape + 1);
+  char* strings = (char*)words + words_size;
+  memcpy(words, builder.words, words_size);
+  memcpy(strings, builder.strings.data, builder.strings.len);
+  tape->tape = words;
+  tape->tape_len = builder.len;
+  tape->strings = strings;
+  tape->strings_len = builder.strings.len;
+
+cleanup:
+  free(builder.words);
+  free(builder.stack);
+  _json_string_builder_free(&builder.strings);
+  return tape;
+}
+
+struct json_tape_t*
+json_tape_parse_from_string(
+  const char* const json_string,
+  const uint32_t flags)
+{
+  return json_tape_parse_from_buffer(json_string, strlen(json_string), flags);
+}
+
+struct json_tape_t*
+json_tape_parse_from_file(
+  const char* const filepath,
+  const uint32_t flags)
+{
+  struct _json_file_buffer_t file_buffer = {0};
+  if (!_json_load_file(filepath, &file_buffer))
+    return NULL;
+
+  struct json_tape_t* tape = json_tape_parse_from_buffer(file_buffer.contents, file_buffer.len, flags);
+  _json_release_file(&file_buffer);
+
+  return tape;
+}
+
+void
+json_tape_free(
+  struct json_tape_t** tape)
+{
+  free(*tape);
+  *tape = NULL;
+}
+
+// the index just past the value at idx
+static size_t
+_json_tape_skip(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  const uint64_t word = tape->tape[idx];
+  switch (_json_tape_tag(word))
+  {
+    case '{':
+    case '[':
+      return (word & JSON_TAPE_PAYLOAD_MASK) + 1;
+    case 'i':
+    case 'd':
+      return idx + 2;
+    default:
+      return idx + 1;
+  }
+}
+
+// index of the value under key in the object at object
+static size_t
+_json_tape_find(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  const uint64_t word = tape->tape[object];
+  if (_json_tape_tag(word) != '{')
+    return JSON_TAPE_NPOS;
+
+  const size_t close = word & JSON_TAPE_PAYLOAD_MASK;
+  size_t idx = object + 1;
+  while (idx < close)
+  {
+    const char* item_key = &tape->strings[tape->tape[idx] & JSON_TAPE_PAYLOAD_MASK];
+    if (strcmp(item_key, key) == 0)
+      return idx + 1;
+    idx = _json_tape_skip(tape, idx + 1);
+  }
+
+  return JSON_TAPE_NPOS;
+}
+
+// index of item idx of the array at array
+static size_t
+_json_tape_at(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  const uint64_t word = tape->tape[array];
+  if (_json_tape_tag(word) != '[')
+    return JSON_TAPE_NPOS;
+
+  const size_t close = word & JSON_TAPE_PAYLOAD_MASK;
+  if (idx >= (tape->tape[close] & JSON_TAPE_PAYLOAD_MASK))
+    return JSON_TAPE_NPOS;
+
+  size_t item = array + 1;
+  for (size_t i = 0; i < idx; ++i)
+    item = _json_tape_skip(tape, item);
+  return item;
+}
+
+static bool
+_json_tape_has_tag(
+  const struct json_tape_t* const tape,
+  const size_t idx,
+  const char tag)
+{
+  return idx != JSON_TAPE_NPOS && _json_tape_tag(tape->tape[idx]) == tag;
+}
+
+static const int32_t*
+_json_tape_int32(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (!_json_tape_has_tag(tape, idx, 'i'))
+    return NULL;
+  return (const int32_t*)&tape->tape[idx + 1];
+}
+
+static const double*
+_json_tape_decimal(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (!_json_tape_has_tag(tape, idx, 'd'))
+    return NULL;
+  return (const double*)&tape->tape[idx + 1];
+}
+
+static const char*
+_json_tape_string(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (!_json_tape_has_tag(tape, idx, '\"'))
+    return NULL;
+  return &tape->strings[tape->tape[idx] & JSON_TAPE_PAYLOAD_MASK];
+}
+
+static size_t
+_json_tape_container(
+  const struct json_tape_t* const tape,
+  const size_t idx,
+  const char tag)
+{
+  if (!_json_tape_has_tag(tape, idx, tag))
+    return JSON_TAPE_NPOS;
+  return idx;
+}
+
+static const bool*
+_json_tape_bool(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (_json_tape_has_tag(tape, idx, 't'))
+    return &_json_tape_true;
+  if (_json_tape_has_tag(tape, idx, 'f'))
+    return &_json_tape_false;
+  return NULL;
+}
+
+enum json_type_e
+json_tape_type(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (idx == JSON_TAPE_NPOS)
+    return JSON_NOTYPE;
+
+  switch (_json_tape_tag(tape->tape[idx]))
+  {
+    case '{':
+      return JSON_OBJECT;
+    case '[':
+      return JSON_ARRAY;
+    case '\"':
+      return JSON_STRING;
+    case 'i':
+      return JSON_INT32;
+    case 'd':
+      return JSON_DECIMAL;
+    case 't':
+    case 'f':
+      return JSON_BOOL;
+    case 'n':
+      return JSON_NULL;
+    default:
+      return JSON_NOTYPE;
+  }
+}
+
+size_t
+json_tape_len(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  const enum json_type_e type = json_tape_type(tape, idx);
+  if (type != JSON_OBJECT && type != JSON_ARRAY)
+    return 0;
+
+  const size_t close = tape->tape[idx] & JSON_TAPE_PAYLOAD_MASK;
+  return tape->tape[close] & JSON_TAPE_PAYLOAD_MASK;
+}
+
+// the value at idx, stepping over a key
+static size_t
+_json_tape_item(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  switch (_json_tape_tag(tape->tape[idx]))
+  {
+    case '}':
+    case ']':
+      return JSON_TAPE_NPOS;
+    case ':':
+      return idx + 1;
+    default:
+      return idx;
+  }
+}
+
+size_t
+json_tape_first(
+  const struct json_tape_t* const tape,
+  const size_t container)
+{
+  const enum json_type_e type = json_tape_type(tape, container);
+  if (type != JSON_OBJECT && type != JSON_ARRAY)
+    return JSON_TAPE_NPOS;
+
+  return _json_tape_item(tape, container + 1);
+}
+
+size_t
+json_tape_next(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (idx == JSON_TAPE_NPOS)
+    return JSON_TAPE_NPOS;
+
+  return _json_tape_item(tape, _json_tape_skip(tape, idx));
+}
+
+const char*
+json_tape_key(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  if (idx == JSON_TAPE_NPOS || idx == 0 || _json_tape_tag(tape->tape[idx - 1]) != ':')
+    return NULL;
+  return &tape->strings[tape->tape[idx - 1] & JSON_TAPE_PAYLOAD_MASK];
+}
+
+const int32_t*
+json_tape_as_int32(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  return _json_tape_int32(tape, idx);
+}
+
+const double*
+json_tape_as_decimal(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  return _json_tape_decimal(tape, idx);
+}
+
+const char*
+json_tape_as_string(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  return _json_tape_string(tape, idx);
+}
+
+const bool*
+json_tape_as_bool(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  return _json_tape_bool(tape, idx);
+}
+
+bool
+json_tape_is_null(
+  const struct json_tape_t* const tape,
+  const size_t idx)
+{
+  return _json_tape_has_tag(tape, idx, 'n');
+}
+
+const int32_t*
+json_tape_get_int32(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_int32(tape, _json_tape_find(tape, object, key));
+}
+
+const double*
+json_tape_get_decimal(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_decimal(tape, _json_tape_find(tape, object, key));
+}
+
+const char*
+json_tape_get_string(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_string(tape, _json_tape_find(tape, object, key));
+}
+
+size_t
+json_tape_get_object(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_container(tape, _json_tape_find(tape, object, key), '{');
+}
+
+size_t
+json_tape_get_array(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_container(tape, _json_tape_find(tape, object, key), '[');
+}
+
+const bool*
+json_tape_get_bool(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_bool(tape, _json_tape_find(tape, object, key));
+}
+
+bool
+json_tape_get_isnull(
+  const struct json_tape_t* const tape,
+  const size_t object,
+  const char* const key)
+{
+  return _json_tape_has_tag(tape, _json_tape_find(tape, object, key), 'n');
+}
+
+const int32_t*
+json_tape_array_get_int32(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_int32(tape, _json_tape_at(tape, array, idx));
+}
+
+const double*
+json_tape_array_get_decimal(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_decimal(tape, _json_tape_at(tape, array, idx));
+}
+
+const char*
+json_tape_array_get_string(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_string(tape, _json_tape_at(tape, array, idx));
+}
+
+size_t
+json_tape_array_get_object(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_container(tape, _json_tape_at(tape, array, idx), '{');
+}
+
+size_t
+json_tape_array_get_array(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_container(tape, _json_tape_at(tape, array, idx), '[');
+}
+
+const bool*
+json_tape_array_get_bool(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_bool(tape, _json_tape_at(tape, array, idx));
+}
+
+bool
+json_tape_array_get_isnull(
+  const struct json_tape_t* const tape,
+  const size_t array,
+  const size_t idx)
+{
+  return _json_tape_has_tag(tape, _json_tape_at(tape, array, idx), 'n');
+}
@@ -0,0 +1,226 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_internal.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_HAS_FD
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+bool
+json_buffer_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx)
+{
+  struct json_buffer_sink_t* buffer_sink = ctx;
+
+  // always leave room for the null terminator
+  if (buffer_sink->len + len >= buffer_sink->capacity)
+    return false;
+
+  memcpy(&buffer_sink->buffer[buffer_sink->len], data, len);
+  buffer_sink->len += len;
+  buffer_sink->buffer[buffer_sink->len] = '\0';
+  return true;
+}
+
+bool
+json_file_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx)
+{
+  return fwrite(data, sizeof(char), len, ctx) == len;
+}
+
+bool
+json_fd_sink(
+  const char* const data,
+  const size_t len,
+  void* ctx)
+{
+#ifdef JSON_HAS_FD
+  int fd = *(int*)ctx;
+  size_t written = 0;
+  while (written < len)
+  {
+    ssize_t result = write(fd, &data[written], len - written);
+    if (result == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    written += result;
+  }
+
+  return true;
+#else
+  (void)data;
+  (void)len;
+  (void)ctx;
+  return false;
+#endif
+}
+
+bool
+_json_writer_flush(
+  struct _json_writer_t* const writer)
+{
+  if (writer->len == 0)
+    return true;
+
+  bool success = writer->sink(writer->buffer, writer->len, writer->ctx);
+  writer->len = 0;
+  return success;
+}
+
+// small pieces are batched up in the writer's buffer so the sink isn't
+// called for every brace and comma, large ones go straight through
+bool
+_json_writer_write(
+  struct _json_writer_t* const writer,
+  const char* const data,
+  const size_t len)
+{
+  if (writer->builder)
+    return _json_string_builder_append(writer->builder, data, len);
+
+  if (writer->len + len <= JSON_WRITER_BUFFER_SIZE)
+  {
+    memcpy(&writer->buffer[writer->len], data, len);
+    writer->len += len;
+    return true;
+  }
+
+  if (!_json_writer_flush(writer))
+    return false;
+
+  if (len >= JSON_WRITER_BUFFER_SIZE)
+    return writer->sink(data, len, writer->ctx);
+
+  memcpy(writer->buffer, data, len);
+  writer->len = len;
+  return true;
+}
+
+bool
+_json_write_item_value(
+  struct _json_writer_t* const writer,
+  const struct json_item_t* const item)
+{
+  switch (item->type)
+  {
+    case JSON_INT32:
+    {
+      char formatted_buffer[JSON_NUMBER_BUFFER_SIZE];
+      size_t len = _json_format_int32(item->value.int32, formatted_buffer);
+      return _json_writer_write(writer, formatted_buffer, len);
+    }
+
+    case JSON_DECIMAL:
+    {
+      char formatted_buffer[JSON_NUMBER_BUFFER_SIZE];
+      size_t len = _json_format_decimal(item->value.decimal, formatted_buffer);
+      return _json_writer_write(writer, formatted_buffer, len);
+    }
+
+    case JSON_BOOL:
+      if (item->value.boolean)
+        return _json_writer_write(writer, "true", 4);
+      return _json_writer_write(writer, "false", 5);
+
+    case JSON_NULL:
+      return _json_writer_write(writer, "null", 4);
+
+    case JSON_STRING:
+      return _json_writer_write(writer, "\"", 1)
+        && _json_writer_write(writer, item->value.str, strlen(item->value.str))
+        && _json_writer_write(writer, "\"", 1);
+
+    case JSON_OBJECT:
+      return _json_write_container(writer, JSON_OBJECT, item->value.object);
+
+    case JSON_ARRAY:
+      return _json_write_container(writer, JSON_ARRAY, item->value.array);
+
+    case JSON_NOTYPE:
+      break;
+  }
+
+  return true;
+}
+
+// walks the document with an explicit stack rather than recursing, so
+// deeply nested documents can't blow up the C stack
+bool
+_json_write_container(
+  struct _json_writer_t* const writer,
+  const enum json_type_e type,
+  const void* const container)
+{
+  struct _json_walk_t walk;
+  _json_walk_init(&walk);
+
+  bool success = _json_walk_push(&walk, type, (void*)container)
+    && _json_writer_write(writer, type == JSON_OBJECT ? "{" : "[", 1);
+
+  while (success && walk.len > 0)
+  {
+    const struct _json_walk_frame_t* frame = &walk.frames[walk.len - 1];
+    const bool in_object = frame->type == JSON_OBJECT;
+
+    struct json_item_t item;
+    if (!_json_walk_next(&walk, &item))
+    {
+      success = _json_writer_write(writer, in_object ? "}" : "]", 1);
+      walk.len--;
+      continue;
+    }
+
+    // idx has already moved past this item
+    if (frame->idx > 1 && !_json_writer_write(writer, ",", 1))
+      break;
+
+    if (in_object
+        && (!_json_writer_write(writer, "\"", 1)
+          || !_json_writer_write(writer, item.key, item.key_len)
+          || !_json_writer_write(writer, "\":", 2)))
+      break;
+
+    if (item.type == JSON_OBJECT)
+      success = _json_walk_push(&walk, JSON_OBJECT, item.value.object)
+        && _json_writer_write(writer, "{", 1);
+    else if (item.type == JSON_ARRAY)
+      success = _json_walk_push(&walk, JSON_ARRAY, item.value.array)
+        && _json_writer_write(writer, "[", 1);
+    else
+      success = _json_write_item_value(writer, &item);
+  }
+
+  // anything still open means a write failed part way through
+  if (walk.len > 0)
+    success = false;
+
+  _json_walk_free(&walk);
+  return success;
+}
+
+bool
+json_write(
+  const struct json_t* const json,
+  json_sink_fn sink,
+  void* ctx)
+{
+  struct _json_writer_t writer = {
+    .sink = sink,
+    .ctx = ctx,
+    .builder = NULL,
+    .len = 0
+  };
+
+  return _json_write_container(&writer, JSON_OBJECT, json)
+    && _json_writer_flush(&writer);
+}
@@ -0,0 +1,99 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_arena.h"
+#include <stdio.h>
+
+int main()
+{
+  int status = -1;
+
+  // small chunks so documents span several of them
+  struct json_arena_t* arena = json_arena_create(256);
+  if (!arena)
+  {
+    fprintf(stderr, "Failed to create arena.\n");
+    return -1;
+  }
+
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+
+  char* json_string = "{ \"key\": 10, \"key2\": \"hey\", \"key3\": { \"a\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12] } }";
+  struct json_t* json = json_parse_with_options(json_string, strlen(json_string), &options);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse JSON into arena.\n");
+    goto cleanup;
+  }
+
+  if (*json_get_int32(json, "key") != 10 || strcmp(json_get_string(json, "key2"), "hey") != 0)
+  {
+    fprintf(stderr, "Incorrect values parsed into arena.\n");
+    goto cleanup;
+  }
+
+  struct json_array_t* array = json_get_array(json_get_object(json, "key3"), "a");
+  if (array->n_items != 12 || *json_array_get_int32(array, 11) != 12)
+  {
+    fprintf(stderr, "Incorrect array parsed into arena.\n");
+    goto cleanup;
+  }
+
+  // heap values given to an arena document are owned (and freed) by the arena
+  if (!json_set_string(json, "key2", strdup("replaced"))
+      || !json_add_object(json, "key4", json_parse_from_string("{ \"b\": 2 }"))
+      || !json_array_append_string(array, strdup("appended")))
+  {
+    fprintf(stderr, "Failed to modify arena document.\n");
+    goto cleanup;
+  }
+
+  if (strcmp(json_get_string(json, "key2"), "replaced") != 0
+      || *json_get_int32(json_get_object(json, "key4"), "b") != 2
+      || strcmp(json_array_get_string(array, 12), "appended") != 0)
+  {
+    fprintf(stderr, "Incorrect values after modifying arena document.\n");
+    goto cleanup;
+  }
+
+  // no-op, everything is released by the arena
+  json_free(&json);
+  if (json)
+  {
+    fprintf(stderr, "Expected json_free to clear the pointer.\n");
+    goto cleanup;
+  }
+
+  json_arena_reset(arena);
+
+  struct json_array_t* complex_array = json_parse_array_file_with_options("complex_file.json", &options);
+  if (!complex_array || complex_array->n_items != 1000)
+  {
+    fprintf(stderr, "Failed to parse complex_file.json into arena.\n");
+    goto cleanup;
+  }
+
+  char* section = json_get_string(json_array_get_object(complex_array, 0), "bit");
+  if (!section || strcmp(section, "dark") != 0)
+  {
+    fprintf(stderr, "Incorrect value parsed from complex_file.json.\n");
+    goto cleanup;
+  }
+
+  // failed parses leave the arena usable
+  const char* const bad_string = "{ \"key\": [1, 2 }";
+  struct json_t* bad_json = json_parse_with_options(bad_string, strlen(bad_string), &options);
+  if (bad_json)
+  {
+    fprintf(stderr, "Expected JSON to fail parsing but succeeded.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  json_arena_destroy(&arena);
+  return status;
+}
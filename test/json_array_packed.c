@@ -0,0 +1,149 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+// arrays holding only int32s, decimals or bools are packed into a plain
+// buffer of values, and are unpacked as soon as anything else is added
+int main()
+{
+  int status = -1;
+
+  struct json_array_t* ints = json_parse_array_from_string("[1, 2, 3, -4]");
+  struct json_array_t* decimals = json_parse_array_from_string("[1.5, -2.25, 3e2]");
+  struct json_array_t* bools = json_parse_array_from_string("[true, false, true]");
+  struct json_array_t* mixed = json_parse_array_from_string("[1, 2.5, \"three\"]");
+  struct json_array_t* numbers = json_parse_array_from_string("[1.5, 2, 3]");
+  struct json_array_t* empty = json_array_create();
+  struct json_arena_t* arena = json_arena_create(0);
+  char* array_string = NULL;
+  if (!ints || !decimals || !bools || !mixed || !numbers || !empty || !arena)
+  {
+    fprintf(stderr, "Failed to parse arrays.\n");
+    goto cleanup;
+  }
+
+  int32_t* int32s = NULL;
+  double* doubles = NULL;
+  bool* booleans = NULL;
+  size_t len = 0;
+
+  if (!json_array_as_int32_span(ints, &int32s, &len) || len != 4
+      || int32s[0] != 1 || int32s[3] != -4)
+  {
+    fprintf(stderr, "Expected an int32 span of [1, 2, 3, -4].\n");
+    goto cleanup;
+  }
+
+  if (!json_array_as_decimal_span(decimals, &doubles, &len) || len != 3
+      || doubles[1] != -2.25 || doubles[2] != 300.0)
+  {
+    fprintf(stderr, "Expected a decimal span of [1.5, -2.25, 300.0].\n");
+    goto cleanup;
+  }
+
+  if (!json_array_as_bool_span(bools, &booleans, &len) || len != 3 || booleans[1])
+  {
+    fprintf(stderr, "Expected a bool span of [true, false, true].\n");
+    goto cleanup;
+  }
+
+  if (json_array_as_decimal_span(ints, &doubles, &len) || doubles || len != 0
+      || json_array_as_int32_span(mixed, &int32s, &len))
+  {
+    fprintf(stderr, "Expected no span for arrays of other/mixed types.\n");
+    goto cleanup;
+  }
+
+  if (!json_array_as_int32_span(empty, &int32s, &len) || len != 0)
+  {
+    fprintf(stderr, "Expected an empty array to be an empty span.\n");
+    goto cleanup;
+  }
+
+  // getters and types look the same either way
+  if (json_array_get_type(ints, 2) != JSON_INT32 || *json_array_get_int32(ints, 2) != 3
+      || json_array_get_type(mixed, 1) != JSON_DECIMAL || *json_array_get_decimal(mixed, 1) != 2.5
+      || json_array_get_isnull(bools, 0))
+  {
+    fprintf(stderr, "Expected getters to read packed and unpacked arrays the same.\n");
+    goto cleanup;
+  }
+
+  // the same type is written in place, another one unpacks the array
+  json_array_set_int32(ints, 1, 20);
+  if (!json_array_as_int32_span(ints, &int32s, &len) || int32s[1] != 20)
+  {
+    fprintf(stderr, "Expected setting an int32 to keep the array packed.\n");
+    goto cleanup;
+  }
+
+  json_array_set_string(ints, 1, strdup("twenty"));
+  if (json_array_as_int32_span(ints, &int32s, &len)
+      || json_array_get_type(ints, 0) != JSON_INT32 || *json_array_get_int32(ints, 0) != 1
+      || strcmp(json_array_get_string(ints, 1), "twenty") != 0)
+  {
+    fprintf(stderr, "Expected setting a string to unpack the array.\n");
+    goto cleanup;
+  }
+
+  if (!json_array_append_null(decimals) || !json_array_get_isnull(decimals, 3)
+      || *json_array_get_decimal(decimals, 0) != 1.5)
+  {
+    fprintf(stderr, "Expected appending null to unpack the array.\n");
+    goto cleanup;
+  }
+
+  array_string = json_array_to_string(bools);
+  if (!array_string || strcmp(array_string, "[true,false,true]") != 0)
+  {
+    fprintf(stderr, "Expected packed array to be written as [true,false,true], got %s.\n", array_string);
+    goto cleanup;
+  }
+
+  // an int32 after decimals unpacks the array rather than being
+  // converted, so every number keeps its own type
+  if (json_array_as_decimal_span(numbers, &doubles, &len)
+      || json_array_get_type(numbers, 0) != JSON_DECIMAL || *json_array_get_decimal(numbers, 0) != 1.5
+      || json_array_get_type(numbers, 1) != JSON_INT32 || *json_array_get_int32(numbers, 1) != 2)
+  {
+    fprintf(stderr, "Expected [1.5, 2, 3] to be unpacked with its own types.\n");
+    goto cleanup;
+  }
+
+  free(array_string);
+  array_string = json_array_to_string(numbers);
+  if (!array_string || strcmp(array_string, "[1.5,2,3]") != 0)
+  {
+    fprintf(stderr, "Expected [1.5, 2, 3] to be written as [1.5,2,3], got %s.\n", array_string);
+    goto cleanup;
+  }
+
+  // nested arrays are packed on their own, including in an arena
+  const char* const nested_string = "[[1, 2], [3.5], [4, \"x\"]]";
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+  struct json_array_t* nested = json_parse_array_with_options(nested_string, strlen(nested_string), &options);
+  struct json_array_t* first = nested ? json_array_get_array(nested, 0) : NULL;
+  if (!first || !json_array_as_int32_span(first, &int32s, &len) || len != 2 || int32s[1] != 2
+      || !json_array_as_decimal_span(json_array_get_array(nested, 1), &doubles, &len)
+      || json_array_as_int32_span(json_array_get_array(nested, 2), &int32s, &len))
+  {
+    fprintf(stderr, "Expected nested arrays to be packed separately.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  free(array_string);
+  json_array_free(&ints);
+  json_array_free(&decimals);
+  json_array_free(&bools);
+  json_array_free(&mixed);
+  json_array_free(&numbers);
+  json_array_free(&empty);
+  json_arena_destroy(&arena);
+  return status;
+}
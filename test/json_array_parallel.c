@@ -0,0 +1,243 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+// builds "[" + n copies of element (with a comma between each) + tail
+static char*
+make_array(
+  const char* const element,
+  const size_t n,
+  const char* const tail,
+  size_t* len)
+{
+  const size_t element_len = strlen(element);
+  char* array = malloc(n * (element_len + 1) + strlen(tail) + 2);
+  if (!array)
+    return NULL;
+
+  size_t idx = 0;
+  array[idx++] = '[';
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i > 0)
+      array[idx++] = ',';
+    memcpy(&array[idx], element, element_len);
+    idx += element_len;
+  }
+  strcpy(&array[idx], tail);
+  *len = idx + strlen(tail);
+  return array;
+}
+
+// parses input both ways and checks they agree
+static bool
+matches_serial(
+  const char* const input,
+  const size_t len,
+  struct json_key_pool_t* const key_pool)
+{
+  struct json_array_t* serial = json_parse_array_from_buffer(input, len);
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = NULL,
+    .key_pool = key_pool
+  };
+  struct json_array_t* parallel = json_parse_array_parallel_from_buffer(input, len, &options, 4);
+  char* serial_string = serial ? json_array_to_string(serial) : NULL;
+  char* parallel_string = parallel ? json_array_to_string(parallel) : NULL;
+
+  bool matches = serial_string
+    && parallel_string
+    && strcmp(serial_string, parallel_string) == 0
+    && serial->packed_type == parallel->packed_type;
+
+  free(serial_string);
+  free(parallel_string);
+  if (serial)
+    json_array_free(&serial);
+  if (parallel)
+    json_array_free(&parallel);
+  return matches;
+}
+
+static bool
+fails(
+  const char* const element,
+  const size_t n,
+  const char* const tail)
+{
+  size_t len = 0;
+  char* input = make_array(element, n, tail, &len);
+  struct json_array_t* array = json_parse_array_parallel_from_buffer(input, len, NULL, 4);
+  bool failed = array == NULL;
+  if (array)
+    json_array_free(&array);
+  free(input);
+  return failed;
+}
+
+int main()
+{
+  int status = -1;
+  char* input = NULL;
+  size_t len = 0;
+  struct json_key_pool_t* key_pool = json_key_pool_create();
+  struct json_array_t* array = NULL;
+
+  // every kind of element, including brackets and commas in strings
+  const char* elements[] = {
+    "{\"id\": 1, \"name\": \"a, [b]\", \"tags\": [1, 2.5, \"}\"], \"nested\": {\"ok\": true}}",
+    " [1, [2, [3, {\"a\": null}]], \"x\\\"],\"] ",
+    "\"a string with \\\" an escaped quote, and a ] bracket\"",
+    "-12.5e3",
+    "2147483648",
+    "42",
+    "true",
+    "null",
+    "{}"
+  };
+  for (size_t i = 0; i < sizeof(elements) / sizeof(elements[0]); ++i)
+  {
+    input = make_array(elements[i], 20000, "]", &len);
+    if (!input || !matches_serial(input, len, NULL))
+    {
+      fprintf(stderr, "Parallel parse of '%s' elements didn't match.\n", elements[i]);
+      goto cleanup;
+    }
+    free(input);
+    input = NULL;
+  }
+
+  // a mix of types in one array, with whitespace around everything
+  input = make_array(" {\"k\": [1, 2]} , 3 ,\"s\", [true] , false\n", 5000, " ]\n\n", &len);
+  if (!input || !matches_serial(input, len, key_pool))
+  {
+    fprintf(stderr, "Parallel parse of mixed elements didn't match.\n");
+    goto cleanup;
+  }
+
+  // mixed decimals, int32s and bools aren't packed, and every value
+  // keeps its own type either way
+  const char* numbers[] = { "3017.86, 9080, false", "1.5, 2", "2, 1.5", "true, 1" };
+  for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i)
+  {
+    free(input);
+    input = make_array(numbers[i], 20000, "]", &len);
+    if (!input || !matches_serial(input, len, NULL))
+    {
+      fprintf(stderr, "Parallel parse of '%s' elements didn't match.\n", numbers[i]);
+      goto cleanup;
+    }
+  }
+
+  array = json_parse_array_parallel_from_buffer(input, len, NULL, 4);
+  if (!array
+      || array->packed_type != JSON_NOTYPE
+      || json_array_get_type(array, 1) != JSON_INT32
+      || *json_array_get_int32(array, 1) != 1)
+  {
+    fprintf(stderr, "Expected a mixed array to keep each value's type.\n");
+    goto cleanup;
+  }
+  json_array_free(&array);
+
+  // packed like the serial parser would
+  free(input);
+  input = make_array("7", 50000, "]", &len);
+  array = json_parse_array_parallel_from_buffer(input, len, NULL, 3);
+  int32_t* values = NULL;
+  size_t n_values = 0;
+  if (!array
+      || array->packed_type != JSON_INT32
+      || !json_array_as_int32_span(array, &values, &n_values)
+      || n_values != 50000
+      || values[49999] != 7)
+  {
+    fprintf(stderr, "Expected a packed int32 array.\n");
+    goto cleanup;
+  }
+  json_array_free(&array);
+
+  // an empty array, padded out so it isn't parsed serially
+  free(input);
+  input = malloc(100000);
+  if (!input)
+    goto cleanup;
+  memset(input, ' ', 100000);
+  input[10] = '[';
+  input[99990] = ']';
+  array = json_parse_array_parallel_from_buffer(input, 100000, NULL, 4);
+  if (!array || array->n_items != 0)
+  {
+    fprintf(stderr, "Expected an empty array.\n");
+    goto cleanup;
+  }
+  json_array_free(&array);
+
+  const char* valid = "{\"id\": 1, \"name\": \"x\"}";
+  if (!fails(valid, 10000, ",]")
+      || !fails(valid, 10000, ",,1]")
+      || !fails(valid, 10000, "] x")
+      || !fails(valid, 10000, "] []")
+      || !fails(valid, 10000, "")
+      || !fails(valid, 10000, "}")
+      || !fails(valid, 10000, ", {\"id\": }]")
+      || !fails(valid, 10000, ", {\"id\": 1]]")
+      || !fails(valid, 10000, ", 1 2]")
+      || !fails(valid, 10000, ", \"unterminated]")
+      || !fails(valid, 10000, ", tru]")
+      || !fails("{\"id\": 1 \"name\": 2}", 10000, "]"))
+  {
+    fprintf(stderr, "Expected invalid arrays to fail.\n");
+    goto cleanup;
+  }
+
+  // from a file, with the default number of threads
+  free(input);
+  input = make_array(elements[0], 10000, "]", &len);
+  FILE* file = fopen("json_array_parallel_test.json", "wb");
+  if (!input || !file || fwrite(input, 1, len, file) != len || fclose(file) != 0)
+  {
+    fprintf(stderr, "Failed to write json_array_parallel_test.json.\n");
+    goto cleanup;
+  }
+
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = NULL,
+    .key_pool = key_pool
+  };
+  array = json_parse_array_parallel_from_file("json_array_parallel_test.json", &options, 0);
+  if (!array
+      || array->n_items != 10000
+      || strcmp(json_get_string(json_array_get_object(array, 9999), "name"), "a, [b]") != 0)
+  {
+    fprintf(stderr, "Failed to parse json_array_parallel_test.json.\n");
+    goto cleanup;
+  }
+
+  // arenas aren't thread safe, so they can't be used
+  struct json_arena_t* arena = json_arena_create(0);
+  const struct json_parse_options_t arena_options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+  const bool refused = arena
+    && !json_parse_array_parallel_from_buffer(input, len, &arena_options, 4);
+  json_arena_destroy(&arena);
+  if (!refused)
+  {
+    fprintf(stderr, "Expected a parallel parse into an arena to fail.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  remove("json_array_parallel_test.json");
+  free(input);
+  if (array)
+    json_array_free(&array);
+  json_key_pool_destroy(&key_pool);
+  return status;
+}
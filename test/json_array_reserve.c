@@ -0,0 +1,105 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+#define N_ITEMS 1000000
+
+// once an array has reserved room, appending up to that many items
+// shouldn't move its storage
+int main()
+{
+  int status = -1;
+
+  struct json_array_t* array = json_array_create();
+  struct json_arena_t* arena = NULL;
+  if (!array)
+  {
+    fprintf(stderr, "Failed to create array.\n");
+    return -1;
+  }
+
+  if (!json_array_reserve(array, N_ITEMS) || array->item_capacity != N_ITEMS)
+  {
+    fprintf(stderr, "Failed to reserve %d items.\n", N_ITEMS);
+    goto cleanup;
+  }
+
+  // asking for less than it already has is a no-op
+  if (!json_array_reserve(array, 5) || array->item_capacity != N_ITEMS)
+  {
+    fprintf(stderr, "Expected reserving fewer items to keep the capacity.\n");
+    goto cleanup;
+  }
+
+  // the storage is allocated with the first item (and the array is
+  // packed since they're all int32s)
+  int32_t* values = NULL;
+  int32_t* first_values = NULL;
+  size_t len = 0;
+  for (int32_t i = 0; i < N_ITEMS; ++i)
+  {
+    if (!json_array_append_int32(array, i))
+    {
+      fprintf(stderr, "Failed to append item %d.\n", i);
+      goto cleanup;
+    }
+    if (i == 0)
+      json_array_as_int32_span(array, &first_values, &len);
+  }
+
+  if (!json_array_as_int32_span(array, &values, &len)
+      || values != first_values
+      || array->item_capacity != N_ITEMS
+      || array->n_items != N_ITEMS)
+  {
+    fprintf(stderr, "Expected appends within the reserved capacity to not reallocate.\n");
+    goto cleanup;
+  }
+
+  // and it still grows past what was reserved (the array takes
+  // ownership of the string)
+  if (!json_array_append_string(array, strdup("one more")) || array->item_capacity <= N_ITEMS)
+  {
+    fprintf(stderr, "Failed to append past the reserved capacity.\n");
+    goto cleanup;
+  }
+
+  for (int32_t i = 0; i < N_ITEMS; i += 1000)
+  {
+    int32_t* value = json_array_get_int32(array, i);
+    if (!value || *value != i)
+    {
+      fprintf(stderr, "Expected item %d to have value %d.\n", i, i);
+      goto cleanup;
+    }
+  }
+
+  if (strcmp(json_array_get_string(array, N_ITEMS), "one more") != 0)
+  {
+    fprintf(stderr, "Expected the last item to be 'one more'.\n");
+    goto cleanup;
+  }
+
+  arena = json_arena_create(0);
+  struct json_array_t* arena_array = json_array_create_arena(arena);
+  if (!arena_array)
+  {
+    fprintf(stderr, "Failed to create arena-backed array.\n");
+    goto cleanup;
+  }
+
+  if (!json_array_append_bool(arena_array, true)
+      || !json_array_reserve(arena_array, 1000)
+      || arena_array->item_capacity != 1000
+      || !*json_array_get_bool(arena_array, 0))
+  {
+    fprintf(stderr, "Expected reserving in an arena to keep existing items.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  json_array_free(&array);
+  json_arena_destroy(&arena);
+  return status;
+}
@@ -8,7 +8,7 @@ int main()
   int status = -1;
 
   // test both the to & from file functionality for arrays
-  char* array_string = "[1,3.141590,true,null,\"hello there\",{\"a\":1,\"b\":2},[1,2,3]]";
+  char* array_string = "[1,3.14159,true,null,\"hello there\",{\"a\":1,\"b\":2},[1,2,3]]";
   struct json_array_t* array = json_parse_array_from_string(array_string);
   struct json_array_t* array_read = NULL;
   char* new_array_string = NULL;
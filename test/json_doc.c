@@ -0,0 +1,230 @@
+#include "json_doc.h"
+#include <stdio.h>
+
+static bool
+key_equals(
+  const struct json_cursor_t* const cursor,
+  const char* const expected)
+{
+  const char* key = NULL;
+  size_t len = 0;
+  return json_cursor_key(cursor, &key, &len)
+    && len == strlen(expected)
+    && memcmp(key, expected, len) == 0;
+}
+
+int main()
+{
+  const char* const input =
+    "{\"id\": 42, \"price\": 9.5, \"name\": \"widget\", \"tags\": [\"a\", {\"b\": [1, 2]}, [], 3],"
+    " \"active\": true, \"deleted\": false, \"owner\": null, \"empty\": {},"
+    " \"a key that is much longer than fifty one characters, the tree's limit\": 7}";
+
+  struct json_doc_t* doc = json_doc_open(input, strlen(input), JSON_PARSE_DEFAULT);
+  if (!doc)
+  {
+    fprintf(stderr, "Failed to open document.\n");
+    return -1;
+  }
+
+  struct json_cursor_t root = json_doc_root(doc);
+  if (json_cursor_type(&root) != JSON_OBJECT || json_cursor_len(&root) != 9)
+  {
+    fprintf(stderr, "Wrong root type or length.\n");
+    return -1;
+  }
+
+  struct json_cursor_t value;
+  int32_t id = 0;
+  double price = 0.0;
+  if (!json_cursor_find(&root, "id", &value) || !json_cursor_get_int32(&value, &id) || id != 42
+      || !json_cursor_find(&root, "price", &value) || !json_cursor_get_decimal(&value, &price) || price != 9.5
+      || json_cursor_get_int32(&value, &id))
+  {
+    fprintf(stderr, "Failed to read numbers.\n");
+    return -1;
+  }
+
+  const char* name = NULL;
+  size_t name_len = 0;
+  if (!json_cursor_find(&root, "name", &value)
+      || !json_cursor_get_string(&value, &name, &name_len)
+      || name_len != 6 || memcmp(name, "widget", 6) != 0)
+  {
+    fprintf(stderr, "Failed to read string.\n");
+    return -1;
+  }
+  char* name_copy = json_cursor_dup_string(&value);
+  if (!name_copy || strcmp(name_copy, "widget") != 0)
+  {
+    fprintf(stderr, "Failed to copy string.\n");
+    return -1;
+  }
+  free(name_copy);
+
+  bool flag = false;
+  if (!json_cursor_find(&root, "active", &value) || !json_cursor_get_bool(&value, &flag) || !flag
+      || !json_cursor_find(&root, "deleted", &value) || !json_cursor_get_bool(&value, &flag) || flag
+      || !json_cursor_find(&root, "owner", &value) || !json_cursor_is_null(&value)
+      || json_cursor_find(&root, "missing", &value)
+      || json_cursor_find(&root, "i", &value))
+  {
+    fprintf(stderr, "Failed to read literals.\n");
+    return -1;
+  }
+
+  int32_t long_key_value = 0;
+  if (!json_cursor_find(&root, "a key that is much longer than fifty one characters, the tree's limit", &value)
+      || !json_cursor_get_int32(&value, &long_key_value) || long_key_value != 7)
+  {
+    fprintf(stderr, "Failed to find long key.\n");
+    return -1;
+  }
+
+  // nested containers are skipped over without visiting their items
+  struct json_cursor_t tags;
+  struct json_cursor_t element;
+  if (!json_cursor_find(&root, "tags", &tags)
+      || json_cursor_type(&tags) != JSON_ARRAY
+      || json_cursor_len(&tags) != 4
+      || !json_cursor_at(&tags, 3, &element)
+      || !json_cursor_get_int32(&element, &id) || id != 3
+      || json_cursor_at(&tags, 4, &element))
+  {
+    fprintf(stderr, "Failed to index array.\n");
+    return -1;
+  }
+
+  struct json_cursor_t inner;
+  if (!json_cursor_at(&tags, 1, &element)
+      || !json_cursor_find(&element, "b", &inner)
+      || !json_cursor_at(&inner, 1, &inner)
+      || !json_cursor_get_int32(&inner, &id) || id != 2)
+  {
+    fprintf(stderr, "Failed to read nested value.\n");
+    return -1;
+  }
+
+  if (!json_cursor_at(&tags, 2, &element)
+      || json_cursor_len(&element) != 0
+      || json_cursor_first(&element, &inner)
+      || !json_cursor_find(&root, "empty", &value)
+      || json_cursor_first(&value, &inner))
+  {
+    fprintf(stderr, "Empty containers have items.\n");
+    return -1;
+  }
+
+  // iterating visits every key in order
+  const char* const keys[] = { "id", "price", "name", "tags", "active", "deleted", "owner", "empty" };
+  struct json_cursor_t member;
+  size_t n_members = 0;
+  if (!json_cursor_first(&root, &member))
+    return -1;
+  do
+  {
+    if (n_members < 8 && !key_equals(&member, keys[n_members]))
+    {
+      fprintf(stderr, "Wrong key at %zu.\n", n_members);
+      return -1;
+    }
+    n_members++;
+  } while (json_cursor_next(&member));
+  if (n_members != 9)
+    return -1;
+
+  // only what's asked for is materialized
+  json_cursor_at(&tags, 1, &element);
+  struct json_t* object = json_cursor_get_object(&element, NULL);
+  struct json_array_t* array = NULL;
+  if (!object || !(array = json_get_array(object, "b")) || array->n_items != 2)
+  {
+    fprintf(stderr, "Failed to materialize object.\n");
+    return -1;
+  }
+  json_free(&object);
+
+  array = json_cursor_get_array(&tags, NULL);
+  if (!array || array->n_items != 4 || json_cursor_get_object(&tags, NULL))
+  {
+    fprintf(stderr, "Failed to materialize array.\n");
+    return -1;
+  }
+  json_array_free(&array);
+  json_doc_close(&doc);
+
+  // numbers are checked when they're read
+  const char* const bad_number = "[1, 2.3.4]";
+  doc = json_doc_open(bad_number, strlen(bad_number), JSON_PARSE_DEFAULT);
+  if (!doc)
+  {
+    fprintf(stderr, "Failed to open document with an invalid number.\n");
+    return -1;
+  }
+
+  root = json_doc_root(doc);
+  double decimal = 0.0;
+  if (!json_cursor_at(&root, 1, &element)
+      || json_cursor_type(&element) != JSON_NOTYPE
+      || json_cursor_get_decimal(&element, &decimal))
+  {
+    fprintf(stderr, "Read an invalid number.\n");
+    return -1;
+  }
+  json_doc_close(&doc);
+
+  // but the structure is checked up front
+  const char* const invalid[] = {
+    "", "{", "[1, 2", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "{\"a\": tru}",
+    "[1] [2]", "{\"a\": [1}", "{\"a\": \"unterminated}", "1", "\"str\"", "[1]x",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+  {
+    doc = json_doc_open(invalid[i], strlen(invalid[i]), JSON_PARSE_DEFAULT);
+    if (doc)
+    {
+      fprintf(stderr, "Opened invalid document %s.\n", invalid[i]);
+      return -1;
+    }
+  }
+
+  const char* const invalid_utf8 = "{\"a\": \"\xC3\"}";
+  doc = json_doc_open(invalid_utf8, strlen(invalid_utf8), JSON_PARSE_VALIDATE_UTF8);
+  if (doc)
+  {
+    fprintf(stderr, "Opened document with invalid UTF-8.\n");
+    return -1;
+  }
+
+  // large enough to go through the structural index
+  doc = json_doc_open_file("complex_file.json", JSON_PARSE_DEFAULT);
+  struct json_array_t* expected = json_parse_array_from_file("complex_file.json");
+  if (!doc || !expected)
+  {
+    fprintf(stderr, "Failed to open complex_file.json.\n");
+    return -1;
+  }
+
+  root = json_doc_root(doc);
+  if (json_cursor_len(&root) != expected->n_items)
+  {
+    fprintf(stderr, "Expected %zu items in complex_file.json.\n", expected->n_items);
+    return -1;
+  }
+
+  struct json_cursor_t section;
+  bool section_value = false;
+  if (!json_cursor_at(&root, 0, &element)
+      || !json_cursor_find(&element, "section", &section)
+      || !json_cursor_get_bool(&section, &section_value)
+      || section_value != *json_get_bool(expected->items[0].value.object, "section"))
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    return -1;
+  }
+
+  json_array_free(&expected);
+  json_doc_close(&doc);
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include "json.h"
+#include "json_array.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define N_THREADS 4
+#define N_KEYS 40
+
+struct thread_args_t
+{
+  struct json_key_pool_t* pool;
+  const char* json_string;
+  struct json_t* parsed;
+};
+
+static void*
+parse_with_pool(
+  void* arg)
+{
+  struct thread_args_t* args = arg;
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = NULL,
+    .key_pool = args->pool
+  };
+  args->parsed = json_parse_with_options(args->json_string, strlen(args->json_string), &options);
+  return NULL;
+}
+
+// documents parsed into the same pool share one copy of each key,
+// including when they're parsed on different threads
+int main()
+{
+  int status = -1;
+
+  struct json_key_pool_t* pool = json_key_pool_create();
+  struct json_arena_t* arena = json_arena_create(0);
+  struct json_t* first = NULL;
+  struct json_t* second = NULL;
+  struct json_array_t* array = NULL;
+  struct json_t* threaded[N_THREADS] = {0};
+  char* json_string = NULL;
+  if (!pool || !arena)
+  {
+    fprintf(stderr, "Failed to create key pool.\n");
+    goto cleanup;
+  }
+
+  struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = NULL,
+    .key_pool = pool
+  };
+  const char* const first_string = "{\"id\": 1, \"name\": \"a\", \"nested\": {\"id\": 2}}";
+  first = json_parse_with_options(first_string, strlen(first_string), &options);
+
+  options.arena = arena;
+  const char* const second_string = "{\"name\": \"b\", \"id\": 3}";
+  second = json_parse_with_options(second_string, strlen(second_string), &options);
+  options.arena = NULL;
+  if (!first || !second)
+  {
+    fprintf(stderr, "Failed to parse with key pool.\n");
+    goto cleanup;
+  }
+
+  if (json_key_pool_size(pool) != 3)
+  {
+    fprintf(stderr, "Expected 3 keys in the pool, got %zu.\n", json_key_pool_size(pool));
+    goto cleanup;
+  }
+
+  struct json_t* nested = json_get_object(first, "nested");
+  if (first->items[0].key != second->items[1].key
+      || first->items[1].key != second->items[0].key
+      || !nested || nested->items[0].key != first->items[0].key)
+  {
+    fprintf(stderr, "Expected the same key in every object to be one pointer.\n");
+    goto cleanup;
+  }
+
+  if (*json_get_int32(first, "id") != 1 || *json_get_int32(second, "id") != 3
+      || json_get(first, "missing") || json_key_pool_size(pool) != 3)
+  {
+    fprintf(stderr, "Expected lookups to work (and not add keys to the pool).\n");
+    goto cleanup;
+  }
+
+  // adding to a pooled object interns the new key, and duplicates are
+  // still rejected
+  if (!json_add_bool(second, "flag", true) || json_add_int32(second, "id", 4)
+      || json_key_pool_size(pool) != 4 || !*json_get_bool(second, "flag"))
+  {
+    fprintf(stderr, "Expected adding to a pooled object to intern the key.\n");
+    goto cleanup;
+  }
+
+  // arrays of objects, which is where the savings come from
+  const char* const array_string = "[{\"id\": 5, \"flag\": false}, {\"id\": 6}]";
+  array = json_parse_array_with_options(array_string, strlen(array_string), &options);
+  if (!array || json_array_get_object(array, 1)->items[0].key != first->items[0].key
+      || json_key_pool_size(pool) != 4)
+  {
+    fprintf(stderr, "Expected objects in a parsed array to use the pool.\n");
+    goto cleanup;
+  }
+
+  // large enough for the hash index
+  struct json_t* large = json_create();
+  char key[32] = {0};
+  for (int32_t i = 0; i < N_KEYS; ++i)
+  {
+    snprintf(key, 32, "key%d", i);
+    json_add_int32(large, key, i);
+  }
+  json_string = json_to_string(large);
+  json_free(&large);
+  if (!json_string)
+  {
+    fprintf(stderr, "Failed to write JSON to string.\n");
+    goto cleanup;
+  }
+
+  pthread_t threads[N_THREADS];
+  struct thread_args_t args[N_THREADS];
+  for (size_t i = 0; i < N_THREADS; ++i)
+  {
+    args[i].pool = pool;
+    args[i].json_string = json_string;
+    args[i].parsed = NULL;
+    pthread_create(&threads[i], NULL, parse_with_pool, &args[i]);
+  }
+  for (size_t i = 0; i < N_THREADS; ++i)
+  {
+    pthread_join(threads[i], NULL);
+    threaded[i] = args[i].parsed;
+  }
+
+  for (size_t i = 0; i < N_THREADS; ++i)
+  {
+    if (!threaded[i] || threaded[i]->n_items != N_KEYS
+        || threaded[i]->items[7].key != threaded[0]->items[7].key
+        || *json_get_int32(threaded[i], "key39") != 39)
+    {
+      fprintf(stderr, "Expected every thread to get the same interned keys.\n");
+      goto cleanup;
+    }
+  }
+
+  if (json_key_pool_size(pool) != 4 + N_KEYS)
+  {
+    fprintf(stderr, "Expected %d keys in the pool, got %zu.\n", 4 + N_KEYS, json_key_pool_size(pool));
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  free(json_string);
+  json_free(&first);
+  json_free(&second);
+  json_array_free(&array);
+  for (size_t i = 0; i < N_THREADS; ++i)
+    json_free(&threaded[i]);
+  json_arena_destroy(&arena);
+  json_key_pool_destroy(&pool);
+  return status;
+}
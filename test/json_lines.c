@@ -0,0 +1,158 @@
+#include "json.h"
+#include "json_lines.h"
+#include <stdio.h>
+
+int main()
+{
+  int status = -1;
+  struct json_lines_reader_t* reader = NULL;
+  struct json_lines_writer_t* writer = NULL;
+  char* expected = NULL;
+  char* actual = NULL;
+
+  // blank lines, a "\r\n" ending and no newline after the last record
+  const char* input =
+    "{\"id\": 1, \"name\": \"a\"}\n"
+    "\n"
+    "   \n"
+    "{\"id\": 2, \"name\": \"b\", \"tags\": [1, 2]}\r\n"
+    "{\"id\": 3, \"name\": \"c\"}";
+
+  reader = json_lines_reader_open(input, strlen(input), JSON_PARSE_DEFAULT);
+  if (!reader)
+  {
+    fprintf(stderr, "Failed to open reader.\n");
+    goto cleanup;
+  }
+
+  const size_t expected_lines[] = { 1, 4, 5 };
+  const char* const expected_names[] = { "a", "b", "c" };
+  struct json_t* record = NULL;
+  size_t n_records = 0;
+  while ((record = json_lines_reader_next(reader)) != NULL)
+  {
+    if (n_records == 3)
+    {
+      fprintf(stderr, "Expected only 3 records.\n");
+      goto cleanup;
+    }
+
+    if (*json_get_int32(record, "id") != (int32_t)n_records + 1
+        || strcmp(json_get_string(record, "name"), expected_names[n_records]) != 0
+        || json_lines_reader_line(reader) != expected_lines[n_records])
+    {
+      fprintf(stderr, "Incorrect record %zu.\n", n_records);
+      goto cleanup;
+    }
+    n_records++;
+  }
+
+  if (n_records != 3 || json_lines_reader_failed(reader))
+  {
+    fprintf(stderr, "Expected 3 records but got %zu.\n", n_records);
+    goto cleanup;
+  }
+  json_lines_reader_close(&reader);
+
+  // an invalid line stops the reader and reports where it was
+  const char* invalid = "{\"id\": 1}\n{\"id\": }\n{\"id\": 3}\n";
+  reader = json_lines_reader_open(invalid, strlen(invalid), JSON_PARSE_DEFAULT);
+  if (!reader
+      || !json_lines_reader_next(reader)
+      || json_lines_reader_next(reader)
+      || !json_lines_reader_failed(reader)
+      || json_lines_reader_line(reader) != 2
+      || json_lines_reader_next(reader))
+  {
+    fprintf(stderr, "Expected the reader to fail on line 2.\n");
+    goto cleanup;
+  }
+  json_lines_reader_close(&reader);
+
+  // a record can't span lines
+  const char* split = "{\"id\":\n1}\n";
+  reader = json_lines_reader_open(split, strlen(split), JSON_PARSE_DEFAULT);
+  if (!reader || json_lines_reader_next(reader) || !json_lines_reader_failed(reader))
+  {
+    fprintf(stderr, "Expected a record split over lines to fail.\n");
+    goto cleanup;
+  }
+  json_lines_reader_close(&reader);
+
+  // what's written reads back the same
+  writer = json_lines_writer_open("json_lines_test.jsonl");
+  reader = json_lines_reader_open(input, strlen(input), JSON_PARSE_DEFAULT);
+  if (!writer || !reader)
+  {
+    fprintf(stderr, "Failed to open writer.\n");
+    goto cleanup;
+  }
+  while ((record = json_lines_reader_next(reader)) != NULL)
+  {
+    if (!json_lines_writer_write(writer, record))
+    {
+      fprintf(stderr, "Failed to write record.\n");
+      goto cleanup;
+    }
+  }
+  json_lines_reader_close(&reader);
+  if (!json_lines_writer_close(&writer))
+  {
+    fprintf(stderr, "Failed to close writer.\n");
+    goto cleanup;
+  }
+
+  reader = json_lines_reader_open_file("json_lines_test.jsonl", JSON_PARSE_DEFAULT);
+  if (!reader)
+  {
+    fprintf(stderr, "Failed to open json_lines_test.jsonl.\n");
+    goto cleanup;
+  }
+
+  // the second record as json_to_string formats it
+  struct json_t* original = json_parse_from_string("{\"id\": 2, \"name\": \"b\", \"tags\": [1, 2]}");
+  expected = json_to_string(original);
+  json_free(&original);
+
+  json_lines_reader_next(reader);
+  record = json_lines_reader_next(reader);
+  actual = record ? json_to_string(record) : NULL;
+  if (!expected || !actual || strcmp(expected, actual) != 0 || json_lines_reader_line(reader) != 2)
+  {
+    fprintf(stderr, "Expected '%s' but read back '%s'.\n", expected, actual);
+    goto cleanup;
+  }
+  json_lines_reader_close(&reader);
+
+  // into a fixed buffer, which reports running out of space
+  char buffer[32];
+  struct json_buffer_sink_t sink = { .buffer = buffer, .capacity = sizeof(buffer), .len = 0 };
+  writer = json_lines_writer_open_sink(json_buffer_sink, &sink);
+  original = json_parse_from_string("{\"a\": 1}");
+  if (!writer
+      || !json_lines_writer_write(writer, original)
+      || !json_lines_writer_write(writer, original)
+      || strcmp(buffer, "{\"a\":1}\n{\"a\":1}\n") != 0)
+  {
+    fprintf(stderr, "Expected two lines in the buffer but got '%s'.\n", buffer);
+    json_free(&original);
+    goto cleanup;
+  }
+  while (json_lines_writer_write(writer, original))
+    ;
+  json_free(&original);
+  if (json_lines_writer_close(&writer))
+  {
+    fprintf(stderr, "Expected the writer to report a full buffer.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  remove("json_lines_test.jsonl");
+  json_lines_reader_close(&reader);
+  json_lines_writer_close(&writer);
+  free(expected);
+  free(actual);
+  return status;
+}
@@ -0,0 +1,213 @@
+#include "json.h"
+#include "json_lines.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define N_RECORDS 10000
+
+struct delivered
+{
+  pthread_mutex_t lock;
+  size_t n_records;
+  int64_t id_sum;
+  // ordered mode only
+  bool in_order;
+  int32_t last_id;
+  // stop after this many records, 0 to never stop
+  size_t stop_after;
+};
+
+static bool
+on_record(
+  struct json_t* record,
+  const size_t offset,
+  void* ctx)
+{
+  (void)offset;
+  struct delivered* delivered = ctx;
+  const int32_t* id = json_get_int32(record, "id");
+
+  pthread_mutex_lock(&delivered->lock);
+  delivered->n_records++;
+  delivered->id_sum += id ? *id : 0;
+  if (!id || *id != delivered->last_id + 1)
+    delivered->in_order = false;
+  delivered->last_id = id ? *id : -1;
+  bool keep_going = delivered->stop_after == 0 || delivered->n_records < delivered->stop_after;
+  pthread_mutex_unlock(&delivered->lock);
+
+  return keep_going;
+}
+
+static void
+reset(
+  struct delivered* const delivered)
+{
+  delivered->n_records = 0;
+  delivered->id_sum = 0;
+  delivered->in_order = true;
+  delivered->last_id = -1;
+  delivered->stop_after = 0;
+}
+
+// N_RECORDS records with ids 0, 1, 2, ... and the line with id
+// invalid_id (if it's below N_RECORDS) broken
+static char*
+make_lines(
+  const int32_t invalid_id,
+  size_t* len,
+  size_t* invalid_offset)
+{
+  char* lines = malloc(N_RECORDS * 64);
+  if (!lines)
+    return NULL;
+
+  *len = 0;
+  for (int32_t i = 0; i < N_RECORDS; ++i)
+  {
+    if (i == invalid_id)
+      *invalid_offset = *len;
+    // some blank lines and "\r\n" endings along the way
+    const char* format = i == invalid_id ? "{\"id\": %d,}\n"
+      : i % 7 == 0 ? "{\"id\": %d, \"name\": \"record\"}\r\n\n"
+      : "{\"id\": %d, \"tags\": [1, 2, 3]}\n";
+    *len += sprintf(&lines[*len], format, i);
+  }
+  return lines;
+}
+
+int main()
+{
+  int status = -1;
+  struct delivered delivered;
+  pthread_mutex_init(&delivered.lock, NULL);
+  const int64_t expected_sum = (int64_t)N_RECORDS * (N_RECORDS - 1) / 2;
+
+  size_t len = 0;
+  size_t invalid_len = 0;
+  size_t invalid_offset = 0;
+  char* lines = make_lines(N_RECORDS, &len, &invalid_offset);
+  char* invalid_lines = make_lines(N_RECORDS / 2, &invalid_len, &invalid_offset);
+  if (!lines || !invalid_lines)
+  {
+    fprintf(stderr, "Failed to set up lines.\n");
+    goto cleanup;
+  }
+
+  // small chunks so every thread gets plenty of them
+  struct json_lines_parallel_options_t options = {
+    .n_threads = 4,
+    .chunk_size = 256,
+    .ordered = true,
+    .flags = JSON_PARSE_DEFAULT
+  };
+
+  reset(&delivered);
+  size_t error_offset = 0;
+  if (!json_lines_parse_parallel(lines, len, &options, on_record, &delivered, &error_offset)
+      || delivered.n_records != N_RECORDS
+      || !delivered.in_order
+      || error_offset != SIZE_MAX)
+  {
+    fprintf(stderr, "Expected %d records in order but got %zu.\n", N_RECORDS, delivered.n_records);
+    goto cleanup;
+  }
+
+  options.ordered = false;
+  reset(&delivered);
+  if (!json_lines_parse_parallel(lines, len, &options, on_record, &delivered, NULL)
+      || delivered.n_records != N_RECORDS
+      || delivered.id_sum != expected_sum)
+  {
+    fprintf(stderr, "Expected %d records but got %zu.\n", N_RECORDS, delivered.n_records);
+    goto cleanup;
+  }
+
+  // the defaults, and a single thread
+  reset(&delivered);
+  if (!json_lines_parse_parallel(lines, len, NULL, on_record, &delivered, NULL)
+      || delivered.n_records != N_RECORDS
+      || delivered.id_sum != expected_sum)
+  {
+    fprintf(stderr, "Expected %d records with the defaults but got %zu.\n", N_RECORDS, delivered.n_records);
+    goto cleanup;
+  }
+
+  options.n_threads = 1;
+  options.ordered = true;
+  reset(&delivered);
+  if (!json_lines_parse_parallel(lines, len, &options, on_record, &delivered, NULL)
+      || delivered.n_records != N_RECORDS
+      || !delivered.in_order)
+  {
+    fprintf(stderr, "Expected %d records on one thread but got %zu.\n", N_RECORDS, delivered.n_records);
+    goto cleanup;
+  }
+  options.n_threads = 4;
+
+  // in order, everything before an invalid line is delivered and
+  // nothing after it
+  reset(&delivered);
+  if (json_lines_parse_parallel(invalid_lines, invalid_len, &options, on_record, &delivered, &error_offset)
+      || error_offset != invalid_offset
+      || delivered.n_records != N_RECORDS / 2
+      || !delivered.in_order)
+  {
+    fprintf(stderr, "Expected to stop at offset %zu after %d records but stopped at %zu after %zu.\n",
+      invalid_offset, N_RECORDS / 2, error_offset, delivered.n_records);
+    goto cleanup;
+  }
+
+  options.ordered = false;
+  reset(&delivered);
+  if (json_lines_parse_parallel(invalid_lines, invalid_len, &options, on_record, &delivered, &error_offset)
+      || error_offset != invalid_offset)
+  {
+    fprintf(stderr, "Expected the unordered parse to fail at offset %zu.\n", invalid_offset);
+    goto cleanup;
+  }
+
+  // the callback can stop it
+  options.ordered = true;
+  reset(&delivered);
+  delivered.stop_after = 100;
+  if (json_lines_parse_parallel(lines, len, &options, on_record, &delivered, &error_offset)
+      || delivered.n_records != 100
+      || error_offset != SIZE_MAX)
+  {
+    fprintf(stderr, "Expected the callback to stop after 100 records but got %zu.\n", delivered.n_records);
+    goto cleanup;
+  }
+
+  reset(&delivered);
+  if (!json_lines_parse_parallel("", 0, &options, on_record, &delivered, NULL)
+      || delivered.n_records != 0)
+  {
+    fprintf(stderr, "Expected no records from empty input.\n");
+    goto cleanup;
+  }
+
+  FILE* file = fopen("json_lines_parallel_test.jsonl", "wb");
+  if (!file || fwrite(lines, 1, len, file) != len || fclose(file) != 0)
+  {
+    fprintf(stderr, "Failed to write json_lines_parallel_test.jsonl.\n");
+    goto cleanup;
+  }
+
+  reset(&delivered);
+  if (!json_lines_parse_parallel_file("json_lines_parallel_test.jsonl", &options, on_record, &delivered, NULL)
+      || delivered.n_records != N_RECORDS
+      || !delivered.in_order)
+  {
+    fprintf(stderr, "Expected %d records from the file but got %zu.\n", N_RECORDS, delivered.n_records);
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  remove("json_lines_parallel_test.jsonl");
+  free(lines);
+  free(invalid_lines);
+  pthread_mutex_destroy(&delivered.lock);
+  return status;
+}
@@ -0,0 +1,132 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+#define KEY_LEN 300
+
+// keys aren't capped at any length anymore, so two long keys that only
+// differ near the end have to stay separate keys through every path
+int main()
+{
+  int status = -1;
+
+  struct json_t* json = json_create();
+  struct json_t* parsed = NULL;
+  struct json_arena_t* arena = NULL;
+  char* json_string = NULL;
+  if (!json)
+  {
+    fprintf(stderr, "Failed to create JSON.\n");
+    return -1;
+  }
+
+  if (sizeof(void*) == 8 && sizeof(struct json_item_t) > 24)
+  {
+    fprintf(stderr, "Expected items to be at most 24 bytes, got %zu.\n", sizeof(struct json_item_t));
+    goto cleanup;
+  }
+
+  char key_a[KEY_LEN + 1];
+  char key_b[KEY_LEN + 1];
+  memset(key_a, 'k', KEY_LEN);
+  memset(key_b, 'k', KEY_LEN);
+  key_a[KEY_LEN] = '\0';
+  key_b[KEY_LEN] = '\0';
+  key_b[KEY_LEN - 1] = 'b';
+
+  if (!json_add_int32(json, key_a, 1) || !json_add_string(json, key_b, "two"))
+  {
+    fprintf(stderr, "Failed to add long keys.\n");
+    goto cleanup;
+  }
+
+  if (json_add_int32(json, key_a, 3))
+  {
+    fprintf(stderr, "Expected duplicate long key to be rejected.\n");
+    goto cleanup;
+  }
+
+  if (json->items[0].key_len != KEY_LEN || strcmp(json->items[0].key, key_a) != 0)
+  {
+    fprintf(stderr, "Expected the first item to keep its whole key.\n");
+    goto cleanup;
+  }
+
+  // enough keys to fill several key chunks
+  char key[32] = {0};
+  for (int32_t i = 0; i < 1000; ++i)
+  {
+    snprintf(key, 32, "key%d", i);
+    if (!json_add_int32(json, key, i))
+    {
+      fprintf(stderr, "Failed to add '%s'.\n", key);
+      goto cleanup;
+    }
+  }
+
+  json_string = json_to_string(json);
+  if (!json_string)
+  {
+    fprintf(stderr, "Failed to write JSON to string.\n");
+    goto cleanup;
+  }
+
+  arena = json_arena_create(0);
+  if (!arena)
+  {
+    fprintf(stderr, "Failed to create arena.\n");
+    goto cleanup;
+  }
+
+  // once on the heap and once in an arena
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_DEFAULT,
+    .arena = arena,
+    .key_pool = NULL
+  };
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    parsed = pass == 0
+      ? json_parse_from_string(json_string)
+      : json_parse_with_options(json_string, strlen(json_string), &options);
+    if (!parsed || parsed->n_items != 1002)
+    {
+      fprintf(stderr, "Failed to parse JSON with long keys.\n");
+      goto cleanup;
+    }
+
+    int32_t* a = json_get_int32(parsed, key_a);
+    char* b = json_get_string(parsed, key_b);
+    if (!a || *a != 1 || !b || strcmp(b, "two") != 0)
+    {
+      fprintf(stderr, "Expected long keys to be found after parsing.\n");
+      goto cleanup;
+    }
+
+    if (*json_get_int32(parsed, "key999") != 999)
+    {
+      fprintf(stderr, "Expected 'key999' to have value 999.\n");
+      goto cleanup;
+    }
+
+    json_free(&parsed);
+  }
+
+  // items in arrays don't have keys
+  struct json_array_t* array = json_parse_array_from_string("[1, {\"a\": 2}]");
+  if (!array || array->items[0].key != NULL || array->items[0].key_len != 0)
+  {
+    fprintf(stderr, "Expected array items to have no key.\n");
+    json_array_free(&array);
+    goto cleanup;
+  }
+  json_array_free(&array);
+
+  status = 0;
+cleanup:
+  free(json_string);
+  json_free(&json);
+  json_free(&parsed);
+  json_arena_destroy(&arena);
+  return status;
+}
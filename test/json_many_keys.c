@@ -0,0 +1,88 @@
+#include "json.h"
+#include <stdio.h>
+
+#define N_KEYS 10000
+
+// large objects switch over to a hash index for key lookups,
+// so make sure everything still behaves the same once they do
+int main()
+{
+  int status = -1;
+
+  struct json_t* json = json_create();
+  struct json_t* parsed = NULL;
+  char* json_string = NULL;
+  if (!json)
+  {
+    fprintf(stderr, "Failed to create JSON.\n");
+    return -1;
+  }
+
+  char key[32] = {0};
+  for (int32_t i = 0; i < N_KEYS; ++i)
+  {
+    snprintf(key, 32, "key%d", i);
+    if (!json_add_int32(json, key, i))
+    {
+      fprintf(stderr, "Failed to add '%s'.\n", key);
+      goto cleanup;
+    }
+  }
+
+  for (int32_t i = 0; i < N_KEYS; ++i)
+  {
+    snprintf(key, 32, "key%d", i);
+    int32_t* value = json_get_int32(json, key);
+    if (!value || *value != i)
+    {
+      fprintf(stderr, "Expected '%s' to have value %d.\n", key, i);
+      goto cleanup;
+    }
+  }
+
+  if (json_add_int32(json, "key5000", 0))
+  {
+    fprintf(stderr, "Expected duplicate key to be rejected.\n");
+    goto cleanup;
+  }
+
+  if (json_get(json, "missing") || json_get(json, "key10000"))
+  {
+    fprintf(stderr, "Expected missing keys to not be found.\n");
+    goto cleanup;
+  }
+
+  if (!json_set_decimal(json, "key1234", 1.5) || *json_get_decimal(json, "key1234") != 1.5)
+  {
+    fprintf(stderr, "Failed to set 'key1234'.\n");
+    goto cleanup;
+  }
+
+  // same thing but going through the parser
+  json_string = json_to_string(json);
+  if (!json_string)
+  {
+    fprintf(stderr, "Failed to write JSON to string.\n");
+    goto cleanup;
+  }
+
+  parsed = json_parse_from_string(json_string);
+  if (!parsed || parsed->n_items != N_KEYS)
+  {
+    fprintf(stderr, "Failed to parse JSON with %d keys.\n", N_KEYS);
+    goto cleanup;
+  }
+
+  if (*json_get_int32(parsed, "key9999") != 9999)
+  {
+    fprintf(stderr, "Expected 'key9999' to have value 9999.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  free(json_string);
+  json_free(&json);
+  json_free(&parsed);
+  return status;
+}
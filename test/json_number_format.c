@@ -0,0 +1,130 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+// checks the exact text written for a single decimal value
+static bool
+check_decimal(
+  const double value,
+  const char* const expected)
+{
+  struct json_array_t* array = json_array_create();
+  json_array_append_decimal(array, value);
+  char* array_string = json_array_to_string(array);
+  json_array_free(&array);
+
+  bool matches = array_string
+    && strlen(array_string) == strlen(expected) + 2
+    && strncmp(&array_string[1], expected, strlen(expected)) == 0;
+  if (!matches)
+    fprintf(stderr, "Expected %s but got %s.\n", expected, array_string ? array_string : "(null)");
+
+  free(array_string);
+  return matches;
+}
+
+static bool
+check_int32(
+  const int32_t value,
+  const char* const expected)
+{
+  struct json_array_t* array = json_array_create();
+  json_array_append_int32(array, value);
+  char* array_string = json_array_to_string(array);
+  json_array_free(&array);
+
+  bool matches = array_string
+    && strlen(array_string) == strlen(expected) + 2
+    && strncmp(&array_string[1], expected, strlen(expected)) == 0;
+  if (!matches)
+    fprintf(stderr, "Expected %s but got %s.\n", expected, array_string ? array_string : "(null)");
+
+  free(array_string);
+  return matches;
+}
+
+// cheap deterministic bit patterns covering the whole double range
+static uint64_t
+next_random(
+  uint64_t* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+int main()
+{
+  if (!check_int32(0, "0")
+      || !check_int32(7, "7")
+      || !check_int32(-42, "-42")
+      || !check_int32(1000000, "1000000")
+      || !check_int32(INT32_MAX, "2147483647")
+      || !check_int32(INT32_MIN, "-2147483648"))
+    return -1;
+
+  // shortest form, always kept as a decimal
+  if (!check_decimal(0.0, "0.0")
+      || !check_decimal(-0.0, "-0.0")
+      || !check_decimal(1.0, "1.0")
+      || !check_decimal(-2.5, "-2.5")
+      || !check_decimal(0.1, "0.1")
+      || !check_decimal(3.14159, "3.14159")
+      || !check_decimal(123456.789, "123456.789")
+      || !check_decimal(0.001234, "0.001234")
+      || !check_decimal(1e-9, "1e-9")
+      || !check_decimal(1.5e300, "1.5e300")
+      || !check_decimal(1e21, "1e21")
+      || !check_decimal(1e20, "100000000000000000000.0")
+      || !check_decimal(5e-324, "5e-324")
+      || !check_decimal(DBL_MAX, "1.7976931348623157e308")
+      || !check_decimal(NAN, "null")
+      || !check_decimal(INFINITY, "null"))
+    return -1;
+
+  // everything written must parse back to exactly the same double
+  struct json_array_t* array = json_array_create();
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  size_t n_values = 0;
+  while (n_values < 100000)
+  {
+    uint64_t bits = next_random(&state);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (isnan(value) || isinf(value))
+      continue;
+    json_array_append_decimal(array, value);
+    n_values++;
+  }
+
+  char* array_string = json_array_to_string(array);
+  struct json_array_t* array_read = array_string ? json_parse_array_from_string(array_string) : NULL;
+  free(array_string);
+  if (!array_read || array_read->n_items != array->n_items)
+  {
+    fprintf(stderr, "Failed to read back written decimals.\n");
+    json_array_free(&array);
+    json_array_free(&array_read);
+    return -1;
+  }
+
+  for (size_t i = 0; i < array->n_items; ++i)
+  {
+    double* expected = json_array_get_decimal(array, i);
+    double* actual = json_array_get_decimal(array_read, i);
+    if (!actual || memcmp(expected, actual, sizeof(double)) != 0)
+    {
+      fprintf(stderr, "Decimal at index %zu did not round trip (%.17g).\n", i, *expected);
+      json_array_free(&array);
+      json_array_free(&array_read);
+      return -1;
+    }
+  }
+
+  json_array_free(&array);
+  json_array_free(&array_read);
+  return 0;
+}
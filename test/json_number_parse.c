@@ -0,0 +1,169 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <math.h>
+#include <locale.h>
+
+// parses "[number]" and checks the result matches strtod (which is
+// correctly rounded) bit for bit
+static bool
+check_decimal(
+  const char* const number)
+{
+  size_t len = strlen(number);
+  char* array_string = malloc(len + 3);
+  array_string[0] = '[';
+  memcpy(&array_string[1], number, len);
+  array_string[len + 1] = ']';
+  array_string[len + 2] = '\0';
+
+  struct json_array_t* array = json_parse_array_from_string(array_string);
+  free(array_string);
+
+  double expected = strtod(number, NULL);
+  double* actual = array ? json_array_get_decimal(array, 0) : NULL;
+  bool matches = actual && memcmp(actual, &expected, sizeof(double)) == 0;
+  if (!matches)
+    fprintf(stderr, "Expected %s to parse as %.17g but got %.17g.\n", number, expected, actual ? *actual : NAN);
+
+  json_array_free(&array);
+  return matches;
+}
+
+static bool
+check_int32(
+  const char* const number,
+  const int32_t expected)
+{
+  struct json_t* json = NULL;
+  char json_string[64];
+  snprintf(json_string, sizeof(json_string), "{\"key\":%s}", number);
+  json = json_parse_from_string(json_string);
+
+  int32_t* actual = json ? json_get_int32(json, "key") : NULL;
+  bool matches = actual && *actual == expected;
+  if (!matches)
+    fprintf(stderr, "Expected %s to parse as int32 %d.\n", number, expected);
+
+  json_free(&json);
+  return matches;
+}
+
+static uint64_t
+next_random(
+  uint64_t* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+int main()
+{
+  if (!check_int32("0", 0)
+      || !check_int32("-0", 0)
+      || !check_int32("42", 42)
+      || !check_int32("-17", -17)
+      || !check_int32("2147483647", INT32_MAX)
+      || !check_int32("-2147483648", INT32_MIN))
+    return -1;
+
+  // integers that don't fit in an int32 are kept as decimals
+  struct json_t* json = json_parse_from_string("{\"big\":2147483648,\"bigger\":-12345678901234567890}");
+  if (!json
+      || !json_get_decimal(json, "big")
+      || *json_get_decimal(json, "big") != 2147483648.0
+      || !json_get_decimal(json, "bigger")
+      || *json_get_decimal(json, "bigger") != -12345678901234567890.0)
+  {
+    fprintf(stderr, "Expected out of range integers to be parsed as decimals.\n");
+    json_free(&json);
+    return -1;
+  }
+  json_free(&json);
+
+  const char* const hard_cases[] = {
+    "0.0", "-0.0", "0.1", "1.5", "3.14159", "1e-9", "1E+10", "123.456e-7",
+    ".5", "5.", "0.000000000000000000000000000001",
+    // ties between two doubles, must round to even
+    "9007199254740993.0", "9007199254740995.0", "1.00000000000000011102230246251565404236316680908203125",
+    "1.00000000000000011102230246251565404236316680908203124",
+    "1.00000000000000011102230246251565404236316680908203126",
+    // around the smallest normal and subnormal
+    "2.2250738585072011e-308", "2.2250738585072012e-308", "2.2250738585072014e-308",
+    "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+    "1e-320", "1e-400", "-1e-400",
+    // around the largest double and past it
+    "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308",
+    "1e309", "-1e309", "1e99999999999",
+    // more digits than the fast paths can hold
+    "123456789012345678901234567890", "0.12345678901234567890123456789",
+    "7.2057594037927933e16", "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791.0"
+  };
+  for (size_t i = 0; i < sizeof(hard_cases) / sizeof(hard_cases[0]); ++i)
+    if (!check_decimal(hard_cases[i]))
+      return -1;
+
+  // a long run of digits that only differs from a halfway point far past
+  // the 19 digits the fast path keeps
+  char long_number[1200];
+  strcpy(long_number, "1.00000000000000011102230246251565404236316680908203125");
+  size_t long_len = strlen(long_number);
+  memset(&long_number[long_len], '0', 1000);
+  long_number[long_len + 1000] = '\0';
+  if (!check_decimal(long_number))
+    return -1;
+  long_number[long_len + 999] = '1';
+  if (!check_decimal(long_number))
+    return -1;
+
+  // random bit patterns written at different precisions
+  uint64_t state = 0x2545F4914F6CDD1DULL;
+  char number[64];
+  for (size_t i = 0; i < 200000; ++i)
+  {
+    uint64_t bits = next_random(&state);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (isnan(value) || isinf(value))
+      continue;
+
+    int precision = (int)(next_random(&state) % 20) + 1;
+    snprintf(number, sizeof(number), "%.*e", precision, value);
+    if (!check_decimal(number))
+      return -1;
+  }
+
+  // random digit strings too long for a uint64
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    size_t n_digits = 20 + next_random(&state) % 30;
+    size_t idx = 0;
+    for (size_t d = 0; d < n_digits; ++d)
+    {
+      number[idx++] = '0' + next_random(&state) % 10;
+      if (d == 0)
+        number[idx++] = '.';
+    }
+    idx += sprintf(&number[idx], "e%d", (int)(next_random(&state) % 640) - 330);
+    if (!check_decimal(number))
+      return -1;
+  }
+
+  // the decimal point is always '.', whatever the C locale says
+  if (setlocale(LC_NUMERIC, "de_DE.UTF-8") || setlocale(LC_NUMERIC, "fr_FR.UTF-8"))
+  {
+    struct json_array_t* array = json_parse_array_from_string("[3.5]");
+    setlocale(LC_NUMERIC, "C");
+    if (!array || *json_array_get_decimal(array, 0) != 3.5)
+    {
+      fprintf(stderr, "Decimal parsing depends on the locale.\n");
+      json_array_free(&array);
+      return -1;
+    }
+    json_array_free(&array);
+  }
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include "json.h"
+#include "json_array.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define DEPTH 100000
+
+// parsing, writing and freeing all run on a thread with a small stack,
+// which recursing once per level would overflow
+#define STACK_SIZE (512 * 1024)
+
+static void*
+run(
+  void* result)
+{
+  int status = -1;
+
+  // build { "a": { "a": { ... { "a": 1 } ... } } } nested DEPTH levels deep
+  char* json_string = calloc(DEPTH * 6 + 2, sizeof(char));
+  char* array_string = calloc(DEPTH * 2 + 2, sizeof(char));
+  struct json_t* json = NULL;
+  struct json_array_t* array = NULL;
+  if (!json_string || !array_string)
+  {
+    fprintf(stderr, "Failed to allocate test strings.\n");
+    goto cleanup;
+  }
+
+  size_t len = 0;
+  for (size_t i = 0; i < DEPTH; ++i)
+  {
+    memcpy(&json_string[len], "{\"a\":", 5);
+    len += 5;
+  }
+  json_string[len++] = '1';
+  for (size_t i = 0; i < DEPTH; ++i)
+    json_string[len++] = '}';
+
+  json = json_parse_from_string(json_string);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse deeply nested object.\n");
+    goto cleanup;
+  }
+
+  struct json_t* current = json;
+  for (size_t i = 0; i < DEPTH - 1; ++i)
+  {
+    current = json_get_object(current, "a");
+    if (!current)
+    {
+      fprintf(stderr, "Missing nested object at depth %zu.\n", i + 1);
+      goto cleanup;
+    }
+  }
+
+  int32_t value = *json_get_int32(current, "a");
+  if (value != 1)
+  {
+    fprintf(stderr, "Expected innermost value to be 1 but got %d.\n", value);
+    goto cleanup;
+  }
+
+  char* written = json_to_string(json);
+  bool matches = written && strcmp(written, json_string) == 0;
+  free(written);
+  if (!matches)
+  {
+    fprintf(stderr, "Deeply nested object didn't write back the same.\n");
+    goto cleanup;
+  }
+
+  // [[[ ... ]]] nested DEPTH levels deep
+  for (size_t i = 0; i < DEPTH; ++i)
+  {
+    array_string[i] = '[';
+    array_string[DEPTH + i] = ']';
+  }
+
+  array = json_parse_array_from_string(array_string);
+  if (!array)
+  {
+    fprintf(stderr, "Failed to parse deeply nested array.\n");
+    goto cleanup;
+  }
+
+  written = json_array_to_string(array);
+  matches = written && strcmp(written, array_string) == 0;
+  free(written);
+  if (!matches)
+  {
+    fprintf(stderr, "Deeply nested array didn't write back the same.\n");
+    goto cleanup;
+  }
+
+  // mismatched closing tokens must still be rejected
+  char* mismatched[4] = {
+    "{ \"key\": [1, 2} ]",
+    "{ \"key\": { \"a\": 1 ] }",
+    "{ \"key\": [[1, 2] }",
+    "{ \"key\": 1 }}"
+  };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    struct json_t* bad = json_parse_from_string(mismatched[i]);
+    if (bad)
+    {
+      fprintf(stderr, "Expected '%s' to fail parsing but succeeded.\n", mismatched[i]);
+      json_free(&bad);
+      goto cleanup;
+    }
+  }
+
+  status = 0;
+cleanup:
+  free(json_string);
+  free(array_string);
+  json_free(&json);
+  if (array)
+    json_array_free(&array);
+  *(int*)result = status;
+  return NULL;
+}
+
+int main()
+{
+  int status = -1;
+
+  pthread_attr_t attr;
+  pthread_t thread;
+  if (pthread_attr_init(&attr) != 0
+      || pthread_attr_setstacksize(&attr, STACK_SIZE) != 0
+      || pthread_create(&thread, &attr, run, &status) != 0)
+  {
+    fprintf(stderr, "Failed to start test thread.\n");
+    return -1;
+  }
+
+  pthread_join(thread, NULL);
+  pthread_attr_destroy(&attr);
+  return status;
+}
@@ -0,0 +1,104 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+// copies a string into an exactly sized heap buffer without a null
+// terminator so any read past the end is caught by sanitizers
+static char*
+make_buffer(
+  const char* const string,
+  size_t* len)
+{
+  *len = strlen(string);
+  char* buffer = malloc(*len);
+  if (buffer)
+    memcpy(buffer, string, *len);
+  return buffer;
+}
+
+int main()
+{
+  int status = -1;
+
+  size_t len = 0;
+  char* buffer = make_buffer("{ \"key\": 10, \"key2\": \"hey\", \"key3\": [1, 2.5, true] }", &len);
+  char* array_buffer = NULL;
+  struct json_t* json = NULL;
+  struct json_t* bad_json = NULL;
+  struct json_array_t* array = NULL;
+  struct json_array_t* bad_array = NULL;
+  if (!buffer)
+  {
+    fprintf(stderr, "Failed to allocate buffer.\n");
+    goto cleanup;
+  }
+
+  json = json_parse_from_buffer(buffer, len);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse JSON from buffer.\n");
+    goto cleanup;
+  }
+
+  int32_t value = *json_get_int32(json, "key");
+  if (value != 10)
+  {
+    fprintf(stderr, "Expected key to be 10 but got %d.\n", value);
+    goto cleanup;
+  }
+
+  char* value2 = json_get_string(json, "key2");
+  if (strcmp(value2, "hey") != 0)
+  {
+    fprintf(stderr, "Expected key2 to be 'hey' but got '%s'.\n", value2);
+    goto cleanup;
+  }
+
+  // the length is respected even if there's more valid looking input after it
+  bad_json = json_parse_from_buffer(buffer, len - 1);
+  if (bad_json)
+  {
+    fprintf(stderr, "Expected truncated buffer to fail parsing but succeeded.\n");
+    goto cleanup;
+  }
+
+  // a number right at the end of the buffer
+  array_buffer = make_buffer("[1,2,12345]", &len);
+  if (!array_buffer)
+  {
+    fprintf(stderr, "Failed to allocate array buffer.\n");
+    goto cleanup;
+  }
+
+  array = json_parse_array_from_buffer(array_buffer, len);
+  if (!array || array->n_items != 3)
+  {
+    fprintf(stderr, "Failed to parse array from buffer.\n");
+    goto cleanup;
+  }
+
+  if (*json_array_get_int32(array, 2) != 12345)
+  {
+    fprintf(stderr, "Expected last item to be 12345 but got %d.\n", *json_array_get_int32(array, 2));
+    goto cleanup;
+  }
+
+  bad_array = json_parse_array_from_buffer(array_buffer, len - 3);
+  if (bad_array)
+  {
+    fprintf(stderr, "Expected truncated array buffer to fail parsing but succeeded.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  free(buffer);
+  free(array_buffer);
+  json_free(&json);
+  json_free(&bad_json);
+  if (array)
+    json_array_free(&array);
+  if (bad_array)
+    json_array_free(&bad_array);
+  return status;
+}
@@ -0,0 +1,67 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+
+// pipes can't be mapped, so this goes through the buffered read fallback
+int main()
+{
+  int status = -1;
+
+  char* json_string = "{ \"key\": 10, \"key2\": [1, 2, 3] }";
+  size_t len = strlen(json_string);
+
+  int fds[2];
+  if (pipe(fds) == -1)
+  {
+    fprintf(stderr, "Failed to create pipe.\n");
+    return -1;
+  }
+
+  if (write(fds[1], json_string, len) != (ssize_t)len)
+  {
+    fprintf(stderr, "Failed to write to pipe.\n");
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+  close(fds[1]);
+
+  char filepath[64] = {0};
+  snprintf(filepath, 64, "/dev/fd/%d", fds[0]);
+
+  struct json_t* json = json_parse_from_file(filepath);
+  close(fds[0]);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse JSON from pipe.\n");
+    return -1;
+  }
+
+  int32_t value = *json_get_int32(json, "key");
+  if (value != 10)
+  {
+    fprintf(stderr, "Expected key to be 10 but got %d.\n", value);
+    goto cleanup;
+  }
+
+  struct json_array_t* array = json_get_array(json, "key2");
+  if (!array || array->n_items != 3)
+  {
+    fprintf(stderr, "Expected key2 to have 3 items.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  json_free(&json);
+  return status;
+}
+#else
+int main()
+{
+  return 0;
+}
+#endif
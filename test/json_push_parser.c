@@ -0,0 +1,211 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_parser.h"
+#include <stdio.h>
+
+static char*
+read_file(
+  const char* const filepath,
+  size_t* len)
+{
+  FILE* file = fopen(filepath, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  *len = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  char* contents = malloc(*len);
+  if (contents && fread(contents, 1, *len, file) != *len)
+  {
+    free(contents);
+    contents = NULL;
+  }
+  fclose(file);
+  return contents;
+}
+
+// feeds input in chunks of chunk_size and returns the parsed array
+static struct json_array_t*
+parse_array_in_chunks(
+  const char* const input,
+  const size_t len,
+  const size_t chunk_size)
+{
+  struct json_parser_t* parser = json_parser_new();
+  struct json_array_t* array = NULL;
+  if (!parser)
+    return NULL;
+
+  for (size_t i = 0; i < len; i += chunk_size)
+  {
+    size_t n = len - i < chunk_size ? len - i : chunk_size;
+    if (!json_parser_feed(parser, &input[i], n))
+      goto cleanup;
+  }
+
+  if (json_parser_finish(parser))
+    array = json_parser_take_array(parser);
+
+cleanup:
+  json_parser_free(&parser);
+  return array;
+}
+
+// true if feeding input one byte at a time fails (in feed or finish)
+static bool
+fails_bytewise(
+  const char* const input)
+{
+  struct json_parser_t* parser = json_parser_new();
+  bool failed = false;
+  for (size_t i = 0; input[i] != '\0' && !failed; ++i)
+    failed = !json_parser_feed(parser, &input[i], 1);
+  if (!failed)
+    failed = !json_parser_finish(parser);
+  json_parser_free(&parser);
+  return failed;
+}
+
+int main()
+{
+  int status = -1;
+
+  size_t len = 0;
+  char* input = read_file("complex_file.json", &len);
+  struct json_array_t* expected = json_parse_array_from_file("complex_file.json");
+  char* expected_string = NULL;
+  struct json_array_t* array = NULL;
+  char* array_string = NULL;
+  struct json_parser_t* parser = NULL;
+  struct json_t* json = NULL;
+
+  if (!input || !expected || !(expected_string = json_array_to_string(expected)))
+  {
+    fprintf(stderr, "Failed to read complex_file.json.\n");
+    goto cleanup;
+  }
+
+  // chunk boundaries land inside strings, escapes, numbers and literals
+  const size_t chunk_sizes[] = { 1, 2, 7, 64, 4096, len };
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++i)
+  {
+    array = parse_array_in_chunks(input, len, chunk_sizes[i]);
+    if (!array)
+    {
+      fprintf(stderr, "Failed to parse complex_file.json in chunks of %zu.\n", chunk_sizes[i]);
+      goto cleanup;
+    }
+
+    array_string = json_array_to_string(array);
+    if (!array_string || strcmp(array_string, expected_string) != 0)
+    {
+      fprintf(stderr, "Parsing in chunks of %zu gave a different array.\n", chunk_sizes[i]);
+      goto cleanup;
+    }
+
+    free(array_string);
+    array_string = NULL;
+    json_array_free(&array);
+  }
+
+  // an object root, with a key split across chunks and a number ending
+  // the input
+  parser = json_parser_new();
+  const char* chunks[] = { " {\"lo", "ng_k\\\"ey\": [tr", "ue, -1.", "5e1], \"n\":", " 4", "2}  " };
+  for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i)
+  {
+    if (!json_parser_feed(parser, chunks[i], strlen(chunks[i])))
+    {
+      fprintf(stderr, "Failed to feed chunk %zu.\n", i);
+      goto cleanup;
+    }
+  }
+
+  if (json_parser_take_object(parser))
+  {
+    fprintf(stderr, "Expected no document before finishing.\n");
+    goto cleanup;
+  }
+
+  if (!json_parser_finish(parser) || json_parser_take_array(parser))
+  {
+    fprintf(stderr, "Failed to finish object.\n");
+    goto cleanup;
+  }
+
+  json = json_parser_take_object(parser);
+  struct json_array_t* values = json ? json_get_array(json, "long_k\\\"ey") : NULL;
+  if (!values
+      || values->n_items != 2
+      || !*json_array_get_bool(values, 0)
+      || *json_array_get_decimal(values, 1) != -15.0
+      || *json_get_int32(json, "n") != 42)
+  {
+    fprintf(stderr, "Incorrect object from push parser.\n");
+    goto cleanup;
+  }
+  json_parser_free(&parser);
+
+  // a number at the very end only completes on finish
+  parser = json_parser_new();
+  if (!json_parser_feed(parser, "[1, 23", 6)
+      || !json_parser_feed(parser, "]", 1)
+      || !json_parser_finish(parser))
+  {
+    fprintf(stderr, "Failed to parse number split across chunks.\n");
+    goto cleanup;
+  }
+  array = json_parser_take_array(parser);
+  if (!array || array->n_items != 2 || *json_array_get_int32(array, 1) != 23)
+  {
+    fprintf(stderr, "Incorrect array from push parser.\n");
+    goto cleanup;
+  }
+  json_array_free(&array);
+  json_parser_free(&parser);
+
+  // errors are reported by feed as soon as they're seen
+  parser = json_parser_new();
+  if (json_parser_feed(parser, "{\"a\" 1", 6) || json_parser_feed(parser, "}", 1) || json_parser_finish(parser))
+  {
+    fprintf(stderr, "Expected missing colon to fail on feed.\n");
+    goto cleanup;
+  }
+  json_parser_free(&parser);
+
+  const char* invalid[] = {
+    "",
+    "   ",
+    "{\"a\": \"unterminated",
+    "{\"a\": 1",
+    "{\"a\": 1} {}",
+    "[1, 2] x",
+    "[tru]",
+    "[1,]",
+    "5",
+    "[1.2.3]"
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+  {
+    if (!fails_bytewise(invalid[i]))
+    {
+      fprintf(stderr, "Expected '%s' to fail.\n", invalid[i]);
+      goto cleanup;
+    }
+  }
+
+  status = 0;
+cleanup:
+  free(input);
+  free(expected_string);
+  free(array_string);
+  if (expected)
+    json_array_free(&expected);
+  if (array)
+    json_array_free(&array);
+  json_free(&json);
+  json_parser_free(&parser);
+  return status;
+}
@@ -0,0 +1,219 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_sax.h"
+#include <stdio.h>
+
+// writes every event into log as a short token, e.g. {k:a i:1 }
+struct event_log
+{
+  char log[1024];
+  size_t len;
+  // stop the parse after this many events, 0 to never stop
+  size_t stop_after;
+  size_t n_events;
+  size_t depth;
+  size_t max_depth;
+};
+
+static bool
+log_event(
+  struct event_log* const events,
+  const char* const event,
+  const char* const text,
+  const size_t text_len)
+{
+  int written = snprintf(&events->log[events->len], sizeof(events->log) - events->len, "%s%.*s ", event, (int)text_len, text);
+  if (written > 0 && events->len + written < sizeof(events->log))
+    events->len += written;
+  events->n_events++;
+  return events->stop_after == 0 || events->n_events < events->stop_after;
+}
+
+static bool
+on_start_object(void* user_data)
+{
+  struct event_log* events = user_data;
+  if (++events->depth > events->max_depth)
+    events->max_depth = events->depth;
+  return log_event(events, "{", "", 0);
+}
+
+static bool
+on_end_object(void* user_data)
+{
+  struct event_log* events = user_data;
+  events->depth--;
+  return log_event(events, "}", "", 0);
+}
+
+static bool
+on_start_array(void* user_data)
+{
+  struct event_log* events = user_data;
+  if (++events->depth > events->max_depth)
+    events->max_depth = events->depth;
+  return log_event(events, "[", "", 0);
+}
+
+static bool
+on_end_array(void* user_data)
+{
+  struct event_log* events = user_data;
+  events->depth--;
+  return log_event(events, "]", "", 0);
+}
+
+static bool
+on_key(void* user_data, const char* key, size_t len)
+{
+  return log_event(user_data, "k:", key, len);
+}
+
+static bool
+on_int32(void* user_data, int32_t value)
+{
+  char text[32];
+  snprintf(text, sizeof(text), "%d", value);
+  return log_event(user_data, "i:", text, strlen(text));
+}
+
+static bool
+on_decimal(void* user_data, double value)
+{
+  char text[32];
+  snprintf(text, sizeof(text), "%g", value);
+  return log_event(user_data, "d:", text, strlen(text));
+}
+
+static bool
+on_string(void* user_data, const char* str, size_t len)
+{
+  return log_event(user_data, "s:", str, len);
+}
+
+static bool
+on_boolean(void* user_data, bool value)
+{
+  return log_event(user_data, "b:", value ? "1" : "0", 1);
+}
+
+static bool
+on_null(void* user_data)
+{
+  return log_event(user_data, "n", "", 0);
+}
+
+static const struct json_sax_handler_t handler = {
+  .start_object = on_start_object,
+  .end_object = on_end_object,
+  .start_array = on_start_array,
+  .end_array = on_end_array,
+  .key = on_key,
+  .int32 = on_int32,
+  .decimal = on_decimal,
+  .string = on_string,
+  .boolean = on_boolean,
+  .null = on_null
+};
+
+int main()
+{
+  int status = -1;
+  char* deep = NULL;
+  struct event_log events = {0};
+
+  const char* input = " {\"a\": 1, \"b\": [2.5, \"x\\\"y\", true, false, null, {}], \"c\": {\"d\": -3e2}} ";
+  const char* expected = "{ k:a i:1 k:b [ d:2.5 s:x\\\"y b:1 b:0 n { } ] k:c { k:d d:-300 } } ";
+  if (!json_sax_parse_from_string(input, JSON_PARSE_DEFAULT, &handler, &events)
+      || strcmp(events.log, expected) != 0)
+  {
+    fprintf(stderr, "Expected events '%s' but got '%s'.\n", expected, events.log);
+    goto cleanup;
+  }
+
+  // only the events asked for are sent
+  memset(&events, 0, sizeof(events));
+  struct json_sax_handler_t keys_only = { .key = on_key };
+  if (!json_sax_parse_from_string(input, JSON_PARSE_DEFAULT, &keys_only, &events)
+      || strcmp(events.log, "k:a k:b k:c k:d ") != 0)
+  {
+    fprintf(stderr, "Expected only keys but got '%s'.\n", events.log);
+    goto cleanup;
+  }
+
+  // a callback returning false stops the parse
+  memset(&events, 0, sizeof(events));
+  events.stop_after = 3;
+  if (json_sax_parse_from_string(input, JSON_PARSE_DEFAULT, &handler, &events)
+      || events.n_events != 3)
+  {
+    fprintf(stderr, "Expected the parse to stop after 3 events but got %zu.\n", events.n_events);
+    goto cleanup;
+  }
+
+  // nesting deeper than the inline stack
+  const size_t depth = 1000;
+  deep = malloc(depth * 2 + 1);
+  if (!deep)
+    goto cleanup;
+  for (size_t i = 0; i < depth; ++i)
+  {
+    deep[i] = '[';
+    deep[depth * 2 - 1 - i] = ']';
+  }
+  deep[depth * 2] = '\0';
+
+  memset(&events, 0, sizeof(events));
+  if (!json_sax_parse_from_string(deep, JSON_PARSE_DEFAULT, &handler, &events)
+      || events.max_depth != depth
+      || events.depth != 0)
+  {
+    fprintf(stderr, "Failed to parse deeply nested arrays.\n");
+    goto cleanup;
+  }
+
+  // a whole file, with every kind of value
+  memset(&events, 0, sizeof(events));
+  if (!json_sax_parse_from_file("complex_file.json", JSON_PARSE_DEFAULT, &handler, &events)
+      || events.depth != 0
+      || events.max_depth == 0)
+  {
+    fprintf(stderr, "Failed to parse complex_file.json.\n");
+    goto cleanup;
+  }
+
+  const char* invalid[] = {
+    "",
+    "5",
+    "{\"a\": 1",
+    "{\"a\" 1}",
+    "{\"a\": 1,}",
+    "[1, 2]]",
+    "[1, 2} ",
+    "{\"a\": 1} x",
+    "[tru]",
+    "[1.2.3]",
+    "{1: 2}"
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+  {
+    memset(&events, 0, sizeof(events));
+    if (json_sax_parse_from_string(invalid[i], JSON_PARSE_DEFAULT, &handler, &events))
+    {
+      fprintf(stderr, "Expected '%s' to fail.\n", invalid[i]);
+      goto cleanup;
+    }
+  }
+
+  memset(&events, 0, sizeof(events));
+  if (json_sax_parse_from_string("[\"\xC3\x28\"]", JSON_PARSE_VALIDATE_UTF8, &handler, &events))
+  {
+    fprintf(stderr, "Expected invalid UTF-8 to fail.\n");
+    goto cleanup;
+  }
+
+  status = 0;
+cleanup:
+  free(deep);
+  return status;
+}
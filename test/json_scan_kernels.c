@@ -0,0 +1,73 @@
+#include "json.h"
+#include <stdio.h>
+
+// whitespace runs and strings of every length around the 16/32-byte
+// widths the scanning kernels work in, with escapes at every position
+int main()
+{
+  char document[512];
+  char content[256];
+
+  for (size_t n_spaces = 0; n_spaces < 80; ++n_spaces)
+  {
+    const char whitespace[] = " \t\n\r";
+    size_t idx = 0;
+    document[idx++] = '{';
+    for (size_t i = 0; i < n_spaces; ++i)
+      document[idx++] = whitespace[i % 4];
+    idx += sprintf(&document[idx], "\"key\"");
+    for (size_t i = 0; i < n_spaces; ++i)
+      document[idx++] = whitespace[(i + 1) % 4];
+    idx += sprintf(&document[idx], ":1}");
+
+    struct json_t* json = json_parse_from_string(document);
+    int32_t* value = json ? json_get_int32(json, "key") : NULL;
+    if (!value || *value != 1)
+    {
+      fprintf(stderr, "Failed to parse with %zu whitespace characters.\n", n_spaces);
+      json_free(&json);
+      return -1;
+    }
+    json_free(&json);
+  }
+
+  for (size_t content_len = 2; content_len < 80; ++content_len)
+  {
+    for (size_t escape_idx = 0; escape_idx + 1 < content_len; ++escape_idx)
+    {
+      // an escaped quote somewhere in the middle must not end the string
+      memset(content, 'a', content_len);
+      content[escape_idx] = '\\';
+      content[escape_idx + 1] = '\"';
+      content[content_len] = '\0';
+
+      snprintf(document, sizeof(document), "{\"key\":\"%s\"}", content);
+      struct json_t* json = json_parse_from_string(document);
+      char* value = json ? json_get_string(json, "key") : NULL;
+      if (!value || strcmp(value, content) != 0)
+      {
+        fprintf(stderr, "Failed to parse string %s.\n", content);
+        json_free(&json);
+        return -1;
+      }
+      json_free(&json);
+    }
+  }
+
+  // unterminated strings still fail, even when they end in an escape
+  if (json_parse_from_string("{\"key\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")
+      || json_parse_from_string("{\"key\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\\\"}"))
+  {
+    fprintf(stderr, "Expected unterminated strings to fail.\n");
+    return -1;
+  }
+
+  // only space, tab, newline and carriage return are whitespace in JSON
+  if (json_parse_from_string("{\v\"key\":1}") || json_parse_from_string("{\"key\":1\f}"))
+  {
+    fprintf(stderr, "Expected \\v and \\f to be rejected as whitespace.\n");
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_internal.h"
+#include <stdio.h>
+
+// byte-at-a-time version of what the stage-1 index should contain
+static size_t
+reference_positions(
+  const char* const input,
+  const size_t len,
+  size_t* positions)
+{
+  size_t n_positions = 0;
+  bool in_string = false;
+  bool in_scalar = false;
+  // a backslash escapes the next byte whether or not it's in a string.
+  // outside of one it's invalid anyway, all that matters is that it's indexed
+  bool escape_pending = false;
+
+  for (size_t i = 0; i < len; ++i)
+  {
+    char c = input[i];
+    bool escaped = escape_pending;
+    escape_pending = c == '\\' && !escaped;
+
+    if (in_string)
+    {
+      if (c == '\"' && !escaped)
+        in_string = false;
+      continue;
+    }
+
+    if (c == '\"' && !escaped)
+    {
+      if (!in_scalar)
+        positions[n_positions++] = i;
+      in_string = true;
+      in_scalar = false;
+    }
+    else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':')
+    {
+      positions[n_positions++] = i;
+      in_scalar = false;
+    }
+    else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+      in_scalar = false;
+    else
+    {
+      if (!in_scalar)
+        positions[n_positions++] = i;
+      in_scalar = true;
+    }
+  }
+
+  return n_positions;
+}
+
+static bool
+check_index(
+  const char* const input,
+  const size_t len,
+  const enum _json_simd_level_e level)
+{
+  size_t* expected = malloc((len + 1) * sizeof(size_t));
+  size_t n_expected = reference_positions(input, len, expected);
+
+  struct _json_structural_index_t index;
+  if (!_json_structural_index_init(&index, input, len, level))
+  {
+    free(expected);
+    return false;
+  }
+
+  bool matches = true;
+  size_t position = 0;
+  for (size_t i = 0; i < n_expected && matches; ++i)
+  {
+    if (!_json_structural_index_next(&index, &position) || position != expected[i])
+    {
+      fprintf(stderr, "Level %d: position %zu should be %zu but was %zu.\n", (int)level, i, expected[i], position);
+      matches = false;
+    }
+  }
+
+  if (matches && _json_structural_index_next(&index, &position))
+  {
+    fprintf(stderr, "Level %d: unexpected extra position %zu.\n", (int)level, position);
+    matches = false;
+  }
+
+  _json_structural_index_free(&index);
+  free(expected);
+  return matches;
+}
+
+static uint64_t
+next_random(
+  uint64_t* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+// pads a document with leading spaces so it's long enough to be indexed
+static char*
+pad_document(
+  const char* const document)
+{
+  size_t len = strlen(document);
+  char* padded = malloc(JSON_STRUCTURAL_INDEX_MIN_LEN + len + 1);
+  memset(padded, ' ', JSON_STRUCTURAL_INDEX_MIN_LEN);
+  memcpy(&padded[JSON_STRUCTURAL_INDEX_MIN_LEN], document, len + 1);
+  return padded;
+}
+
+static bool
+check_parse(
+  const char* const document,
+  const bool should_parse)
+{
+  char* padded = pad_document(document);
+  struct json_array_t* array = json_parse_array_from_string(padded);
+  free(padded);
+
+  bool parsed = array != NULL;
+  if (array)
+    json_array_free(&array);
+  if (parsed != should_parse)
+    fprintf(stderr, "Expected %s to %s.\n", document, should_parse ? "parse" : "fail");
+  return parsed == should_parse;
+}
+
+int main()
+{
+  // random mixes of the characters that matter, so escapes, quotes and
+  // scalars straddle block and window boundaries
+  const char alphabet[] = "{}[],:\"\\ \n\tab1-.";
+  enum _json_simd_level_e best = _json_simd_detect();
+  uint64_t state = 0x853C49E6748FEA9BULL;
+
+  for (size_t round = 0; round < 200; ++round)
+  {
+    size_t len = next_random(&state) % (JSON_STRUCTURAL_WINDOW * 2 + 200);
+    char* input = malloc(len + 1);
+    for (size_t i = 0; i < len; ++i)
+      input[i] = alphabet[next_random(&state) % (sizeof(alphabet) - 1)];
+    input[len] = '\0';
+
+    for (int level = JSON_SIMD_SCALAR; level <= (int)best; ++level)
+      if (!check_index(input, len, (enum _json_simd_level_e)level))
+      {
+        free(input);
+        return -1;
+      }
+    free(input);
+  }
+
+  // documents long enough to go through the index
+  if (!check_parse("[1, 2.5, \"a\\\"b\", {\"k\": [true, false, null]}, \"\\\\\"]", true)
+      || !check_parse("[12x]", false)
+      || !check_parse("[12\"a\"]", false)
+      || !check_parse("[\"a\"12]", false)
+      || !check_parse("[truex]", false)
+      || !check_parse("[1 2]", false)
+      || !check_parse("[1] x", false)
+      || !check_parse("[1]   ", true))
+    return -1;
+
+  // a large document parsed with and without the index gives the same result
+  struct json_array_t* array = json_parse_array_from_file("complex_file.json");
+  if (!array)
+  {
+    fprintf(stderr, "Failed to parse complex_file.json.\n");
+    return -1;
+  }
+  char* array_string = json_array_to_string(array);
+  json_array_free(&array);
+
+  char* padded = pad_document(array_string);
+  array = json_parse_array_from_string(padded);
+  char* reparsed_string = array ? json_array_to_string(array) : NULL;
+  bool matches = reparsed_string && strcmp(array_string, reparsed_string) == 0;
+  if (!matches)
+    fprintf(stderr, "Indexed parse of complex_file.json doesn't match.\n");
+
+  free(padded);
+  free(array_string);
+  free(reparsed_string);
+  if (array)
+    json_array_free(&array);
+  return matches ? 0 : -1;
+}
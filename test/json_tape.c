@@ -0,0 +1,264 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_tape.h"
+#include <stdio.h>
+
+// every value in the tape has to match the tree parsed from the same input
+static bool
+matches_array(
+  const struct json_tape_t* const tape,
+  const size_t tape_array,
+  const struct json_array_t* const array);
+
+static bool
+matches_object(
+  const struct json_tape_t* const tape,
+  const size_t tape_object,
+  const struct json_t* const json)
+{
+  if (json_tape_len(tape, tape_object) != json->n_items)
+    return false;
+
+  for (size_t i = 0; i < json->n_items; ++i)
+  {
+    const struct json_item_t* item = &json->items[i];
+    const char* const key = item->key;
+    switch (item->type)
+    {
+      case JSON_INT32:
+      {
+        const int32_t* value = json_tape_get_int32(tape, tape_object, key);
+        if (!value || *value != item->value.int32)
+          return false;
+        break;
+      }
+      case JSON_DECIMAL:
+      {
+        const double* value = json_tape_get_decimal(tape, tape_object, key);
+        if (!value || *value != item->value.decimal)
+          return false;
+        break;
+      }
+      case JSON_STRING:
+      {
+        const char* value = json_tape_get_string(tape, tape_object, key);
+        if (!value || strcmp(value, item->value.str) != 0)
+          return false;
+        break;
+      }
+      case JSON_BOOL:
+      {
+        const bool* value = json_tape_get_bool(tape, tape_object, key);
+        if (!value || *value != item->value.boolean)
+          return false;
+        break;
+      }
+      case JSON_NULL:
+        if (!json_tape_get_isnull(tape, tape_object, key))
+          return false;
+        break;
+      case JSON_OBJECT:
+      {
+        size_t value = json_tape_get_object(tape, tape_object, key);
+        if (value == JSON_TAPE_NPOS || !matches_object(tape, value, item->value.object))
+          return false;
+        break;
+      }
+      case JSON_ARRAY:
+      {
+        size_t value = json_tape_get_array(tape, tape_object, key);
+        if (value == JSON_TAPE_NPOS || !matches_array(tape, value, item->value.array))
+          return false;
+        break;
+      }
+      case JSON_NOTYPE:
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool
+matches_array(
+  const struct json_tape_t* const tape,
+  const size_t tape_array,
+  const struct json_array_t* const array)
+{
+  if (json_tape_len(tape, tape_array) != array->n_items)
+    return false;
+
+  // walks the tape items alongside the tree ones
+  size_t item = json_tape_first(tape, tape_array);
+  for (size_t i = 0; i < array->n_items; ++i, item = json_tape_next(tape, item))
+  {
+    // arrays of only int32s, decimals or bools are packed,
+    // so go through the getters rather than items
+    switch (json_array_get_type(array, i))
+    {
+      case JSON_INT32:
+      {
+        const int32_t* value = json_tape_as_int32(tape, item);
+        if (!value || *value != *json_array_get_int32(array, i))
+          return false;
+        break;
+      }
+      case JSON_DECIMAL:
+      {
+        const double* value = json_tape_as_decimal(tape, item);
+        if (!value || *value != *json_array_get_decimal(array, i))
+          return false;
+        break;
+      }
+      case JSON_STRING:
+      {
+        const char* value = json_tape_as_string(tape, item);
+        if (!value || strcmp(value, json_array_get_string(array, i)) != 0)
+          return false;
+        break;
+      }
+      case JSON_BOOL:
+      {
+        const bool* value = json_tape_as_bool(tape, item);
+        if (!value || *value != *json_array_get_bool(array, i))
+          return false;
+        break;
+      }
+      case JSON_NULL:
+        if (!json_tape_is_null(tape, item))
+          return false;
+        break;
+      case JSON_OBJECT:
+      {
+        if (json_tape_type(tape, item) != JSON_OBJECT || !matches_object(tape, item, json_array_get_object(array, i)))
+          return false;
+        break;
+      }
+      case JSON_ARRAY:
+      {
+        if (json_tape_type(tape, item) != JSON_ARRAY || !matches_array(tape, item, json_array_get_array(array, i)))
+          return false;
+        break;
+      }
+      case JSON_NOTYPE:
+        return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  const char* const input =
+    "{\"id\": 42, \"price\": 9.5, \"name\": \"widget\", \"tags\": [\"a\", {\"b\": [1, 2]}, [], 3],"
+    " \"active\": true, \"deleted\": false, \"owner\": null, \"empty\": {}}";
+
+  struct json_tape_t* tape = json_tape_parse_from_string(input, JSON_PARSE_DEFAULT);
+  if (!tape)
+  {
+    fprintf(stderr, "Failed to parse tape.\n");
+    return -1;
+  }
+
+  const int32_t* id = json_tape_get_int32(tape, 0, "id");
+  const double* price = json_tape_get_decimal(tape, 0, "price");
+  const char* name = json_tape_get_string(tape, 0, "name");
+  const bool* active = json_tape_get_bool(tape, 0, "active");
+  const bool* deleted = json_tape_get_bool(tape, 0, "deleted");
+  if (json_tape_type(tape, 0) != JSON_OBJECT || json_tape_len(tape, 0) != 8
+      || !id || *id != 42 || !price || *price != 9.5
+      || !name || strcmp(name, "widget") != 0
+      || !active || !*active || !deleted || *deleted
+      || !json_tape_get_isnull(tape, 0, "owner")
+      || json_tape_get_isnull(tape, 0, "id")
+      || json_tape_get_int32(tape, 0, "price")
+      || json_tape_get_int32(tape, 0, "missing"))
+  {
+    fprintf(stderr, "Failed to read tape values.\n");
+    return -1;
+  }
+
+  size_t tags = json_tape_get_array(tape, 0, "tags");
+  size_t inner = tags == JSON_TAPE_NPOS ? JSON_TAPE_NPOS : json_tape_array_get_object(tape, tags, 1);
+  size_t b = inner == JSON_TAPE_NPOS ? JSON_TAPE_NPOS : json_tape_get_array(tape, inner, "b");
+  const int32_t* last = tags == JSON_TAPE_NPOS ? NULL : json_tape_array_get_int32(tape, tags, 3);
+  const int32_t* b1 = b == JSON_TAPE_NPOS ? NULL : json_tape_array_get_int32(tape, b, 1);
+  if (json_tape_len(tape, tags) != 4 || !last || *last != 3 || !b1 || *b1 != 2
+      || json_tape_array_get_int32(tape, tags, 4)
+      || json_tape_array_get_object(tape, tags, 0) != JSON_TAPE_NPOS
+      || json_tape_len(tape, json_tape_array_get_array(tape, tags, 2)) != 0
+      || json_tape_len(tape, json_tape_get_object(tape, 0, "empty")) != 0
+      || json_tape_get_object(tape, 0, "tags") != JSON_TAPE_NPOS)
+  {
+    fprintf(stderr, "Failed to read nested tape values.\n");
+    return -1;
+  }
+
+  // visiting every item in order
+  const char* const keys[] = { "id", "price", "name", "tags", "active", "deleted", "owner", "empty" };
+  const enum json_type_e types[] = {
+    JSON_INT32, JSON_DECIMAL, JSON_STRING, JSON_ARRAY, JSON_BOOL, JSON_BOOL, JSON_NULL, JSON_OBJECT
+  };
+  size_t n_items = 0;
+  for (size_t i = json_tape_first(tape, 0); i != JSON_TAPE_NPOS; i = json_tape_next(tape, i))
+  {
+    const char* key = json_tape_key(tape, i);
+    if (n_items >= 8 || !key || strcmp(key, keys[n_items]) != 0 || json_tape_type(tape, i) != types[n_items])
+    {
+      fprintf(stderr, "Unexpected item %zu when iterating tape object.\n", n_items);
+      return -1;
+    }
+    n_items++;
+  }
+
+  size_t tag = json_tape_first(tape, tags);
+  const char* tag0 = json_tape_as_string(tape, tag);
+  tag = json_tape_next(tape, tag);
+  const int32_t* tag1_b1 = json_tape_array_get_int32(tape, json_tape_get_array(tape, tag, "b"), 1);
+  tag = json_tape_next(tape, tag);
+  const size_t tag2 = tag;
+  tag = json_tape_next(tape, tag);
+  const int32_t* tag3 = json_tape_as_int32(tape, tag);
+  if (n_items != 8
+      || !tag0 || strcmp(tag0, "a") != 0 || json_tape_key(tape, json_tape_first(tape, tags))
+      || !tag1_b1 || *tag1_b1 != 2
+      || json_tape_type(tape, tag2) != JSON_ARRAY || json_tape_first(tape, tag2) != JSON_TAPE_NPOS
+      || !tag3 || *tag3 != 3 || json_tape_as_decimal(tape, tag) || json_tape_is_null(tape, tag)
+      || json_tape_next(tape, tag) != JSON_TAPE_NPOS
+      || json_tape_first(tape, json_tape_get_object(tape, 0, "empty")) != JSON_TAPE_NPOS
+      || json_tape_first(tape, tag) != JSON_TAPE_NPOS
+      || json_tape_next(tape, JSON_TAPE_NPOS) != JSON_TAPE_NPOS)
+  {
+    fprintf(stderr, "Failed to iterate tape array.\n");
+    return -1;
+  }
+  json_tape_free(&tape);
+
+  // same failures as the tree parser
+  const char* const invalid[] = {
+    "", "{", "[1, 2", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "{\"a\": tru}",
+    "[1] [2]", "{\"a\": [1}", "{\"a\": \"unterminated}", "1", "[1.2.3]", "[1]x",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+  {
+    tape = json_tape_parse_from_string(invalid[i], JSON_PARSE_DEFAULT);
+    if (tape)
+    {
+      fprintf(stderr, "Parsed invalid document %s.\n", invalid[i]);
+      return -1;
+    }
+  }
+
+  // large enough to go through the structural index, checked value by
+  // value against the tree
+  tape = json_tape_parse_from_file("complex_file.json", JSON_PARSE_DEFAULT);
+  struct json_array_t* expected = json_parse_array_from_file("complex_file.json");
+  if (!tape || !expected || json_tape_type(tape, 0) != JSON_ARRAY || !matches_array(tape, 0, expected))
+  {
+    fprintf(stderr, "complex_file.json tape doesn't match the tree.\n");
+    return -1;
+  }
+  json_array_free(&expected);
+  json_tape_free(&tape);
+
+  return 0;
+}
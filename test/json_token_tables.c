@@ -0,0 +1,102 @@
+#include "json.h"
+#include "json_internal.h"
+#include <stdio.h>
+
+// the classifier the token tables replaced
+static enum _token_e
+reference_token_type(
+  const unsigned char c)
+{
+  switch (c)
+  {
+    case '{': return OPEN_BODY;
+    case '}': return CLOSE_BODY;
+    case '\"': return QUOTE;
+    case ',': return COMMA;
+    case ':': return COLON;
+    case '[': return OPEN_ARRAY;
+    case ']': return CLOSE_ARRAY;
+    case ' ': case '\t': case '\n': case '\r': return SPACE;
+  }
+
+  if (c >= 0x80)
+    return UNKNOWN;
+  if (isdigit(c) || c == '.' || c == '-')
+    return NUMERIC;
+  if (isalpha(c) || ispunct(c))
+    return TEXT;
+  return UNKNOWN;
+}
+
+// and the successor function
+static uint16_t
+reference_next_tokens(
+  const enum _token_e token,
+  const enum json_type_e container_type,
+  const bool parsing_key)
+{
+  const uint16_t value_tokens = QUOTE | NUMERIC | TEXT | OPEN_BODY | OPEN_ARRAY;
+  switch (token)
+  {
+    case OPEN_BODY:
+      return QUOTE | CLOSE_BODY;
+    case OPEN_ARRAY:
+      return value_tokens | CLOSE_ARRAY;
+    case COLON:
+      return value_tokens;
+    case COMMA:
+      return container_type == JSON_OBJECT ? QUOTE : value_tokens;
+    case QUOTE:
+      if (parsing_key)
+        return COLON;
+      // fall through
+    case NUMERIC:
+    case TEXT:
+    case CLOSE_BODY:
+    case CLOSE_ARRAY:
+      if (container_type == JSON_OBJECT)
+        return COMMA | CLOSE_BODY;
+      if (container_type == JSON_ARRAY)
+        return COMMA | CLOSE_ARRAY;
+      return NONE;
+    default:
+      return NONE;
+  }
+}
+
+int main()
+{
+  for (int c = 0; c < 256; ++c)
+  {
+    uint16_t token = _json_token_class_masks[_json_token_classes[c]];
+    if (token != reference_token_type((unsigned char)c))
+    {
+      fprintf(stderr, "byte 0x%02x classified as 0x%x.\n", c, token);
+      return -1;
+    }
+  }
+
+  const enum json_type_e container_types[] = { JSON_NOTYPE, JSON_OBJECT, JSON_ARRAY };
+  for (int token_class = 0; token_class < JSON_N_TOKEN_CLASSES; ++token_class)
+  {
+    for (size_t i = 0; i < sizeof(container_types) / sizeof(container_types[0]); ++i)
+    {
+      for (int parsing_key = 0; parsing_key < 2; ++parsing_key)
+      {
+        enum json_type_e container_type = container_types[i];
+        uint16_t expected = reference_next_tokens(
+          (enum _token_e)_json_token_class_masks[token_class],
+          container_type,
+          parsing_key);
+        if (_json_token_transitions[token_class][container_type][parsing_key] != expected)
+        {
+          fprintf(stderr, "wrong transition for class %d, container %d, key %d.\n",
+              token_class, (int)container_type, parsing_key);
+          return -1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,225 @@
+#include "json.h"
+#include "json_array.h"
+#include "json_internal.h"
+#include <stdio.h>
+
+// decodes one code point at a time and checks it's in range and
+// encoded in the fewest bytes
+static bool
+reference_valid(
+  const unsigned char* const input,
+  const size_t len)
+{
+  size_t i = 0;
+  while (i < len)
+  {
+    unsigned char c = input[i];
+    size_t n_bytes;
+    uint32_t code_point;
+    if (c < 0x80) { n_bytes = 1; code_point = c; }
+    else if ((c & 0xE0) == 0xC0) { n_bytes = 2; code_point = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { n_bytes = 3; code_point = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { n_bytes = 4; code_point = c & 0x07; }
+    else return false;
+
+    if (i + n_bytes > len)
+      return false;
+    for (size_t j = 1; j < n_bytes; ++j)
+    {
+      if ((input[i + j] & 0xC0) != 0x80)
+        return false;
+      code_point = (code_point << 6) | (input[i + j] & 0x3F);
+    }
+
+    const uint32_t min_code_point[] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (code_point < min_code_point[n_bytes]
+        || code_point > 0x10FFFF
+        || (code_point >= 0xD800 && code_point <= 0xDFFF))
+      return false;
+    i += n_bytes;
+  }
+  return true;
+}
+
+static uint32_t rng_state = 12345;
+
+static uint32_t
+next_random()
+{
+  rng_state = rng_state * 1103515245 + 12345;
+  return rng_state >> 8;
+}
+
+// mostly valid text (ASCII runs and encoded code points) with the
+// occasional random byte, so both outcomes are common
+static size_t
+random_text(
+  unsigned char* const output,
+  const size_t max_len)
+{
+  size_t len = 0;
+  while (len + 4 <= max_len)
+  {
+    uint32_t choice = next_random() % 16;
+    if (choice < 6)
+    {
+      size_t run = next_random() % 40;
+      for (size_t i = 0; i < run && len < max_len; ++i)
+        output[len++] = 'a' + next_random() % 26;
+    }
+    else if (choice < 15)
+    {
+      uint32_t code_point = next_random() % 0x110000;
+      if (code_point < 0x80)
+        output[len++] = code_point;
+      else if (code_point < 0x800)
+      {
+        output[len++] = 0xC0 | (code_point >> 6);
+        output[len++] = 0x80 | (code_point & 0x3F);
+      }
+      else if (code_point < 0x10000)
+      {
+        output[len++] = 0xE0 | (code_point >> 12);
+        output[len++] = 0x80 | ((code_point >> 6) & 0x3F);
+        output[len++] = 0x80 | (code_point & 0x3F);
+      }
+      else
+      {
+        output[len++] = 0xF0 | (code_point >> 18);
+        output[len++] = 0x80 | ((code_point >> 12) & 0x3F);
+        output[len++] = 0x80 | ((code_point >> 6) & 0x3F);
+        output[len++] = 0x80 | (code_point & 0x3F);
+      }
+    }
+    else
+      output[len++] = next_random() & 0xFF;
+  }
+  return len;
+}
+
+static bool
+check(
+  const char* const input,
+  const size_t len,
+  const bool expected)
+{
+  if (_json_validate_utf8(input, len) != expected)
+  {
+    fprintf(stderr, "expected %s for %zu bytes:", expected ? "valid" : "invalid", len);
+    for (size_t i = 0; i < len && i < 64; ++i)
+      fprintf(stderr, " %02x", (unsigned char)input[i]);
+    fprintf(stderr, "\n");
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // hand-picked edge cases, each also checked after enough ASCII padding
+  // to put it in (and across the end of) a vector
+  const struct { const char* bytes; bool valid; } cases[] = {
+    { "", true },
+    { "plain ascii", true },
+    { "\xC3\xA9", true },                 // U+00E9
+    { "\xE2\x82\xAC", true },             // U+20AC
+    { "\xF0\x9F\x98\x80", true },         // U+1F600
+    { "\xEF\xBF\xBF", true },             // U+FFFF
+    { "\xF4\x8F\xBF\xBF", true },         // U+10FFFF
+    { "\xED\x9F\xBF", true },             // U+D7FF
+    { "\xEE\x80\x80", true },             // U+E000
+    { "\x80", false },                    // lone continuation
+    { "\xC3", false },                    // truncated
+    { "\xE2\x82", false },
+    { "\xF0\x9F\x98", false },
+    { "\xC0\xAF", false },                // overlong '/'
+    { "\xC1\xBF", false },
+    { "\xE0\x9F\xBF", false },            // overlong 3 byte
+    { "\xF0\x8F\xBF\xBF", false },        // overlong 4 byte
+    { "\xED\xA0\x80", false },            // surrogate
+    { "\xED\xBF\xBF", false },
+    { "\xF4\x90\x80\x80", false },        // past U+10FFFF
+    { "\xF5\x80\x80\x80", false },
+    { "\xFF", false },
+    { "\xC3\xA9\xA9", false },            // extra continuation
+    { "\xE2\x82\xAC\x80", false },
+    { "\xE2\x28\xA1", false },            // ASCII inside a sequence
+  };
+
+  char buffer[256];
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+  {
+    const size_t len = strlen(cases[i].bytes);
+    for (size_t padding = 0; padding < 70; ++padding)
+    {
+      memset(buffer, 'x', padding);
+      memcpy(&buffer[padding], cases[i].bytes, len);
+      if (!check(buffer, padding + len, cases[i].valid))
+        return -1;
+      // and with ASCII after it
+      memset(&buffer[padding + len], 'y', 40);
+      if (!check(buffer, padding + len + 40, cases[i].valid))
+        return -1;
+    }
+  }
+
+  // random text at lengths that exercise every kernel's main loop and tail
+  unsigned char text[1024];
+  size_t n_valid = 0;
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    const size_t len = random_text(text, 4 + next_random() % (sizeof(text) - 4));
+    const bool expected = reference_valid(text, len);
+    n_valid += expected;
+    if (!check((const char*)text, len, expected))
+      return -1;
+  }
+  if (n_valid == 0 || n_valid == 20000)
+  {
+    fprintf(stderr, "random text was all %s.\n", n_valid == 0 ? "invalid" : "valid");
+    return -1;
+  }
+
+  // parsing only checks when asked to
+  const char* const invalid_value = "{\"key\": \"caf\xC3\"}";
+  const char* const invalid_key = "{\"caf\xE9\": 1}";
+  const char* const valid = "{\"caf\xC3\xA9\": \"\xF0\x9F\x98\x80 and a long enough string to be vectorized\"}";
+
+  struct json_t* json = json_parse_from_string(invalid_value);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse invalid UTF-8 without validation.\n");
+    return -1;
+  }
+  json_free(&json);
+
+  const struct json_parse_options_t options = {
+    .flags = JSON_PARSE_VALIDATE_UTF8,
+    .arena = NULL,
+    .key_pool = NULL
+  };
+  if (json_parse_with_options(invalid_value, strlen(invalid_value), &options)
+      || json_parse_with_options(invalid_key, strlen(invalid_key), &options))
+  {
+    fprintf(stderr, "Parsed invalid UTF-8 with validation.\n");
+    return -1;
+  }
+
+  json = json_parse_with_options(valid, strlen(valid), &options);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse valid UTF-8 with validation.\n");
+    return -1;
+  }
+  json_free(&json);
+
+  const char* const surrogate = "[\"ok\", \"\xED\xA0\x80\"]";
+  struct json_array_t* array = json_parse_array_with_options(surrogate, strlen(surrogate), &options);
+  if (array)
+  {
+    fprintf(stderr, "Parsed an array with a surrogate with validation.\n");
+    return -1;
+  }
+
+  return 0;
+}
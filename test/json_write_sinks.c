@@ -0,0 +1,96 @@
+#include "json.h"
+#include "json_array.h"
+#include <stdio.h>
+#include <unistd.h>
+
+int main()
+{
+  // json_write should produce exactly what json_to_string does, whichever sink it goes to
+  char* json_string = "{\"key\":1,\"key2\":3.14159,\"key3\":true,\"key4\":null,\"key5\":{\"a\":1,\"b\":2},\"key6\":\"hello there\",\"key7\":[1,true,null,\"hey\",[1,2,3,{\"a\":1,\"b\":2,\"c\":{\"a\":3,\"b\":4}}]]}";
+  size_t json_string_len = strlen(json_string);
+  struct json_t* json = json_parse_from_string(json_string);
+  if (!json)
+  {
+    fprintf(stderr, "Failed to parse JSON.\n");
+    return -1;
+  }
+
+  // buffer sink
+  char buffer[512];
+  struct json_buffer_sink_t buffer_sink = { .buffer = buffer, .capacity = sizeof(buffer), .len = 0 };
+  if (!json_write(json, json_buffer_sink, &buffer_sink)
+      || buffer_sink.len != json_string_len
+      || strcmp(buffer, json_string) != 0)
+  {
+    fprintf(stderr, "Buffer sink output does not match original.\n");
+    json_free(&json);
+    return -1;
+  }
+
+  // buffer too small must fail rather than overflow
+  char small_buffer[16];
+  struct json_buffer_sink_t small_sink = { .buffer = small_buffer, .capacity = sizeof(small_buffer), .len = 0 };
+  if (json_write(json, json_buffer_sink, &small_sink))
+  {
+    fprintf(stderr, "Expected write into small buffer to fail.\n");
+    json_free(&json);
+    return -1;
+  }
+
+  // FILE* sink
+  FILE* tmp = tmpfile();
+  if (!tmp || !json_write(json, json_file_sink, tmp))
+  {
+    fprintf(stderr, "Failed to write to FILE* sink.\n");
+    json_free(&json);
+    return -1;
+  }
+  rewind(tmp);
+  memset(buffer, 0, sizeof(buffer));
+  size_t n_read = fread(buffer, sizeof(char), sizeof(buffer) - 1, tmp);
+  fclose(tmp);
+  if (n_read != json_string_len || strcmp(buffer, json_string) != 0)
+  {
+    fprintf(stderr, "FILE* sink output does not match original.\n");
+    json_free(&json);
+    return -1;
+  }
+
+  // fd sink through a pipe
+  int fds[2];
+  if (pipe(fds) != 0 || !json_write(json, json_fd_sink, &fds[1]))
+  {
+    fprintf(stderr, "Failed to write to fd sink.\n");
+    json_free(&json);
+    return -1;
+  }
+  close(fds[1]);
+  memset(buffer, 0, sizeof(buffer));
+  n_read = 0;
+  ssize_t result;
+  while ((result = read(fds[0], &buffer[n_read], sizeof(buffer) - 1 - n_read)) > 0)
+    n_read += result;
+  close(fds[0]);
+  if (n_read != json_string_len || strcmp(buffer, json_string) != 0)
+  {
+    fprintf(stderr, "fd sink output does not match original.\n");
+    json_free(&json);
+    return -1;
+  }
+
+  // arrays
+  struct json_array_t* array = json_get_array(json, "key7");
+  char* array_string = "[1,true,null,\"hey\",[1,2,3,{\"a\":1,\"b\":2,\"c\":{\"a\":3,\"b\":4}}]]";
+  buffer_sink.len = 0;
+  if (!array
+      || !json_array_write(array, json_buffer_sink, &buffer_sink)
+      || strcmp(buffer, array_string) != 0)
+  {
+    fprintf(stderr, "Array output does not match original.\n");
+    json_free(&json);
+    return -1;
+  }
+
+  json_free(&json);
+  return 0;
+}